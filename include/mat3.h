@@ -0,0 +1,87 @@
+/*------------------------------------------------------------------------------
+* mat3.h : fixed-size 3x3/4x4 matrix kernels for ins mechanization
+*
+* notes  : all matrices are column-major as navlib matmul(). kernels are fully
+*          unrolled and evaluate into locals before storing, so the output may
+*          alias any of the inputs. no BLAS call is made regardless of LAPACK.
+*-----------------------------------------------------------------------------*/
+#ifndef MAT3_H
+#define MAT3_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* C=A*B (3x3) ---------------------------------------------------------------*/
+static inline void mat3mul_nn(const double *A, const double *B, double *C)
+{
+    double c0=A[0]*B[0]+A[3]*B[1]+A[6]*B[2],c1=A[1]*B[0]+A[4]*B[1]+A[7]*B[2];
+    double c2=A[2]*B[0]+A[5]*B[1]+A[8]*B[2],c3=A[0]*B[3]+A[3]*B[4]+A[6]*B[5];
+    double c4=A[1]*B[3]+A[4]*B[4]+A[7]*B[5],c5=A[2]*B[3]+A[5]*B[4]+A[8]*B[5];
+    double c6=A[0]*B[6]+A[3]*B[7]+A[6]*B[8],c7=A[1]*B[6]+A[4]*B[7]+A[7]*B[8];
+    double c8=A[2]*B[6]+A[5]*B[7]+A[8]*B[8];
+    C[0]=c0; C[1]=c1; C[2]=c2; C[3]=c3; C[4]=c4; C[5]=c5; C[6]=c6; C[7]=c7; C[8]=c8;
+}
+/* C=A'*B (3x3) --------------------------------------------------------------*/
+static inline void mat3mul_tn(const double *A, const double *B, double *C)
+{
+    double c0=A[0]*B[0]+A[1]*B[1]+A[2]*B[2],c1=A[3]*B[0]+A[4]*B[1]+A[5]*B[2];
+    double c2=A[6]*B[0]+A[7]*B[1]+A[8]*B[2],c3=A[0]*B[3]+A[1]*B[4]+A[2]*B[5];
+    double c4=A[3]*B[3]+A[4]*B[4]+A[5]*B[5],c5=A[6]*B[3]+A[7]*B[4]+A[8]*B[5];
+    double c6=A[0]*B[6]+A[1]*B[7]+A[2]*B[8],c7=A[3]*B[6]+A[4]*B[7]+A[5]*B[8];
+    double c8=A[6]*B[6]+A[7]*B[7]+A[8]*B[8];
+    C[0]=c0; C[1]=c1; C[2]=c2; C[3]=c3; C[4]=c4; C[5]=c5; C[6]=c6; C[7]=c7; C[8]=c8;
+}
+/* C=A*B' (3x3) --------------------------------------------------------------*/
+static inline void mat3mul_nt(const double *A, const double *B, double *C)
+{
+    double c0=A[0]*B[0]+A[3]*B[3]+A[6]*B[6],c1=A[1]*B[0]+A[4]*B[3]+A[7]*B[6];
+    double c2=A[2]*B[0]+A[5]*B[3]+A[8]*B[6],c3=A[0]*B[1]+A[3]*B[4]+A[6]*B[7];
+    double c4=A[1]*B[1]+A[4]*B[4]+A[7]*B[7],c5=A[2]*B[1]+A[5]*B[4]+A[8]*B[7];
+    double c6=A[0]*B[2]+A[3]*B[5]+A[6]*B[8],c7=A[1]*B[2]+A[4]*B[5]+A[7]*B[8];
+    double c8=A[2]*B[2]+A[5]*B[5]+A[8]*B[8];
+    C[0]=c0; C[1]=c1; C[2]=c2; C[3]=c3; C[4]=c4; C[5]=c5; C[6]=c6; C[7]=c7; C[8]=c8;
+}
+/* C=A'*B' (3x3) -------------------------------------------------------------*/
+static inline void mat3mul_tt(const double *A, const double *B, double *C)
+{
+    double c0=A[0]*B[0]+A[1]*B[3]+A[2]*B[6],c1=A[3]*B[0]+A[4]*B[3]+A[5]*B[6];
+    double c2=A[6]*B[0]+A[7]*B[3]+A[8]*B[6],c3=A[0]*B[1]+A[1]*B[4]+A[2]*B[7];
+    double c4=A[3]*B[1]+A[4]*B[4]+A[5]*B[7],c5=A[6]*B[1]+A[7]*B[4]+A[8]*B[7];
+    double c6=A[0]*B[2]+A[1]*B[5]+A[2]*B[8],c7=A[3]*B[2]+A[4]*B[5]+A[5]*B[8];
+    double c8=A[6]*B[2]+A[7]*B[5]+A[8]*B[8];
+    C[0]=c0; C[1]=c1; C[2]=c2; C[3]=c3; C[4]=c4; C[5]=c5; C[6]=c6; C[7]=c7; C[8]=c8;
+}
+/* c=A*b (3x3,3x1) -----------------------------------------------------------*/
+static inline void mat3mulv_n(const double *A, const double *b, double *c)
+{
+    double c0=A[0]*b[0]+A[3]*b[1]+A[6]*b[2];
+    double c1=A[1]*b[0]+A[4]*b[1]+A[7]*b[2];
+    double c2=A[2]*b[0]+A[5]*b[1]+A[8]*b[2];
+    c[0]=c0; c[1]=c1; c[2]=c2;
+}
+/* c=A'*b (3x3,3x1) ----------------------------------------------------------*/
+static inline void mat3mulv_t(const double *A, const double *b, double *c)
+{
+    double c0=A[0]*b[0]+A[1]*b[1]+A[2]*b[2];
+    double c1=A[3]*b[0]+A[4]*b[1]+A[5]*b[2];
+    double c2=A[6]*b[0]+A[7]*b[1]+A[8]*b[2];
+    c[0]=c0; c[1]=c1; c[2]=c2;
+}
+/* C=A*B (4x4) ---------------------------------------------------------------*/
+static inline void mat4mul_nn(const double *A, const double *B, double *C)
+{
+    double T[16];
+    int j;
+    for (j=0;j<4;j++) {
+        T[4*j  ]=A[0]*B[4*j]+A[4]*B[4*j+1]+A[ 8]*B[4*j+2]+A[12]*B[4*j+3];
+        T[4*j+1]=A[1]*B[4*j]+A[5]*B[4*j+1]+A[ 9]*B[4*j+2]+A[13]*B[4*j+3];
+        T[4*j+2]=A[2]*B[4*j]+A[6]*B[4*j+1]+A[10]*B[4*j+2]+A[14]*B[4*j+3];
+        T[4*j+3]=A[3]*B[4*j]+A[7]*B[4*j+1]+A[11]*B[4*j+2]+A[15]*B[4*j+3];
+    }
+    for (j=0;j<16;j++) C[j]=T[j];
+}
+#ifdef __cplusplus
+}
+#endif
+#endif /* MAT3_H */
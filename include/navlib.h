@@ -295,6 +295,7 @@ extern "C"{
 #define MAXIMUBUF   1000                /* max number of imu measurement data buffer */
 #define MAXIMGBUF   2000                /* max number of image data buffer */
 #define MAXPOSEBUF  1000                /* max number of pose measurement buffer */
+#define MAXEVTQ     4096                /* max number of events in time-ordered event queue */
 #define MAXPOSE     50                  /* max number of input pose measurement data */
 #define MAXIMG      50                  /* max number of input image data */
 #define MAXNRPOS    16                  /* max number of reference positions */
@@ -655,6 +656,7 @@ extern "C"{
 #define IMUDETST_ALL       5            /* runs all static detector */
 
 #define NPOS               3            /* # of precious epochs gps antenna position */
+#define MAXSOLS            5            /* max number of solutions for reboot lc */
 #define BASE_Q_EMPTY       0
 #define BASE_Q_NO_EMPTY    1
 
@@ -704,6 +706,8 @@ extern "C"{
 #define initlock(f) InitializeCriticalSection(f)
 #define lock(f)     EnterCriticalSection(f)
 #define unlock(f)   LeaveCriticalSection(f)
+#define cond_t      CONDITION_VARIABLE
+#define initcond(c) InitializeConditionVariable(c)
 #define FILEPATHSEP '\\'
 #else
 #define thread_t    pthread_t
@@ -711,6 +715,8 @@ extern "C"{
 #define initlock(f) pthread_mutex_init(f,NULL)
 #define lock(f)     pthread_mutex_lock(f)
 #define unlock(f)   pthread_mutex_unlock(f)
+#define cond_t      pthread_cond_t
+#define initcond(c) pthread_cond_init(c,NULL)
 #define FILEPATHSEP '/'
 #endif
 
@@ -895,6 +901,16 @@ typedef struct {               /* camera states type */
     double phi[3],P[9];        /* covariance of camera pose expressed in tangent space */
 } vostate_t;
 
+typedef struct {            /* kalman filter workspace type */
+    int nmax,mmax;          /* max number of states/measurements of workspace */
+    int *ix,*ipiv;          /* index of effective states/pivot index of inversion */
+    double *x,*xp;          /* effective states before/after update */
+    double *P,*Pp;          /* effective covariance before/after update */
+    double *H;              /* effective transpose of design matrix */
+    double *F,*Q,*K;        /* work matrices of measurement update */
+    double *work;           /* work vector of matrix inversion/sequential update */
+} filtws_t;
+
 typedef struct {            /* ins states type */
     gtime_t time,ptime;     /* ins states time and precious time of ins states*/
     gtime_t plct,ptct;      /* precious time of ins-gnss loosely/tightly coupled (0: no coupled)*/
@@ -942,12 +958,16 @@ typedef struct {            /* ins states type */
 
     double pins[9],pCbe[9]; /* ins states (position/velocity/acceleration/attitude) of precious epoch in ecef-frame */
     gmeas_t gmeas;          /* gps position/velocity measurements */
+    gmea_t sols[MAXSOLS];   /* gps measurements to reboot ins-gnss loosely coupled */
+    int nzvu,nzaru;         /* number of epochs since zero velocity/angular rate update */
+    double odt,odr;         /* accumulated time interval (s)/distance (m) of odometry */
 
     double age,ratio;       /* age of differential of ins and gnss (s)/ambiguity fix ratio */
     int stat,gstat,pose;    /* ins updates stat,gnss updates status and pose fusion status */
     int ns;                 /* numbers valid satellite for loosely coupled */
     void *rtkp;             /* pointer rtk struct data */
     vostate_t vo;           /* vosidual odometry states */
+    filtws_t ws;            /* kalman filter workspace */
 } insstate_t;
 
 typedef struct {            /* PSD for ins-gnss loosely coupled ekf states */
@@ -1503,6 +1523,18 @@ typedef struct {        /* ppp corrections type */
     trop_t *trop[MAXSTA]; /* trop data */
 } pppcorr_t;
 
+typedef struct {        /* ephemeris index entry type */
+    gtime_t toe;        /* reference time of ephemeris */
+    int sat;            /* satellite number */
+    int i;              /* index of ephemeris in navigation data */
+} ephkey_t;
+
+typedef struct {        /* ephemeris index type */
+    int n,nmax;         /* number of ephemerides indexed/allocated */
+    ephkey_t *key;      /* index entries sorted by satellite, toe and index */
+    int off[MAXSAT+1];  /* first index entry of satellite (sat-1) */
+} ephidx_t;
+
 typedef struct {        /* navigation data type */
     int n,nmax;         /* number of broadcast ephemeris */
     int ng,ngmax;       /* number of glonass ephemeris */
@@ -1520,6 +1552,9 @@ typedef struct {        /* navigation data type */
     alm_t *alm;         /* almanac data */
     tec_t *tec;         /* tec grid data */
     fcbd_t *fcb;        /* satellite fcb data */
+    ephidx_t ieph;      /* GPS/QZS/GAL ephemeris index */
+    ephidx_t igeph;     /* GLONASS ephemeris index */
+    ephidx_t iseph;     /* SBAS ephemeris index */
     erp_t  erp;         /* earth rotation parameters */
     double utc_gps[4];  /* GPS delta-UTC parameters {A0,A1,T,W} */
     double utc_glo[4];  /* GLONASS UTC GPS time parameters */
@@ -1696,6 +1731,27 @@ typedef struct {        /* rinex control struct type */
     char   opt[256];    /* rinex dependent options */
 } rnxctr_t;
 
+typedef struct {        /* rinex obs stream type */
+    char   **path;      /* expanded file paths */
+    int    np,ip;       /* number of file paths, current path index */
+    FILE   *fp;         /* current file pointer (NULL: closed) */
+    char   tmpfile[1024]; /* uncompressed temporary file ("": none) */
+    int    rcv;         /* receiver number */
+    gtime_t ts,te;      /* observation time start/end (time==0: no limit) */
+    double tint;        /* observation time interval (s) (0:all) */
+    double ver;         /* rinex version */
+    int    tsys;        /* time system */
+    char   tobs[7][MAXOBSTYPE][4]; /* rinex obs types */
+    unsigned char slips[MAXSAT][NFREQ]; /* cycle-slip flags */
+    sigind_t sind[7];   /* signal index */
+    gtime_t time;       /* time of last epoch input */
+    obsd_t *data;       /* observation data of last epoch input */
+    int    n;           /* number of observation data of last epoch input */
+    nav_t  *nav;        /* navigation data for header parameters */
+    sta_t  *sta;        /* station parameters (NULL: no input) */
+    char   opt[256];    /* rinex options */
+} rnxstr_t;
+
 typedef struct {        /* option type */
     const char *name;   /* option name */
     int format;         /* option format (0:int,1:double,2:string,3:enum) */
@@ -1792,6 +1848,9 @@ typedef struct {        /* processing options type */
     insopt_t insopt;      /* ins option */
     gtime_t ext[16][2];   /* exclude gnss measurement data (included gsof+observation data) for processing */
     sigind_t sind[2][7];  /* observation signal information,0: rover,1: base */
+    int rnxcache;         /* cache of parsed input files (0:off,1:on) */
+    double streamwin;     /* input data window of streaming forward processing (s) (0:read all) */
+    double orbint;        /* interpolation interval of broadcast orbit (s) (0:off) */
 } prcopt_t;
 
 typedef struct {        /* solution options type */
@@ -1932,6 +1991,15 @@ typedef struct {        /* double-difference ambiguity type */
     double bias;        /* ambiguity value */
 } ddamb_t;
 
+typedef struct {        /* lambda workspace type */
+    int n,nmax;         /* number of float parameters and allocated */
+    int nwork;          /* size of work area */
+    double *a;          /* float parameters (n x 1) */
+    double *L,*D;       /* LD factorization of covariance (Q=L'*diag(D)*L) */
+    double *work;       /* work area of reduction and search */
+    double *w;          /* work area of lambda_drop() (n x 1) */
+} lambda_t;
+
 typedef struct {        /* double-difference satellite */
     int sat1,sat2;      /* double difference satellite no. */
     int f;              /* frequency no. */
@@ -1966,6 +2034,8 @@ typedef struct {        /* RTK control/result type */
     amb_t bias;                  /* double-difference ambiguity list */
     amb_t wlbias;                /* WL double-difference ambiguity list */
     ddsat_t sat[MAXSAT];         /* double difference satellite list */
+    filtws_t ws;                 /* kalman filter workspace */
+    lambda_t lam;                /* lambda workspace */
 } rtk_t;
 
 typedef struct half_cyc_tag {  /* half-cycle correction list type */
@@ -2107,6 +2177,21 @@ typedef struct {        /* receiver raw data control type */
     int imufmt;         /* imu data type */
 } raw_t;
 
+typedef struct {        /* imu measurement data stream type */
+    FILE   *fp;         /* imu measurement data file pointer (NULL: closed) */
+    raw_t  *raw;        /* raw data control of binary data (NULL: text log) */
+    int    week;        /* gps week of text log */
+    imud_t data;        /* imu measurement data of last input */
+} imustr_t;
+
+typedef struct {        /* gsof message stream type */
+    char   **path;      /* gsof file paths */
+    int    np,ip;       /* number of file paths, current path index */
+    FILE   *fp;         /* current file pointer (NULL: closed) */
+    raw_t  *raw;        /* raw data control */
+    gsof_t data;        /* gsof message data of last input */
+} gsofstr_t;
+
 /* type definitions ----------------------------------------------------------*/
 typedef struct vt_tag { /* virtual console type */
     int state;          /* state(0:close,1:open) */
@@ -2187,6 +2272,36 @@ typedef struct {         /* time synchronization index in buffer */
     gtime_t time[6];     /* current time of rover,base,imu,pvt,image and pose measurement */
 } syn_t;
 
+typedef struct {        /* measurement event type */
+    gtime_t time;       /* measurement time */
+    int type;           /* event type (0:rover,1:base,2:imu,3:pvt,4:image,5:pose) */
+    int index;          /* index of measurement in server buffer */
+} evt_t;
+
+typedef struct {        /* time-ordered measurement event queue type (min-heap) */
+    int n,nmax;         /* number and max number of events */
+    int dir;            /* time direction (1:forward,-1:backward) */
+    gtime_t tlast[6];   /* latest time of pushed events per stream */
+    evt_t last[6];      /* last popped events {rover,base,imu,pvt,image,pose} */
+    evt_t *data;        /* events */
+} evtq_t;
+
+typedef struct {        /* single-producer/single-consumer byte queue type */
+    int size;           /* size of queue buffer (bytes) (power of 2) */
+    unsigned int head;  /* write position (bytes) (updated by producer only) */
+    unsigned int tail;  /* read position (bytes) (updated by consumer only) */
+    unsigned char *buff;/* queue buffer */
+} spscq_t;
+
+typedef struct {        /* input stream reader type */
+    int state;          /* reader state (0:stop,1:running) */
+    int index;          /* input stream index */
+    int dire;           /* solution direction of input data (copy of raw) */
+    void *svr;          /* rtk server */
+    spscq_t que;        /* queue of input stream data to server thread */
+    thread_t thread;    /* reader thread */
+} strrdr_t;
+
 typedef struct {        /* RTK server type */
     int pause;          /* pause program (0:off,1:on ) */
     int reinit;         /* re-initial ins states (0:off,1:on) */
@@ -2230,6 +2345,7 @@ typedef struct {        /* RTK server type */
     img_t  img[MAXIMGBUF];    /* image raw data from camera measurement */
     pose_meas_t pose[MAXPOSEBUF]; /* pose measurement from camera or dual ant. */
     syn_t syn;                    /* time synchronization index of buffer */
+    evtq_t evtq;                  /* time-ordered event queue for time alignment */
     nav_t nav;                    /* navigation data */
     sbsmsg_t sbsmsg[MAXSBSMSG];   /* SBAS message buffer */
     stream_t stream[14];/* streams {rov,base,corr,sol,imu,image,pose,sol1,sol2,logr,logb,logc,logi,logs} */
@@ -2238,6 +2354,10 @@ typedef struct {        /* RTK server type */
     vt_t *vt;           /* virtual console */
     solopt_t solopt[2]; /* output solution options {sol1,sol2} */
     solbuf_t gtsols;    /* ground-truth solution data */
+    strrdr_t rdr[7];    /* input stream readers {rov,base,corr,sol,imu,image,pose} */
+    int event;          /* input data event flag */
+    lock_t elock;       /* lock flag of input data event */
+    cond_t econd;       /* condition of input data event */
     thread_t thread;    /* server thread */
     lock_t lock;        /* lock flag */
 } rtksvr_t;
@@ -2271,6 +2391,12 @@ typedef struct {        /* gis type */
     double bound[4];    /* boundary {lat0,lat1,lon0,lon1} */
 } gis_t;
 
+typedef struct {        /* parsed data cache type */
+    unsigned char *buff; /* cache data buffer */
+    int n, nmax;        /* data length and buffer size (bytes) */
+    int pos;            /* read position (bytes) */
+} cache_t;
+
 typedef void fatalfunc_t(const char *); /* fatal callback function type */
 typedef int8_t s8;                      /* Signed 8-bit integer */
 typedef int16_t s16;                    /* Signed 16-bit integer */
@@ -2339,6 +2465,7 @@ EXPORT void matmul(const char *tr, int n, int k, int m, double alpha,
                    const double *A, const double *B, double beta, double *C);
 EXPORT void matmul33(const char *tr,const double *A,const double *B,const double *C,
                      int n,int p,int q,int m,double *D);
+EXPORT void matsyrk(int n, int k, double alpha, const double *A, double *C);
 EXPORT int  matinv(double *A, int n);
 EXPORT int  matsvd(double *A, int m,int n,double *U,double *W,double *V);
 EXPORT int  solve (const char *tr, const double *A, const double *Y, int n,
@@ -2347,6 +2474,12 @@ EXPORT int  lsq   (const double *A, const double *y, int n, int m, double *x,
                    double *Q);
 EXPORT int  filter(double *x, double *P, const double *H, const double *v,
                    const double *R, int n, int m);
+EXPORT int  initfiltws(filtws_t *ws, int n, int m);
+EXPORT void freefiltws(filtws_t *ws);
+EXPORT int  filter_ws(filtws_t *ws, double *x, double *P, const double *H,
+                      const double *v, const double *R, int n, int m);
+EXPORT int  filter_seq(filtws_t *ws, double *x, double *P, const double *H,
+                       const double *v, const double *R, int n, int m);
 EXPORT int  smoother(const double *xf, const double *Qf, const double *xb,
                      const double *Qb, int n, double *xs, double *Qs);
 EXPORT void lsmooth3(double *in, double *out, int N);
@@ -2433,6 +2566,7 @@ EXPORT void readpos(const char *file, const char *rcv, double *pos);
 EXPORT int  sortobs(obs_t *obs);
 EXPORT int  sortgsof(gsof_data_t *gsof);
 EXPORT void uniqnav(nav_t *nav);
+EXPORT void indexnav(nav_t *nav);
 EXPORT int  screent(gtime_t time, gtime_t ts, gtime_t te, double tint);
 EXPORT int  readnav(const char *file, nav_t *nav);
 EXPORT int  savenav(const char *file, const nav_t *nav);
@@ -2528,17 +2662,34 @@ EXPORT int readrnx (const char *file, int rcv, const char *opt, obs_t *obs,
 EXPORT int readrnxt(const char *file, int rcv, gtime_t ts, gtime_t te,
                     double tint, const char *opt, obs_t *obs, nav_t *nav,
                     sta_t *sta);
+EXPORT int readrnxm(char **file, const int *index, int n, gtime_t ts,
+                    gtime_t te, double tint, const char **opt, obs_t *obs,
+                    nav_t *nav, sta_t *sta);
 EXPORT int readrnxc(const char *file, nav_t *nav);
 EXPORT int readgsoff(const char *file,gsof_data_t *gsof);
 EXPORT int readimub(const char *file,imu_t* imu,int decfmt,int imufmt,int coor,
                     int valfmt);
+EXPORT int  open_gsofstr (gsofstr_t *str, char **file, int n);
+EXPORT int  input_gsofstr(gsofstr_t *str);
+EXPORT void close_gsofstr(gsofstr_t *str);
 EXPORT int readjpeg(const char *imgfile,gtime_t time,img_t *img,int flag);
 EXPORT int rtk_uncompress(const char *file, char *uncfile);
+EXPORT void setcache(int ena);
+EXPORT int  readcache (const char *file, const char *key, cache_t *cache);
+EXPORT int  writecache(const char *file, const char *key, const cache_t *cache);
+EXPORT int  putcache  (cache_t *cache, const void *data, int size);
+EXPORT int  getcache  (cache_t *cache, void *data, int size);
+EXPORT void freecache (cache_t *cache);
 EXPORT int convrnx(int format, rnxopt_t *opt, const char *file, char **ofile);
 EXPORT int  init_rnxctr (rnxctr_t *rnx);
 EXPORT void free_rnxctr (rnxctr_t *rnx);
 EXPORT int  open_rnxctr (rnxctr_t *rnx, FILE *fp);
 EXPORT int  input_rnxctr(rnxctr_t *rnx, FILE *fp);
+EXPORT int  open_rnxstr (rnxstr_t *str, char **file, int n, int rcv, gtime_t ts,
+                         gtime_t te, double tint, const char *opt, nav_t *nav,
+                         sta_t *sta);
+EXPORT int  input_rnxstr(rnxstr_t *str);
+EXPORT void close_rnxstr(rnxstr_t *str);
 EXPORT int addobsdata(obs_t *obs, const obsd_t *data);
 EXPORT int addimudata(imu_t *imu, const imud_t *data);
 /* ephemeris and clock functions ---------------------------------------------*/
@@ -2547,6 +2698,8 @@ EXPORT double geph2clk(gtime_t time, const geph_t *geph);
 EXPORT double seph2clk(gtime_t time, const seph_t *seph);
 EXPORT void eph2pos (gtime_t time, const eph_t  *eph,  double *rs, double *dts,
                      double *var);
+EXPORT void eph2posn(const gtime_t *time, const eph_t **eph, int n, double *rs,
+                     double *dts, double *var);
 EXPORT void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts,
                      double *var);
 EXPORT void seph2pos(gtime_t time, const seph_t *seph, double *rs, double *dts,
@@ -2560,6 +2713,8 @@ EXPORT int  satpos(gtime_t time, gtime_t teph, int sat, int ephopt,
                    int *svh);
 EXPORT void satposs(gtime_t time, const obsd_t *obs, int n, const nav_t *nav,
                     int sateph, double *rs, double *dts, double *var, int *svh);
+EXPORT void setorbint(double tint);
+EXPORT void updnavgen(void);
 EXPORT void readsp3(const char *file, nav_t *nav, int opt);
 EXPORT int  readsap(const char *file, gtime_t time, nav_t *nav);
 EXPORT int  readdcb(const char *file, nav_t *nav, const sta_t *sta);
@@ -2575,12 +2730,16 @@ EXPORT double gdelaycorr(const int sys, const double *rr,const double *rs);
 /* receiver raw data functions -----------------------------------------------*/
 EXPORT unsigned int getbitu(const unsigned char *buff, int pos, int len);
 EXPORT int          getbits(const unsigned char *buff, int pos, int len);
+EXPORT int getbitun(const unsigned char *buff, int pos, int len, int n, unsigned int *data);
+EXPORT int getbitsn(const unsigned char *buff, int pos, int len, int n, int *data);
 EXPORT void setbitu(unsigned char *buff, int pos, int len, unsigned int data);
 EXPORT void setbits(unsigned char *buff, int pos, int len, int data);
 EXPORT long bin2dec(const unsigned char *b,int n);
 EXPORT unsigned int rtk_crc32  (const unsigned char *buff, int len);
 EXPORT unsigned int rtk_crc24q (const unsigned char *buff, int len);
 EXPORT unsigned short rtk_crc16(const unsigned char *buff, int len);
+EXPORT unsigned int rtk_sum8   (const unsigned char *buff, int len);
+EXPORT unsigned char rtk_xor8  (const unsigned char *buff, int len);
 EXPORT int decode_word (unsigned int word, unsigned char *data);
 EXPORT int decode_frame(const unsigned char *buff, eph_t *eph, alm_t *alm,
                         double *ion, double *utc, int *leaps);
@@ -2783,6 +2942,7 @@ EXPORT void strclose (stream_t *stream);
 EXPORT int  strread  (stream_t *stream, unsigned char *buff, int n);
 EXPORT int  strwrite (stream_t *stream, unsigned char *buff, int n);
 EXPORT void strsync  (stream_t *stream1, stream_t *stream2);
+EXPORT int  strwait  (stream_t *stream, int n, int ms);
 EXPORT int  strstat  (stream_t *stream, char *msg);
 EXPORT int  strstatx (stream_t *stream, char *msg);
 EXPORT void strsum   (stream_t *stream, int *inb, int *inr, int *outb, int *outr);
@@ -2803,6 +2963,11 @@ EXPORT int lambda(int n, int m, const double *a, const double *Q, double *F,
 EXPORT int lambda_reduction(int n, const double *Q, double *Z);
 EXPORT int lambda_search(int n, int m, const double *a, const double *Q,
                          double *F, double *s);
+EXPORT int  lambda_init (lambda_t *lam, int n, const double *a,
+                         const double *Q);
+EXPORT int  lambda_drop (lambda_t *lam, int k);
+EXPORT int  lambda_solve(lambda_t *lam, int m, double *F, double *s);
+EXPORT void lambda_free (lambda_t *lam);
 
 /* standard positioning ------------------------------------------------------*/
 EXPORT int pntpos(const obsd_t *obs, int n, const nav_t *nav,
@@ -2972,6 +3137,9 @@ EXPORT int  alignvnex(const double *imu,int n,double dt,const double *q0,
                       const ins_align_t *pas,double *att0,double *qo);
 EXPORT int fine_align_lym(insstate_t *ins,const imud_t *data,int n,const insopt_t *opt);
 EXPORT int readimu(const char *file, imu_t *imu,int decfmt,int format,int coor,int valfmt);
+EXPORT int  open_imustr (imustr_t *str, const char *file, int imufmt);
+EXPORT int  input_imustr(imustr_t *str);
+EXPORT void close_imustr(imustr_t *str);
 EXPORT int sortimudata(imu_t *imu);
 EXPORT void adjimudata(const prcopt_t *opt,imu_t *imu);
 EXPORT void adjustimu(const prcopt_t *opt,imud_t *imu);
@@ -2999,6 +3167,12 @@ EXPORT void dcm2rot(const double *C,double *rv);
 EXPORT void getvn(const insstate_t *ins,double *vn);
 EXPORT void update_ins_state_n(insstate_t *ins);
 EXPORT void update_ins_state_e(insstate_t *ins);
+EXPORT int sizecov(int n,int prec);
+EXPORT int packcov(const double *P,int n,int prec,unsigned char *buff);
+EXPORT int unpackcov(const unsigned char *buff,int n,int prec,double *P);
+EXPORT int sizephi(int n,int nb);
+EXPORT int packphi(const double *F,int n,int nb,unsigned char *buff);
+EXPORT int unpackphi(const unsigned char *buff,int n,int nb,double *F);
 EXPORT int insinitdualant(rtksvr_t *svr,const pose_meas_t *pose,const sol_t *sol,
                           const imud_t *imu);
 EXPORT int calibdualant(const insopt_t *opt,const solbuf_t *solbuf,
@@ -3136,6 +3310,7 @@ EXPORT int lcrts(const imu_t *imu,const gsof_data_t *pos,const prcopt_t *popt,
 EXPORT int lcfbsm(const imu_t *imu,const gsof_data_t *pos,const prcopt_t *popt,
                   const solopt_t *solopt,int port,const char *file);
 EXPORT void set_fwd_soltmp_file(const char *file);
+EXPORT void set_rts_memlimit(double mem);
 EXPORT void set_fwdtmp_file(const char *file);
 EXPORT int bckup_ins_info(insstate_t *ins,const insopt_t *opt,int type);
 
@@ -27,10 +27,11 @@
 
 /* help text -----------------------------------------------------------------*/
 static const char *usage[] = {
-    "usage: lc-rts [-p port][-o file]",
+    "usage: lc-rts [-p port][-o file][-m mem]",
     "options",
     "  -p port    port number for telnet console",
     "  -o file    processing options file",
+    "  -m mem     memory limit of forward solutions (MB) (0: no limit)",
 };
 static int strtype[] = {/* stream types */
                         STR_SERIAL, STR_NONE, STR_NONE, STR_NONE, STR_NONE, STR_NONE, STR_NONE,
@@ -133,7 +134,7 @@ static int readpos(const char *file, int type)
 }
 /* RTS main------------------------------------------------------------------
  * sysnopsis
- *     lc-rts [-p port] [-o file]
+ *     lc-rts [-p port] [-o file] [-m mem]
  *
  * description
  *     A command line version of RTS smoother for ins and gnss loosely coupled.
@@ -141,11 +142,14 @@ static int readpos(const char *file, int type)
  * option
  *     -p  port number for monitor stream
  *     -o  processing options file
+ *     -m  memory limit of forward solutions (MB), forward filter is recomputed
+ *         from checkpoints in backward pass if exceeded (0: no limit)
  *
  * --------------------------------------------------------------------------*/
 int main(int argc, char **argv)
 {
     int i, port = 0;
+    double mem = 0.0;
     char file[1024];
 
     for (i = 1; i < argc; i++)
@@ -154,6 +158,8 @@ int main(int argc, char **argv)
             port = atoi(argv[++i]);
         else if (!strcmp(argv[i], "-o") && i + 1 < argc)
             strcpy(file, argv[++i]);
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc)
+            mem = atof(argv[++i]);
         else
             printusage();
     }
@@ -174,6 +180,9 @@ int main(int argc, char **argv)
     /* set forward solution-binary file path */
     set_fwd_soltmp_file(NULL);
 
+    /* set memory limit of forward solutions */
+    set_rts_memlimit(mem);
+
     /* RTS */
     lcrts(&imu, &pos, &prcopt, &solopt, port, strpath[7]);
 
@@ -163,7 +163,7 @@ static int fixsol(rtk_t *rtk, const double *v, const double *H, int nv)
         R[i + i * nv] = 0.0001;
 
     /* update states with constraints */
-    if (!(info = filter(rtk->x, rtk->P, H, v, R, rtk->nx, nv)))
+    if (!(info = filter_ws(&rtk->ws, rtk->x, rtk->P, H, v, R, rtk->nx, nv)))
     {
 
         /* set solution */
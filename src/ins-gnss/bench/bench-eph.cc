@@ -0,0 +1,123 @@
+/*-----------------------------------------------------------------------------
+ * bench-eph.cc : benchmark of satellite positions by broadcast ephemeris
+ *
+ * version : $Revision: 1.1 $ $Date: 2008/09/05 01:32:44 $
+ * history : 2026/10/17 1.0 new
+ *----------------------------------------------------------------------------*/
+#include <navlib.h>
+#include <time.h>
+
+#define NSAT 4000    /* default number of satellites per batch */
+#define NREPEAT 50   /* default number of repeats */
+#define TSPAN 7200.0 /* time span of evaluation from toe (s) */
+
+/* help text -----------------------------------------------------------------*/
+static const char *usage[] = {
+    "usage: bench-eph [-n sat] [-r repeat] file",
+    "options",
+    "  -n sat     number of satellites per batch (default 4000)",
+    "  -r repeat  number of repeats (default 50)",
+    "  file       rinex navigation data file",
+};
+/* print usage ---------------------------------------------------------------*/
+static void printusage(void)
+{
+    int i;
+    for (i = 0; i < (int)(sizeof(usage) / sizeof(*usage)); i++)
+    {
+        fprintf(stderr, "%s\n", usage[i]);
+    }
+    exit(0);
+}
+/* current time (s) ----------------------------------------------------------*/
+static double tickd(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1E-9;
+}
+/* satellite positions by eph2pos() and eph2posn() ---------------------------*/
+static void bencheph(const nav_t *nav, int n, int nrep)
+{
+    gtime_t *time;
+    const eph_t **eph;
+    double *rs0, *dts0, *var0, *rs1, *dts1, *var1, t0, t1, t2, dr, drmax = 0.0, dtmax = 0.0;
+    int i, j;
+
+    time = (gtime_t *)malloc(sizeof(gtime_t) * n);
+    eph = (const eph_t **)malloc(sizeof(eph_t *) * n);
+    rs0 = mat(3, n);
+    rs1 = mat(3, n);
+    dts0 = mat(4, n);
+    dts1 = dts0 + n;
+    var0 = dts0 + n * 2;
+    var1 = dts0 + n * 3;
+
+    /* ephemerides of navigation data at times around toe */
+    srand(1);
+    for (i = 0; i < n; i++)
+    {
+        eph[i] = nav->eph + i % nav->n;
+        time[i] = timeadd(eph[i]->toe, (rand() / (double)RAND_MAX * 2.0 - 1.0) * TSPAN);
+    }
+    t0 = tickd();
+    for (j = 0; j < nrep; j++)
+        for (i = 0; i < n; i++)
+        {
+            eph2pos(time[i], eph[i], rs0 + i * 3, dts0 + i, var0 + i);
+        }
+    t1 = tickd();
+    for (j = 0; j < nrep; j++)
+        eph2posn(time, eph, n, rs1, dts1, var1);
+    t2 = tickd();
+
+    for (i = 0; i < n; i++)
+    {
+        dr = sqrt(SQR(rs0[i * 3] - rs1[i * 3]) + SQR(rs0[1 + i * 3] - rs1[1 + i * 3]) +
+                  SQR(rs0[2 + i * 3] - rs1[2 + i * 3]));
+        drmax = MAX(drmax, dr);
+        dtmax = MAX(dtmax, fabs(dts0[i] - dts1[i]) * CLIGHT);
+    }
+    printf("%-22s: %d ephemerides %d satellites\n", "file", nav->n, n);
+    printf("%-22s: %10.0f satellites/s\n", "eph2pos()", n * nrep / (t1 - t0));
+    printf("%-22s: %10.0f satellites/s\n", "eph2posn()", n * nrep / (t2 - t1));
+    printf("%-22s: %.3e m (pos) %.3e m (clk)\n", "max difference", drmax, dtmax);
+
+    free(time);
+    free(eph);
+    free(rs0);
+    free(rs1);
+    free(dts0);
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    nav_t nav = {0};
+    const char *file = NULL;
+    int i, n = NSAT, nrep = NREPEAT;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            nrep = atoi(argv[++i]);
+        else if (*argv[i] == '-')
+            printusage();
+        else
+            file = argv[i];
+    }
+    if (!file || n <= 0 || nrep <= 0)
+        printusage();
+
+    if (readrnx(file, 0, "", NULL, &nav, NULL) <= 0 || nav.n <= 0)
+    {
+        fprintf(stderr, "no ephemeris: %s\n", file);
+        return -1;
+    }
+    uniqnav(&nav);
+
+    bencheph(&nav, n, nrep);
+    freenav(&nav, 0xFF);
+    return 0;
+}
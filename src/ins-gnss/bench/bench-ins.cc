@@ -0,0 +1,114 @@
+/*-----------------------------------------------------------------------------
+ * bench-ins.cc : benchmark of 3x3 kernels and ins mechanization
+ *
+ * version : $Revision: 1.1 $ $Date: 2008/09/05 01:32:44 $
+ * history : 2026/10/16 1.0 new
+ *----------------------------------------------------------------------------*/
+#include <navlib.h>
+#include <mat3.h>
+#include <time.h>
+
+#define NSAMP 200000 /* default number of imu samples */
+#define TINT 0.01    /* imu sampling interval (s) */
+
+/* help text -----------------------------------------------------------------*/
+static const char *usage[] = {
+    "usage: bench-ins [-n samp]",
+    "options",
+    "  -n samp    number of imu samples (default 200000)",
+};
+/* print usage ---------------------------------------------------------------*/
+static void printusage(void)
+{
+    int i;
+    for (i = 0; i < (int)(sizeof(usage) / sizeof(*usage)); i++)
+    {
+        fprintf(stderr, "%s\n", usage[i]);
+    }
+    exit(0);
+}
+/* current time (s) ----------------------------------------------------------*/
+static double tickd(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1E-9;
+}
+/* 3x3 products by generic matmul() and fixed-size kernel --------------------*/
+static void benchmat3(int n)
+{
+    double A[9], B[9], C[9] = {0}, t0, t1, t2, chk0 = 0.0, chk1 = 0.0;
+    int i, j;
+
+    for (i = 0; i < 9; i++)
+    {
+        A[i] = 0.1 * (i + 1);
+        B[i] = 0.2 * (9 - i);
+    }
+    t0 = tickd();
+    for (i = 0; i < n; i++)
+    {
+        A[i % 9] += 1E-9;
+        matmul("NN", 3, 3, 3, 1.0, A, B, 0.0, C);
+        chk0 += C[4];
+    }
+    t1 = tickd();
+    for (i = 0; i < n; i++)
+    {
+        A[i % 9] -= 1E-9;
+        mat3mul_nn(A, B, C);
+        chk1 += C[4];
+    }
+    t2 = tickd();
+    for (j = 0; j < 2; j++)
+    {
+        printf("%-22s: %10.0f products/s\n", j ? "3x3 mat3mul_nn()" : "3x3 matmul()",
+               n / (j ? t2 - t1 : t1 - t0));
+    }
+    printf("%-22s: %.6e %.6e\n", "checksum", chk0, chk1);
+}
+/* ins mechanization by updateins() ------------------------------------------*/
+static void benchins(int n)
+{
+    insopt_t opt = {0};
+    insstate_t ins = {0};
+    imud_t data = {0};
+    double ep[] = {2017, 11, 7, 6, 0, 0}, re[] = {-2149489.5, 4426573.1, 4044349.3}, t0, t1;
+    int i;
+
+    data.time = epoch2time(ep);
+    data.accl[2] = -9.8;
+    initins(&ins, re, 0.0, &data, 1, &opt);
+
+    t0 = tickd();
+    for (i = 1; i <= n; i++)
+    {
+        data.time = timeadd(data.time, TINT);
+        data.accl[0] = 0.1 * sin(i * TINT);
+        data.accl[1] = 0.1 * cos(i * TINT);
+        data.gyro[2] = 0.01 * sin(0.5 * i * TINT);
+        updateins(&opt, &ins, &data);
+    }
+    t1 = tickd();
+    printf("%-22s: %10.0f samples/s (%.3f us/sample)\n", "updateins()", n / (t1 - t0), (t1 - t0) / n * 1E6);
+    printf("%-22s: %.3f %.3f %.3f\n", "final position (m)", ins.re[0], ins.re[1], ins.re[2]);
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    int i, n = NSAMP;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else
+            printusage();
+    }
+    if (n <= 0)
+        printusage();
+
+    benchmat3(n * 10);
+    benchins(n);
+    return 0;
+}
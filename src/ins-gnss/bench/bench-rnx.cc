@@ -0,0 +1,85 @@
+/*-----------------------------------------------------------------------------
+ * bench-rnx.cc : benchmark of rinex observation data reader
+ *
+ * version : $Revision: 1.1 $ $Date: 2008/09/05 01:32:44 $
+ * history : 2026/10/17 1.0 new
+ *----------------------------------------------------------------------------*/
+#include <navlib.h>
+#include <time.h>
+
+#define NREPEAT 1 /* default number of repeats */
+
+/* help text -----------------------------------------------------------------*/
+static const char *usage[] = {
+    "usage: bench-rnx [-r repeat] file",
+    "options",
+    "  -r repeat  number of repeats (default 1)",
+    "  file       rinex observation data file",
+};
+/* print usage ---------------------------------------------------------------*/
+static void printusage(void)
+{
+    int i;
+    for (i = 0; i < (int)(sizeof(usage) / sizeof(*usage)); i++)
+    {
+        fprintf(stderr, "%s\n", usage[i]);
+    }
+    exit(0);
+}
+/* current time (s) ----------------------------------------------------------*/
+static double tickd(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1E-9;
+}
+/* read rinex observation data by readrnx() ----------------------------------*/
+static void benchrnx(const char *file, int n)
+{
+    obs_t obs = {0};
+    double t0, t = 0.0, chk = 0.0;
+    int i, j, k, ne = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        obs.n = 0;
+        t0 = tickd();
+        if (readrnx(file, 1, "", &obs, NULL, NULL) <= 0)
+        {
+            fprintf(stderr, "rinex read error: %s\n", file);
+            exit(-1);
+        }
+        ne = sortobs(&obs);
+        t += tickd() - t0;
+    }
+    for (j = 0; j < obs.n; j++)
+        for (k = 0; k < NFREQ; k++)
+        {
+            chk += obs.data[j].P[k] + obs.data[j].L[k] + obs.data[j].D[k] + obs.data[j].SNR[k];
+        }
+    printf("%-22s: %d obs %d epochs\n", "file", obs.n, ne);
+    printf("%-22s: %10.0f epochs/s (%.3f s/read)\n", "readrnx()", ne * n / t, t / n);
+    printf("%-22s: %.6f\n", "checksum", chk);
+    free(obs.data);
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    const char *file = NULL;
+    int i, n = NREPEAT;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            n = atoi(argv[++i]);
+        else if (*argv[i] == '-')
+            printusage();
+        else
+            file = argv[i];
+    }
+    if (!file || n <= 0)
+        printusage();
+
+    benchrnx(file, n);
+    return 0;
+}
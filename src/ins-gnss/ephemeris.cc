@@ -52,8 +52,26 @@
  *           2015/08/26 1.11 update RTOL_ELPLER 1E-14 -> 1E-13
  *                           set MAX_ITER_KEPLER for alm2pos()
  *           2017/04/11 1.12 fix bug on max number of obs data in satposs()
+ *           2026/10/16 1.13 select ephemeris by index of satellite and toe
+ *                           cache satellite states of broadcast and precise
+ *                           ephemeris
+ *                           add api setorbint()
+ *                           add api eph2posn()
+ *                           evaluate kepler orbits of an epoch in batch
+ *                           integrate glonass orbit by adaptive dormand-prince
+ *                           5(4) from cached state
+ *           2026/10/17 1.14 add api updnavgen()
+ *                           key satellite state cache by generation of
+ *                           navigation data
+ *                           fall back to eph2pos() for all lanes of eph2posn()
+ *                           on kepler iteration overflow
+ *                           limit steps of glonass orbit integration
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AVX2KEPLER /* kepler orbits by avx2 with runtime dispatch */
+#endif
 
 /* constants and macros ------------------------------------------------------*/
 #define RE_GLO 6378136.0      /* radius of earth (m)            ref [2] */
@@ -72,6 +90,12 @@
 
 #define ERREPH_GLO 5.0    /* error of glonass ephemeris (m) */
 #define TSTEP 60.0        /* integration step glonass ephemeris (s) */
+#define MAXSTEP_GLO 300.0 /* max integration step glonass ephemeris (s) */
+#define MINSTEP_GLO 1E-3  /* min integration step glonass ephemeris (s) */
+#define MAXITER_GLO 10000 /* max number of glonass orbit integration steps */
+#define ERRPOS_GLO 1E-4   /* tolerance of glonass orbit step position (m) */
+#define ERRVEL_GLO 1E-7   /* tolerance of glonass orbit step velocity (m/s) */
+#define TMIN_GLO 0.01     /* min time to update glonass orbit cache (s) */
 #define RTOL_KEPLER 1E-13 /* relative tolerance for Kepler equation */
 
 #define DEFURASSR 0.15             /* default accurary of ssr corr (m) */
@@ -82,6 +106,35 @@
 #define STD_BRDCCLK 30.0           /* error of broadcast clock (m) */
 
 #define MAX_ITER_KEPLER 30 /* max number of iteration of Kelpler */
+#define NSATST 4           /* number of cached states per satellite */
+
+typedef struct {      /* satellite state cache entry type */
+    unsigned int gen; /* generation of navigation data */
+    gtime_t time;     /* evaluation time (gpst) */
+    const void *eph;  /* ephemeris or precise ephemeris evaluated */
+    const void *clk;  /* precise clock evaluated */
+    gtime_t toe;      /* reference time of ephemeris */
+    int n;            /* iode of ephemeris or number of precise ephemeris */
+    int node;         /* interpolation node (velocity by central difference) */
+    double rs[6];     /* satellite position/velocity (ecef) (m|m/s) */
+    double dts[2];    /* satellite clock bias/drift (s|s/s) */
+    double var;       /* satellite position and clock error variance (m^2) */
+} satst_t;
+
+typedef struct {      /* glonass orbit integration cache type */
+    gtime_t toe;      /* epoch of ephemeris (gpst) */
+    double x0[9];     /* ephemeris position/velocity/acceleration (m|m/s|m/s^2) */
+    double t;         /* integrated time from toe (s) */
+    double x[6];      /* integrated position/velocity (m|m/s) */
+    double h;         /* next integration step (s) */
+} glost_t;
+
+/* global variables ----------------------------------------------------------*/
+static thread_local satst_t satst[MAXSAT][NSATST]; /* cached satellite states */
+static thread_local int isatst[MAXSAT];           /* next cache entry */
+static thread_local glost_t glost[MAXSAT];        /* glonass orbit integration */
+static double orbint = 0.0; /* interpolation interval of broadcast orbit (s) */
+static unsigned int navgen = 1; /* generation of navigation data (0:invalid) */
 
 /* variance by ura ephemeris (ref [1] 20.3.3.3.1.1) --------------------------*/
 static double var_uraeph(int ura)
@@ -281,6 +334,243 @@ extern void eph2pos(gtime_t time, const eph_t *eph, double *rs, double *dts, dou
     /* position and clock error variance */
     *var = var_uraeph(eph->sva);
 }
+#ifdef AVX2KEPLER
+/* sine and cosine of 4 angles (cephes polynomials) --------------------------*/
+__attribute__((target("avx2,fma"))) static void sincos4(__m256d x, __m256d *s, __m256d *c)
+{
+    static const double sc[] = {1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6,
+                                -1.98412698295895385996E-4, 8.33333333332211858878E-3, -1.66666666666666307295E-1};
+    static const double cc[] = {-1.13585365213876817300E-11, 2.08757008419747316778E-9, -2.75573141792967388112E-7,
+                                2.48015872888517045348E-5,   -1.38888888888730564116E-3, 4.16666666666665929218E-2};
+    const __m256d sgn = _mm256_set1_pd(-0.0);
+    __m256d ax, sx, y, z, zz, ps, pc, swap, sins, coss;
+    __m128i j;
+    __m256i jj;
+    int i;
+
+    ax = _mm256_andnot_pd(sgn, x);
+    sx = _mm256_and_pd(sgn, x);
+
+    /* octant j=(int)(|x|*4/pi) rounded up to even and reduced argument */
+    j = _mm256_cvttpd_epi32(_mm256_mul_pd(ax, _mm256_set1_pd(4.0 / PI)));
+    j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    y = _mm256_cvtepi32_pd(j);
+    z = _mm256_fnmadd_pd(y, _mm256_set1_pd(7.85398125648498535156E-1), ax);
+    z = _mm256_fnmadd_pd(y, _mm256_set1_pd(3.77489470793079817668E-8), z);
+    z = _mm256_fnmadd_pd(y, _mm256_set1_pd(2.69515142907905952645E-15), z);
+    zz = _mm256_mul_pd(z, z);
+
+    ps = _mm256_set1_pd(sc[0]);
+    pc = _mm256_set1_pd(cc[0]);
+    for (i = 1; i < 6; i++)
+    {
+        ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(sc[i]));
+        pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(cc[i]));
+    }
+    ps = _mm256_fmadd_pd(_mm256_mul_pd(z, zz), ps, z);
+    pc = _mm256_fmadd_pd(_mm256_mul_pd(zz, zz), pc, _mm256_fnmadd_pd(_mm256_set1_pd(0.5), zz, _mm256_set1_pd(1.0)));
+
+    /* swap polynomials in octants 2,6 and flip signs in octants 4,6 (sin) and
+       2,4 (cos) */
+    jj = _mm256_cvtepi32_epi64(j);
+    swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(jj, _mm256_set1_epi64x(2)), _mm256_set1_epi64x(2)));
+    sins = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(jj, _mm256_set1_epi64x(4)), 61));
+    coss = _mm256_castsi256_pd(
+        _mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(jj, _mm256_set1_epi64x(2)), _mm256_set1_epi64x(4)), 61));
+    *s = _mm256_xor_pd(_mm256_xor_pd(_mm256_blendv_pd(ps, pc, swap), sins), sx);
+    *c = _mm256_xor_pd(_mm256_blendv_pd(pc, ps, swap), coss);
+}
+/* broadcast ephemerides to satellite positions and clock biases of 4 sats -----
+ * return : failed lanes (bit mask), all lanes if kepler iteration overflows
+ *          since no outputs are written
+ *----------------------------------------------------------------------------*/
+__attribute__((target("avx2,fma"))) static int eph2pos4(const gtime_t *time, const eph_t **eph, double *rs,
+                                                       double *dts)
+{
+    double tk[4], tc[4], mu[4], omge[4], A[4], e[4], M0[4], deln[4], omg[4], i0[4], idot[4], OMG0[4], OMGd[4];
+    double toes[4], crs[4], crc[4], cus[4], cuc[4], cis[4], cic[4], f0[4], f1[4], f2[4], out[4];
+    __m256d vA, ve, vM, vE, vEk, vEn, vs, vc, cont, sE, cE, den, sv, cv, so, co, su, cu, s2u, c2u, r, du, sd, cd;
+    __m256d vi, si, ci, vO, sO, cO, x, y, t0, t1, vt;
+    const __m256d sgn = _mm256_set1_pd(-0.0), one = _mm256_set1_pd(1.0);
+    int i, n, mask, sys;
+
+    for (i = 0; i < 4; i++)
+    {
+        sys = satsys(eph[i]->sat, NULL);
+        mu[i] = sys == SYS_GAL ? MU_GAL : (sys == SYS_CMP ? MU_CMP : MU_GPS);
+        omge[i] = sys == SYS_GAL ? OMGE_GAL : (sys == SYS_CMP ? OMGE_CMP : OMGE);
+        tk[i] = timediff(time[i], eph[i]->toe);
+        tc[i] = timediff(time[i], eph[i]->toc);
+        A[i] = eph[i]->A;
+        e[i] = eph[i]->e;
+        M0[i] = eph[i]->M0;
+        deln[i] = eph[i]->deln;
+        omg[i] = eph[i]->omg;
+        i0[i] = eph[i]->i0;
+        idot[i] = eph[i]->idot;
+        OMG0[i] = eph[i]->OMG0;
+        OMGd[i] = eph[i]->OMGd;
+        toes[i] = eph[i]->toes;
+        crs[i] = eph[i]->crs;
+        crc[i] = eph[i]->crc;
+        cus[i] = eph[i]->cus;
+        cuc[i] = eph[i]->cuc;
+        cis[i] = eph[i]->cis;
+        cic[i] = eph[i]->cic;
+        f0[i] = eph[i]->f0;
+        f1[i] = eph[i]->f1;
+        f2[i] = eph[i]->f2;
+    }
+    vA = _mm256_loadu_pd(A);
+    ve = _mm256_loadu_pd(e);
+    vt = _mm256_loadu_pd(tk);
+    t0 = _mm256_sqrt_pd(_mm256_div_pd(_mm256_loadu_pd(mu), _mm256_mul_pd(_mm256_mul_pd(vA, vA), vA)));
+    vM = _mm256_add_pd(_mm256_loadu_pd(M0), _mm256_mul_pd(_mm256_add_pd(t0, _mm256_loadu_pd(deln)), vt));
+
+    /* kepler equation by newton's method, converged lanes are kept */
+    for (n = 0, vE = vM, vEk = _mm256_setzero_pd();; n++)
+    {
+        cont = _mm256_cmp_pd(_mm256_andnot_pd(sgn, _mm256_sub_pd(vE, vEk)), _mm256_set1_pd(RTOL_KEPLER), _CMP_GT_OQ);
+        if (!(mask = _mm256_movemask_pd(cont)))
+            break;
+        if (n >= MAX_ITER_KEPLER)
+            return 0xF;
+        sincos4(vE, &vs, &vc);
+        t0 = _mm256_sub_pd(_mm256_fnmadd_pd(ve, vs, vE), vM);
+        t1 = _mm256_fnmadd_pd(ve, vc, one);
+        vEn = _mm256_sub_pd(vE, _mm256_div_pd(t0, t1));
+        vEk = _mm256_blendv_pd(vEk, vE, cont);
+        vE = _mm256_blendv_pd(vE, vEn, cont);
+    }
+    sincos4(vE, &sE, &cE);
+
+    /* argument of latitude by true anomaly without atan2 */
+    den = _mm256_fnmadd_pd(ve, cE, one);
+    sv = _mm256_div_pd(_mm256_mul_pd(_mm256_sqrt_pd(_mm256_fnmadd_pd(ve, ve, one)), sE), den);
+    cv = _mm256_div_pd(_mm256_sub_pd(cE, ve), den);
+    sincos4(_mm256_loadu_pd(omg), &so, &co);
+    su = _mm256_fmadd_pd(sv, co, _mm256_mul_pd(cv, so));
+    cu = _mm256_fmsub_pd(cv, co, _mm256_mul_pd(sv, so));
+    s2u = _mm256_mul_pd(_mm256_set1_pd(2.0), _mm256_mul_pd(su, cu));
+    c2u = _mm256_mul_pd(_mm256_sub_pd(cu, su), _mm256_add_pd(cu, su));
+
+    /* second harmonic corrections */
+    r = _mm256_mul_pd(vA, den);
+    r = _mm256_fmadd_pd(_mm256_loadu_pd(crs), s2u, _mm256_fmadd_pd(_mm256_loadu_pd(crc), c2u, r));
+    du = _mm256_fmadd_pd(_mm256_loadu_pd(cus), s2u, _mm256_mul_pd(_mm256_loadu_pd(cuc), c2u));
+    vi = _mm256_fmadd_pd(_mm256_loadu_pd(idot), vt, _mm256_loadu_pd(i0));
+    vi = _mm256_fmadd_pd(_mm256_loadu_pd(cis), s2u, _mm256_fmadd_pd(_mm256_loadu_pd(cic), c2u, vi));
+    sincos4(du, &sd, &cd);
+    t0 = _mm256_fmadd_pd(su, cd, _mm256_mul_pd(cu, sd));
+    t1 = _mm256_fmsub_pd(cu, cd, _mm256_mul_pd(su, sd));
+    x = _mm256_mul_pd(r, t1);
+    y = _mm256_mul_pd(r, t0);
+    sincos4(vi, &si, &ci);
+
+    /* right ascension of ascending node and rotation to ecef */
+    t0 = _mm256_loadu_pd(omge);
+    vO = _mm256_fmadd_pd(_mm256_sub_pd(_mm256_loadu_pd(OMGd), t0), vt, _mm256_loadu_pd(OMG0));
+    vO = _mm256_fnmadd_pd(t0, _mm256_loadu_pd(toes), vO);
+    sincos4(vO, &sO, &cO);
+    t1 = _mm256_mul_pd(y, ci);
+    _mm256_storeu_pd(out, _mm256_fmsub_pd(x, cO, _mm256_mul_pd(t1, sO)));
+    for (i = 0; i < 4; i++)
+        rs[i * 3] = out[i];
+    _mm256_storeu_pd(out, _mm256_fmadd_pd(x, sO, _mm256_mul_pd(t1, cO)));
+    for (i = 0; i < 4; i++)
+        rs[1 + i * 3] = out[i];
+    _mm256_storeu_pd(out, _mm256_mul_pd(y, si));
+    for (i = 0; i < 4; i++)
+        rs[2 + i * 3] = out[i];
+
+    /* clock bias with relativity correction */
+    _mm256_storeu_pd(out, sE);
+    for (i = 0; i < 4; i++)
+    {
+        dts[i] = f0[i] + f1[i] * tc[i] + f2[i] * tc[i] * tc[i];
+        dts[i] -= 2.0 * sqrt(mu[i] * A[i]) * e[i] * out[i] / SQR(CLIGHT);
+    }
+    return 0;
+}
+/* avx2 and fma supported by cpu ---------------------------------------------*/
+static int cpuavx2(void)
+{
+    static const int avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+    return avx2;
+}
+#endif /* AVX2KEPLER */
+/* broadcast ephemerides to satellite positions and clock biases ---------------
+ * compute satellite positions and clock biases with broadcast ephemerides
+ * (gps, galileo, qzss, beidou) of an epoch in batch
+ * args   : gtime_t *time    I   times (gpst)
+ *          eph_t  **eph     I   broadcast ephemerides
+ *          int    n         I   number of times and ephemerides
+ *          double *rs       O   satellite positions (ecef) {x,y,z}*n (m)
+ *          double *dts      O   satellite clock biases (s)
+ *          double *var      O   satellite position and clock variances (m^2)
+ * return : none
+ * notes  : same as eph2pos() for each ephemeris.
+ *          with avx2 and fma supported by cpu, kepler equations and rotations
+ *          are solved for 4 ephemerides at once. beidou geo satellites, invalid
+ *          ephemerides and kepler iteration overflows fall back to eph2pos().
+ *          results agree with eph2pos() within rounding errors (<1E-6 m).
+ *-----------------------------------------------------------------------------*/
+extern void eph2posn(const gtime_t *time, const eph_t **eph, int n, double *rs, double *dts, double *var)
+{
+    int i;
+#ifdef AVX2KEPLER
+    gtime_t t[4];
+    const eph_t *e[4];
+    double r[12], d[4];
+    int j, k, m = 0, idx[4], prn, fail;
+#endif
+
+    trace(4, "eph2posn: n=%d\n", n);
+
+#ifdef AVX2KEPLER
+    if (cpuavx2())
+    {
+        for (i = 0; i < n; i++)
+        {
+            if (eph[i]->A > 0.0 && !(satsys(eph[i]->sat, &prn) == SYS_CMP && prn <= 5))
+                idx[m++] = i;
+            else
+                eph2pos(time[i], eph[i], rs + i * 3, dts + i, var + i);
+
+            if (m < 4 && (m == 0 || i < n - 1))
+                continue;
+
+            /* pad last lanes with the last ephemeris */
+            for (j = 0; j < 4; j++)
+            {
+                t[j] = time[idx[j < m ? j : m - 1]];
+                e[j] = eph[idx[j < m ? j : m - 1]];
+            }
+            fail = eph2pos4(t, e, r, d);
+
+            for (j = 0; j < m; j++)
+            {
+                k = idx[j];
+                if (fail & (1 << j))
+                {
+                    eph2pos(time[k], eph[k], rs + k * 3, dts + k, var + k);
+                    continue;
+                }
+                rs[k * 3] = r[j * 3];
+                rs[1 + k * 3] = r[1 + j * 3];
+                rs[2 + k * 3] = r[2 + j * 3];
+                dts[k] = d[j];
+                var[k] = var_uraeph(eph[k]->sva);
+            }
+            m = 0;
+        }
+        return;
+    }
+#endif
+    for (i = 0; i < n; i++)
+        eph2pos(time[i], eph[i], rs + i * 3, dts + i, var + i);
+}
 /* glonass orbit differential equations --------------------------------------*/
 static void deq(const double *x, double *xdot, const double *acc)
 {
@@ -302,24 +592,84 @@ static void deq(const double *x, double *xdot, const double *acc)
     xdot[4] = (c + omg2) * x[1] - 2.0 * OMGE_GLO * x[3] + acc[1];
     xdot[5] = (c - 2.0 * a) * x[2] + acc[2];
 }
-/* glonass position and velocity by numerical integration --------------------*/
-static void glorbit(double t, double *x, const double *acc)
+/* glonass orbit step by dormand-prince 5(4) -----------------------------------
+ * advance state by step h and return error estimate normalized by tolerance
+ *-----------------------------------------------------------------------------*/
+static double glostep(double h, double *x, const double *acc)
 {
-    double k1[6], k2[6], k3[6], k4[6], w[6];
-    int i;
-
-    deq(x, k1, acc);
-    for (i = 0; i < 6; i++)
-        w[i] = x[i] + k1[i] * t / 2.0;
-    deq(w, k2, acc);
-    for (i = 0; i < 6; i++)
-        w[i] = x[i] + k2[i] * t / 2.0;
-    deq(w, k3, acc);
-    for (i = 0; i < 6; i++)
-        w[i] = x[i] + k3[i] * t;
-    deq(w, k4, acc);
+    static const double a[6][6] = {{1.0 / 5.0},
+                                   {3.0 / 40.0, 9.0 / 40.0},
+                                   {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+                                   {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+                                   {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+                                   {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}};
+    static const double e[7] = {71.0 / 57600.0,  0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0,
+                                22.0 / 525.0, -1.0 / 40.0};
+    double k[7][6], w[6], err, errmax = 0.0;
+    int i, j, l;
+
+    deq(x, k[0], acc);
+    for (j = 0; j < 6; j++)
+    {
+        for (i = 0; i < 6; i++)
+        {
+            for (l = 0, w[i] = x[i]; l <= j; l++)
+                w[i] += h * a[j][l] * k[l][i];
+        }
+        deq(w, k[j + 1], acc);
+    }
+    /* 5th order solution and difference to embedded 4th order one */
     for (i = 0; i < 6; i++)
-        x[i] += (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]) * t / 6.0;
+    {
+        for (l = 0, err = 0.0; l < 7; l++)
+            err += h * e[l] * k[l][i];
+        err = fabs(err) / (i < 3 ? ERRPOS_GLO : ERRVEL_GLO);
+        if (!(err <= errmax)) /* including nan */
+            errmax = err;
+        x[i] = w[i];
+    }
+    return errmax;
+}
+/* glonass position and velocity by adaptive numerical integration -----------*/
+static int glorbit(double t, double *tc, double *x, double *h, const double *acc)
+{
+    double xt[6], tt, err;
+    int i, clip, n;
+
+    for (n = 0; fabs(t - *tc) > 1E-9; n++)
+    {
+        if (n >= MAXITER_GLO || !(*h >= MINSTEP_GLO))
+        {
+            trace(2, "glorbit: integration error t=%.3f tc=%.3f h=%.3E n=%d\n", t, *tc, *h, n);
+            return 0;
+        }
+        tt = t > *tc ? *h : -*h;
+        if ((clip = fabs(t - *tc) < *h))
+            tt = t - *tc;
+
+        for (i = 0; i < 6; i++)
+            xt[i] = x[i];
+        if (isnan(err = glostep(tt, xt, acc)))
+        {
+            trace(2, "glorbit: integration error t=%.3f tc=%.3f h=%.3E n=%d\n", t, *tc, *h, n);
+            return 0;
+        }
+
+        if (err <= 1.0)
+        {
+            for (i = 0; i < 6; i++)
+                x[i] = xt[i];
+            *tc += tt;
+
+            /* keep step size over the last clipped step */
+            if (clip)
+                continue;
+        }
+        /* step size control */
+        *h = fabs(tt) * (err > 0.0 ? MIN(5.0, MAX(0.2, 0.9 * pow(err, -0.2))) : 5.0);
+        *h = MIN(*h, MAXSTEP_GLO);
+    }
+    return 1;
 }
 /* glonass ephemeris to satellite clock bias -----------------------------------
  * compute satellite clock bias with glonass ephemeris
@@ -352,11 +702,16 @@ extern double geph2clk(gtime_t time, const geph_t *geph)
  *          double *var      O   satellite position and clock variance (m^2)
  * return : none
  * notes  : see ref [2]
+ *          orbit is integrated by error-controlled dormand-prince 5(4) from
+ *          the last integrated state of the same ephemeris cached per
+ *          satellite and thread, or from toe if it is closer.
+ *          position is set to 0 if the integration does not converge.
  *-----------------------------------------------------------------------------*/
 extern void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts, double *var)
 {
-    double t, tt, x[6];
-    int i;
+    glost_t *p = glost + (geph->sat > 0 && geph->sat <= MAXSAT ? geph->sat - 1 : 0);
+    double t, tc, h, x[6], x0[9];
+    int i, cache, valid = geph->sat > 0 && geph->sat <= MAXSAT;
 
     trace(4, "geph2pos: time=%s sat=%2d\n", time_str(time, 3), geph->sat);
 
@@ -366,14 +721,37 @@ extern void geph2pos(gtime_t time, const geph_t *geph, double *rs, double *dts,
 
     for (i = 0; i < 3; i++)
     {
-        x[i] = geph->pos[i];
-        x[i + 3] = geph->vel[i];
+        x0[i] = geph->pos[i];
+        x0[i + 3] = geph->vel[i];
+        x0[i + 6] = geph->acc[i];
     }
-    for (tt = t < 0.0 ? -TSTEP : TSTEP; fabs(t) > 1E-9; t -= tt)
+    /* start from cached state if same ephemeris and closer than toe */
+    cache = valid && p->toe.time == geph->toe.time && p->toe.sec == geph->toe.sec && fabs(t - p->t) < fabs(t);
+    for (i = 0; i < 9 && cache; i++)
+        cache = p->x0[i] == x0[i];
+
+    for (i = 0; i < 6; i++)
+        x[i] = cache ? p->x[i] : x0[i];
+    tc = cache ? p->t : 0.0;
+    h = cache ? p->h : TSTEP;
+
+    if (!glorbit(t, &tc, x, &h, geph->acc))
     {
-        if (fabs(t) < TSTEP)
-            tt = t;
-        glorbit(tt, x, geph->acc);
+        for (i = 0; i < 3; i++)
+            rs[i] = 0.0;
+        *var = SQR(ERREPH_GLO);
+        return;
+    }
+    /* update cache except for small offsets (velocity by differential) */
+    if (valid && fabs(t - (cache ? p->t : 0.0)) >= TMIN_GLO)
+    {
+        p->toe = geph->toe;
+        for (i = 0; i < 9; i++)
+            p->x0[i] = x0[i];
+        p->t = t;
+        for (i = 0; i < 6; i++)
+            p->x[i] = x[i];
+        p->h = h;
     }
     for (i = 0; i < 3; i++)
         rs[i] = x[i];
@@ -429,11 +807,46 @@ extern void seph2pos(gtime_t time, const seph_t *seph, double *rs, double *dts,
 
     *var = var_uraeph(seph->sva);
 }
+/* select ephemeris closest to time by index ---------------------------------*/
+static int selidx(const ephidx_t *idx, gtime_t time, int sat, double tmax)
+{
+    const ephkey_t *key = idx->key;
+    double tl = tmax + 1.0, tr = tmax + 1.0, tmin;
+    int i, k, p = idx->off[sat - 1], q = idx->off[sat], j = -1;
+
+    /* first entry of satellite with toe at or after time */
+    while (p < q)
+    {
+        k = (p + q) / 2;
+        if (timediff(key[k].toe, time) < 0.0)
+            p = k + 1;
+        else
+            q = k;
+    }
+    if (p > idx->off[sat - 1])
+        tl = fabs(timediff(key[p - 1].toe, time));
+    if (p < idx->off[sat])
+        tr = fabs(timediff(key[p].toe, time));
+    if ((tmin = MIN(tl, tr)) > tmax)
+        return -1;
+
+    /* last ephemeris in navigation data among toe closest to time */
+    for (i = p - 1; i >= idx->off[sat - 1] && fabs(timediff(key[i].toe, time)) == tmin; i--)
+        j = MAX(j, key[i].i);
+    for (i = p; i < idx->off[sat] && fabs(timediff(key[i].toe, time)) == tmin; i++)
+        j = MAX(j, key[i].i);
+    return j;
+}
+/* test ephemeris index valid ------------------------------------------------*/
+static int validx(const ephidx_t *idx, int n, int sat)
+{
+    return idx->key && idx->n == n && n > 0 && 0 < sat && sat <= MAXSAT;
+}
 /* select ephememeris --------------------------------------------------------*/
 static eph_t *seleph(gtime_t time, int sat, int iode, const nav_t *nav)
 {
     double t, tmax, tmin;
-    int i, j = -1;
+    int i, k, j = -1;
 
     trace(4, "seleph  : time=%s sat=%2d iode=%d\n", time_str(time, 3), sat, iode);
 
@@ -454,23 +867,39 @@ static eph_t *seleph(gtime_t time, int sat, int iode, const nav_t *nav)
     }
     tmin = tmax + 1.0;
 
-    for (i = 0; i < nav->n; i++)
+    if (validx(&nav->ieph, nav->n, sat))
     {
-        if (nav->eph[i].sat != sat)
-            continue;
-        if (iode >= 0 && nav->eph[i].iode != iode)
-            continue;
-        if ((t = fabs(timediff(nav->eph[i].toe, time))) > tmax)
-            continue;
-        if (iode >= 0)
-            return nav->eph + i;
-        if (t <= tmin)
-        {
-            j = i;
-            tmin = t;
-        } /* toe closest to time */
+        if (iode < 0)
+            j = selidx(&nav->ieph, time, sat, tmax);
+        else
+            for (i = nav->ieph.off[sat - 1]; i < nav->ieph.off[sat]; i++)
+            {
+                k = nav->ieph.key[i].i;
+                if (nav->eph[k].iode == iode && fabs(timediff(nav->eph[k].toe, time)) <= tmax && (j < 0 || k < j))
+                    j = k;
+            }
     }
-    if (iode >= 0 || j < 0)
+    else
+        for (i = 0; i < nav->n; i++)
+        {
+            if (nav->eph[i].sat != sat)
+                continue;
+            if (iode >= 0 && nav->eph[i].iode != iode)
+                continue;
+            if ((t = fabs(timediff(nav->eph[i].toe, time))) > tmax)
+                continue;
+            if (iode >= 0)
+            {
+                j = i;
+                break;
+            }
+            if (t <= tmin)
+            {
+                j = i;
+                tmin = t;
+            } /* toe closest to time */
+        }
+    if (j < 0)
     {
         trace(3, "no broadcast ephemeris: %s sat=%2d iode=%3d\n", time_str(time, 0), sat, iode);
         return NULL;
@@ -481,27 +910,43 @@ static eph_t *seleph(gtime_t time, int sat, int iode, const nav_t *nav)
 static geph_t *selgeph(gtime_t time, int sat, int iode, const nav_t *nav)
 {
     double t, tmax = MAXDTOE_GLO, tmin = tmax + 1.0;
-    int i, j = -1;
+    int i, k, j = -1;
 
     trace(4, "selgeph : time=%s sat=%2d iode=%2d\n", time_str(time, 3), sat, iode);
 
-    for (i = 0; i < nav->ng; i++)
+    if (validx(&nav->igeph, nav->ng, sat))
     {
-        if (nav->geph[i].sat != sat)
-            continue;
-        if (iode >= 0 && nav->geph[i].iode != iode)
-            continue;
-        if ((t = fabs(timediff(nav->geph[i].toe, time))) > tmax)
-            continue;
-        if (iode >= 0)
-            return nav->geph + i;
-        if (t <= tmin)
-        {
-            j = i;
-            tmin = t;
-        } /* toe closest to time */
+        if (iode < 0)
+            j = selidx(&nav->igeph, time, sat, tmax);
+        else
+            for (i = nav->igeph.off[sat - 1]; i < nav->igeph.off[sat]; i++)
+            {
+                k = nav->igeph.key[i].i;
+                if (nav->geph[k].iode == iode && fabs(timediff(nav->geph[k].toe, time)) <= tmax && (j < 0 || k < j))
+                    j = k;
+            }
     }
-    if (iode >= 0 || j < 0)
+    else
+        for (i = 0; i < nav->ng; i++)
+        {
+            if (nav->geph[i].sat != sat)
+                continue;
+            if (iode >= 0 && nav->geph[i].iode != iode)
+                continue;
+            if ((t = fabs(timediff(nav->geph[i].toe, time))) > tmax)
+                continue;
+            if (iode >= 0)
+            {
+                j = i;
+                break;
+            }
+            if (t <= tmin)
+            {
+                j = i;
+                tmin = t;
+            } /* toe closest to time */
+        }
+    if (j < 0)
     {
         trace(3, "no glonass ephemeris  : %s sat=%2d iode=%2d\n", time_str(time, 0), sat, iode);
         return NULL;
@@ -516,18 +961,21 @@ static seph_t *selseph(gtime_t time, int sat, const nav_t *nav)
 
     trace(4, "selseph : time=%s sat=%2d\n", time_str(time, 3), sat);
 
-    for (i = 0; i < nav->ns; i++)
-    {
-        if (nav->seph[i].sat != sat)
-            continue;
-        if ((t = fabs(timediff(nav->seph[i].t0, time))) > tmax)
-            continue;
-        if (t <= tmin)
+    if (validx(&nav->iseph, nav->ns, sat))
+        j = selidx(&nav->iseph, time, sat, tmax);
+    else
+        for (i = 0; i < nav->ns; i++)
         {
-            j = i;
-            tmin = t;
-        } /* toe closest to time */
-    }
+            if (nav->seph[i].sat != sat)
+                continue;
+            if ((t = fabs(timediff(nav->seph[i].t0, time))) > tmax)
+                continue;
+            if (t <= tmin)
+            {
+                j = i;
+                tmin = t;
+            } /* toe closest to time */
+        }
     if (j < 0)
     {
         trace(3, "no sbas ephemeris     : %s sat=%2d\n", time_str(time, 0), sat);
@@ -570,6 +1018,131 @@ static int ephclk(gtime_t time, gtime_t teph, int sat, const nav_t *nav, double
 
     return 1;
 }
+/* generation of navigation data ---------------------------------------------*/
+static unsigned int getnavgen(void)
+{
+#ifdef WIN32
+    return *(volatile unsigned int *)&navgen;
+#else
+    return __atomic_load_n(&navgen, __ATOMIC_ACQUIRE);
+#endif
+}
+/* search cached satellite state ---------------------------------------------*/
+static satst_t *getsatst(int sat, gtime_t time, const void *eph, const void *clk, gtime_t toe, int n, int node)
+{
+    unsigned int gen = getnavgen();
+    satst_t *p;
+    int i;
+
+    for (i = 0; i < NSATST; i++)
+    {
+        p = satst[sat - 1] + i;
+        if (p->gen == gen && p->eph == eph && p->clk == clk && p->n == n && p->node == node && p->time.time == time.time &&
+            p->time.sec == time.sec && p->toe.time == toe.time && p->toe.sec == toe.sec)
+            return p;
+    }
+    return NULL;
+}
+/* add satellite state to cache ----------------------------------------------*/
+static satst_t *putsatst(int sat, gtime_t time, const void *eph, const void *clk, gtime_t toe, int n, int node)
+{
+    satst_t *p = satst[sat - 1] + isatst[sat - 1];
+
+    isatst[sat - 1] = (isatst[sat - 1] + 1) % NSATST;
+    p->gen = getnavgen();
+    p->time = time;
+    p->eph = eph;
+    p->clk = clk;
+    p->toe = toe;
+    p->n = n;
+    p->node = node;
+    return p;
+}
+/* satellite position and clock by selected broadcast ephemeris at time ------*/
+static void ephposs1(gtime_t time, int sys, const void *eph, double *rs, double *dts, double *var)
+{
+    if (sys == SYS_GLO)
+        geph2pos(time, (const geph_t *)eph, rs, dts, var);
+    else if (sys == SYS_SBS)
+        seph2pos(time, (const seph_t *)eph, rs, dts, var);
+    else
+        eph2pos(time, (const eph_t *)eph, rs, dts, var);
+}
+/* satellite position and clock by selected broadcast ephemeris --------------*/
+static void ephposs(gtime_t time, int sys, const void *eph, int node, double *rs, double *dts, double *var)
+{
+    double rst[3], rsm[3], dtst[1], dtsm[1], tt = 1E-3;
+    int i;
+
+    ephposs1(time, sys, eph, rs, dts, var);
+    ephposs1(timeadd(time, tt), sys, eph, rst, dtst, var);
+
+    /* satellite velocity and clock drift by differential approx */
+    if (!node)
+    {
+        for (i = 0; i < 3; i++)
+            rs[i + 3] = (rst[i] - rs[i]) / tt;
+        dts[1] = (dtst[0] - dts[0]) / tt;
+        return;
+    }
+    /* central difference at interpolation nodes */
+    ephposs1(timeadd(time, -tt), sys, eph, rsm, dtsm, var);
+    for (i = 0; i < 3; i++)
+        rs[i + 3] = (rst[i] - rsm[i]) / tt / 2.0;
+    dts[1] = (dtst[0] - dtsm[0]) / tt / 2.0;
+}
+/* satellite state by broadcast ephemeris with cache -------------------------*/
+static void ephstate(gtime_t time, int sat, int sys, const void *eph, gtime_t toe, int iode, int node, double *rs,
+                     double *dts, double *var)
+{
+    satst_t *p;
+    int i;
+
+    if (!(p = getsatst(sat, time, eph, NULL, toe, iode, node)))
+    {
+        p = putsatst(sat, time, eph, NULL, toe, iode, node);
+        ephposs(time, sys, eph, node, p->rs, p->dts, &p->var);
+    }
+    for (i = 0; i < 6; i++)
+        rs[i] = p->rs[i];
+    dts[0] = p->dts[0];
+    dts[1] = p->dts[1];
+    *var = p->var;
+}
+/* satellite state interpolated between nodes by hermite polynomial ----------*/
+static void ephinterp(gtime_t time, int sat, int sys, const void *eph, gtime_t toe, int iode, double *rs,
+                      double *dts, double *var)
+{
+    gtime_t t0 = {0};
+    double r0[6], r1[6], d0[2], d1[2], s, a[4], b[4], t, h = orbint;
+    int i;
+
+    /* nodes at multiples of interpolation interval */
+    t = floor((time.time + time.sec) / h) * h;
+    t0.time = (time_t)floor(t);
+    t0.sec = t - floor(t);
+    ephstate(t0, sat, sys, eph, toe, iode, 1, r0, d0, var);
+    ephstate(timeadd(t0, h), sat, sys, eph, toe, iode, 1, r1, d1, var);
+
+    /* cubic hermite basis and its derivative */
+    s = timediff(time, t0) / h;
+    a[0] = (2.0 * s - 3.0) * s * s + 1.0;
+    a[1] = ((s - 2.0) * s + 1.0) * s * h;
+    a[2] = (3.0 - 2.0 * s) * s * s;
+    a[3] = (s - 1.0) * s * s * h;
+    b[0] = 6.0 * (s - 1.0) * s / h;
+    b[1] = (3.0 * s - 4.0) * s + 1.0;
+    b[2] = -b[0];
+    b[3] = (3.0 * s - 2.0) * s;
+
+    for (i = 0; i < 3; i++)
+    {
+        rs[i] = a[0] * r0[i] + a[1] * r0[i + 3] + a[2] * r1[i] + a[3] * r1[i + 3];
+        rs[i + 3] = b[0] * r0[i] + b[1] * r0[i + 3] + b[2] * r1[i] + b[3] * r1[i + 3];
+    }
+    dts[0] = a[0] * d0[0] + a[1] * d0[1] + a[2] * d1[0] + a[3] * d1[1];
+    dts[1] = b[0] * d0[0] + b[1] * d0[1] + b[2] * d1[0] + b[3] * d1[1];
+}
 /* satellite position and clock by broadcast ephemeris -----------------------*/
 static int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav, int iode, double *rs, double *dts, double *var,
                   int *svh)
@@ -577,8 +1150,9 @@ static int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav, int iod
     eph_t *eph;
     geph_t *geph;
     seph_t *seph;
-    double rst[3], dtst[1], tt = 1E-3;
-    int i, sys;
+    const void *p;
+    gtime_t toe;
+    int sys, n;
 
     trace(4, "ephpos  : time=%s sat=%2d iode=%d\n", time_str(time, 3), sat, iode);
 
@@ -590,41 +1164,91 @@ static int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav, int iod
     {
         if (!(eph = seleph(teph, sat, iode, nav)))
             return 0;
-
-        eph2pos(time, eph, rs, dts, var);
-        time = timeadd(time, tt);
-        eph2pos(time, eph, rst, dtst, var);
+        p = eph;
+        toe = eph->toe;
+        n = eph->iode;
         *svh = eph->svh;
     }
     else if (sys == SYS_GLO)
     {
         if (!(geph = selgeph(teph, sat, iode, nav)))
             return 0;
-        geph2pos(time, geph, rs, dts, var);
-        time = timeadd(time, tt);
-        geph2pos(time, geph, rst, dtst, var);
+        p = geph;
+        toe = geph->toe;
+        n = geph->iode;
         *svh = geph->svh;
     }
     else if (sys == SYS_SBS)
     {
         if (!(seph = selseph(teph, sat, nav)))
             return 0;
-
-        seph2pos(time, seph, rs, dts, var);
-        time = timeadd(time, tt);
-        seph2pos(time, seph, rst, dtst, var);
+        p = seph;
+        toe = seph->t0;
+        n = 0;
         *svh = seph->svh;
     }
     else
         return 0;
 
-    /* satellite velocity and clock drift by differential approx */
-    for (i = 0; i < 3; i++)
-        rs[i + 3] = (rst[i] - rs[i]) / tt;
-    dts[1] = (dtst[0] - dts[0]) / tt;
+    if (orbint > 0.0)
+        ephinterp(time, sat, sys, p, toe, n, rs, dts, var);
+    else
+        ephstate(time, sat, sys, p, toe, n, 0, rs, dts, var);
 
     return 1;
 }
+/* satellite states by broadcast ephemerides of an epoch in batch ------------*/
+static void ephposn(const gtime_t *time, gtime_t teph, const obsd_t *obs, const int *stat, int n, const nav_t *nav)
+{
+    gtime_t t[4 * MAXOBS];
+    const eph_t *e[4 * MAXOBS];
+    double rs[12 * MAXOBS] = {0}, dts[4 * MAXOBS] = {0}, var[4 * MAXOBS] = {0}, tt = 1E-3;
+    satst_t *p;
+    eph_t *eph;
+    int i, j, k, m = 0, sys, idx[2 * MAXOBS];
+
+    trace(4, "ephposn : teph=%s n=%d\n", time_str(teph, 3), n);
+
+    /* broadcast ephemerides of states not cached at time and time+tt */
+    for (i = 0; i < n; i++)
+    {
+        if (!stat[i])
+            continue;
+        sys = satsys(obs[i].sat, NULL);
+        if (sys != SYS_GPS && sys != SYS_GAL && sys != SYS_QZS && sys != SYS_CMP)
+            continue;
+        if (!(eph = seleph(teph, obs[i].sat, -1, nav)))
+            continue;
+        if (getsatst(obs[i].sat, time[i], eph, NULL, eph->toe, eph->iode, 0))
+            continue;
+        idx[m / 2] = i;
+        t[m] = time[i];
+        e[m++] = eph;
+        t[m] = timeadd(time[i], tt);
+        e[m++] = eph;
+    }
+    if (m <= 0)
+        return;
+
+    eph2posn(t, e, m, rs, dts, var);
+
+    /* satellite velocity and clock drift by differential approx as ephposs() */
+    for (j = 0; j < m / 2; j++)
+    {
+        i = idx[j];
+        if (getsatst(obs[i].sat, time[i], e[j * 2], NULL, e[j * 2]->toe, e[j * 2]->iode, 0))
+            continue;
+        p = putsatst(obs[i].sat, time[i], e[j * 2], NULL, e[j * 2]->toe, e[j * 2]->iode, 0);
+        for (k = 0; k < 3; k++)
+        {
+            p->rs[k] = rs[k + j * 6];
+            p->rs[k + 3] = (rs[k + 3 + j * 6] - rs[k + j * 6]) / tt;
+        }
+        p->dts[0] = dts[j * 2];
+        p->dts[1] = (dts[1 + j * 2] - dts[j * 2]) / tt;
+        p->var = var[1 + j * 2];
+    }
+}
 /* satellite position and clock with sbas correction -------------------------*/
 static int satpos_sbas(gtime_t time, gtime_t teph, int sat, const nav_t *nav, double *rs, double *dts, double *var,
                        int *svh)
@@ -769,6 +1393,72 @@ static int satpos_ssr(gtime_t time, gtime_t teph, int sat, const nav_t *nav, int
 
     return 1;
 }
+/* satellite position and clock by precise ephemeris with cache --------------*/
+static int precpos(gtime_t time, int sat, const nav_t *nav, double *rs, double *dts, double *var)
+{
+    gtime_t toe = {0};
+    satst_t *p;
+    int i;
+
+    if (sat <= 0 || MAXSAT < sat || !nav->peph)
+        return peph2pos(time, sat, nav, 1, rs, dts, var);
+
+    if (!(p = getsatst(sat, time, nav->peph, nav->pclk, toe, nav->ne, 0)))
+    {
+        if (!peph2pos(time, sat, nav, 1, rs, dts, var))
+            return 0;
+        p = putsatst(sat, time, nav->peph, nav->pclk, toe, nav->ne, 0);
+        for (i = 0; i < 6; i++)
+            p->rs[i] = rs[i];
+        p->dts[0] = dts[0];
+        p->dts[1] = dts[1];
+        p->var = *var;
+        return 1;
+    }
+    for (i = 0; i < 6; i++)
+        rs[i] = p->rs[i];
+    dts[0] = p->dts[0];
+    dts[1] = p->dts[1];
+    *var = p->var;
+    return 1;
+}
+/* set interpolation interval of broadcast orbit -------------------------------
+ * set interval of nodes to interpolate satellite position and clock by
+ * broadcast ephemeris
+ * args   : double tint      I   interpolation interval (s) (0:no interpolation)
+ * return : none
+ * notes  : satellite states at nodes are cached per thread and interpolated by
+ *          cubic hermite polynomial with velocity and clock drift.
+ *          with tint=0, only states of the same time and ephemeris are reused.
+ *-----------------------------------------------------------------------------*/
+extern void setorbint(double tint)
+{
+    trace(3, "setorbint: tint=%.1f\n", tint);
+
+    orbint = tint > 0.0 ? tint : 0.0;
+    updnavgen();
+}
+/* update generation of navigation data ----------------------------------------
+ * invalidate satellite states cached by all threads
+ * args   : none
+ * return : none
+ * notes  : call it after navigation data are loaded, updated or freed. cached
+ *          states are keyed by the generation, so those of ephemerides freed
+ *          and reallocated at the same address are never reused
+ *-----------------------------------------------------------------------------*/
+extern void updnavgen(void)
+{
+    unsigned int gen;
+
+#ifdef WIN32
+    gen = (unsigned int)InterlockedIncrement((volatile LONG *)&navgen);
+#else
+    gen = __atomic_add_fetch(&navgen, 1, __ATOMIC_ACQ_REL);
+#endif
+    /* skip generation of empty cache entries */
+    if (gen == 0)
+        updnavgen();
+}
 /* satellite position and clock ------------------------------------------------
  * compute satellite position, velocity and clock
  * args   : gtime_t time     I   time (gpst)
@@ -803,7 +1493,7 @@ extern int satpos(gtime_t time, gtime_t teph, int sat, int ephopt, const nav_t *
     case EPHOPT_SSRCOM:
         return satpos_ssr(time, teph, sat, nav, 1, rs, dts, var, svh);
     case EPHOPT_PREC:
-        if (!peph2pos(time, sat, nav, 1, rs, dts, var))
+        if (!precpos(time, sat, nav, rs, dts, var))
             break;
         else
             return 1;
@@ -845,7 +1535,7 @@ extern void satposs(gtime_t teph, const obsd_t *obs, int n, const nav_t *nav, in
 {
     gtime_t time[2 * MAXOBS] = {{0}};
     double dt, pr;
-    int i, j;
+    int i, j, stat[2 * MAXOBS] = {0};
 
     trace(3, "satposs : teph=%s n=%d ephopt=%d\n", time_str(teph, 3), n, ephopt);
 
@@ -878,6 +1568,17 @@ extern void satposs(gtime_t teph, const obsd_t *obs, int n, const nav_t *nav, in
             continue;
         }
         time[i] = timeadd(time[i], -dt);
+        stat[i] = 1;
+    }
+    /* kepler orbits of the epoch in batch */
+    if (ephopt == EPHOPT_BRDC && orbint <= 0.0)
+    {
+        ephposn(time, teph, obs, stat, n < 2 * MAXOBS ? n : 2 * MAXOBS, nav);
+    }
+    for (i = 0; i < n && i < 2 * MAXOBS; i++)
+    {
+        if (!stat[i])
+            continue;
 
         /* satellite position and clock at transmission time */
         if (!satpos(time[i], teph, obs[i].sat, ephopt, nav, rs + i * 6, dts + i * 2, var + i, svh + i))
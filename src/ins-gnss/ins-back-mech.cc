@@ -15,6 +15,7 @@
  * history : 2017/03/02 1.0 new
  *----------------------------------------------------------------------------*/
 #include <navlib.h>
+#include <mat3.h>
 
 #define MAXDT 60.0             /* max interval to update imu (s) */
 #define INSUPDPRE 1            /* inertial navigation equations precision */
@@ -49,7 +50,7 @@ static void updateatt(double dt, double *Cbe, const double *omgb)
     for (i = 0; i < 3; i++)
         alpha[i] = omgb[i] * dt;
     skewsym3(alpha, Ca);
-    matmul3("NN", Ca, Ca, Ca2);
+    mat3mul_nn(Ca, Ca, Ca2);
     a = norm(alpha, 3);
     if (a < 1E-8)
     {
@@ -70,8 +71,8 @@ static void updateatt(double dt, double *Cbe, const double *omgb)
     Cei[1] = sin(OMGE * dt);
     Cei[4] = cos(OMGE * dt);
     Cei[8] = 1.0;
-    matmul3("NN", Cei, Cbe, Cbep);
-    matmul3("NT", Cbep, Cbb, Cbe);
+    mat3mul_nn(Cei, Cbe, Cbep);
+    mat3mul_nt(Cbep, Cbb, Cbe);
 }
 /* backward update ins states ------------------------------------------------
  * update ins states with imu measurement data in e-frame in backward
@@ -134,19 +135,19 @@ extern int updateinsbe(const insopt_t *insopt, insstate_t *ins, const imud_t *da
     {
         a1 = (1.0 - cos(a)) / SQR(a);
         a2 = 1.0 / SQR(a) * (1.0 - sin(a) / a);
-        matmul3("NN", Ca, Ca, Ca2);
+        mat3mul_nn(Ca, Ca, Ca2);
         for (i = 0; i < 9; i++)
             Cbb[i] += a1 * Ca[i] + a2 * Ca2[i];
         skewsym3(ae, Omg);
-        matmul3("NN", Cbe, Cbb, Ca);
-        matmul3("NN", Omg, Cbe, Ca2);
+        mat3mul_nn(Cbe, Cbb, Ca);
+        mat3mul_nn(Omg, Cbe, Ca2);
         for (i = 0; i < 9; i++)
             Cbe[i] = Ca[i] - 0.5 * Ca2[i];
     }
     else
     {
         skewsym3(ae, Omg);
-        matmul3("NN", Omg, Cbe, Ca);
+        mat3mul_nn(Omg, Cbe, Ca);
         for (i = 0; i < 9; i++)
             Cbe[i] -= 0.5 * Ca[i];
     }
@@ -155,7 +156,7 @@ extern int updateinsbe(const insopt_t *insopt, insstate_t *ins, const imud_t *da
         Cbe[i] = (Cbe[i] + ins->Cbe[i]) / 2.0;
 #endif
     /* specific-force/gravity in e-frame */
-    matmul3v("N", Cbe, ins->fb, fe);
+    mat3mulv_n(Cbe, ins->fb, fe);
     if (insopt->gravityex)
     {
         pregrav(ins->re, ge); /* precious gravity model */
@@ -164,7 +165,7 @@ extern int updateinsbe(const insopt_t *insopt, insstate_t *ins, const imud_t *da
         gravity(ins->re, ge);
 
     /* update velocity/position */
-    matmul3v("N", Omge, ins->ve, cori);
+    mat3mulv_n(Omge, ins->ve, cori);
     for (i = 0; i < 3; i++)
     {
         ins->ae[i] = fe[i] + ge[i] - 2.0 * cori[i];
@@ -308,7 +309,7 @@ extern void rot2dcm(const double *rot, double *dcm)
     int i;
 
     skewsym3(rot, Sr);
-    matmul("NN", 3, 3, 3, 1.0, Sr, Sr, 0.0, Sr2);
+    mat3mul_nn(Sr, Sr, Sr2);
 
     if (rot_norm > 0)
     {
@@ -396,7 +397,7 @@ static void getqbn(const insstate_t *ins, double *qbn)
     double pos[3], Cne[9], Cbn[9];
     ecef2pos(ins->re, pos);
     ned2xyz(pos, Cne);
-    matmul3("TN", Cne, ins->Cbe, Cbn);
+    mat3mul_tn(Cne, ins->Cbe, Cbn);
     dcm2quatx(Cbn, qbn);
 }
 /* update ins states---------------------------------------------------------*/
@@ -408,8 +409,8 @@ static void update(insstate_t *ins, const double *qbn, const double *vn, const d
     matcpy(ins->Cbn, Cbn, 3, 3);
     matcpy(ins->vn, vn, 1, 3);
 
-    matmul("TN", 3, 3, 3, 1.0, Cen, Cbn, 0.0, ins->Cbe);
-    matmul("TN", 3, 1, 3, 1.0, Cen, vn, 0.0, ins->ve);
+    mat3mul_tn(Cen, Cbn, ins->Cbe);
+    mat3mulv_t(Cen, vn, ins->ve);
 
     rn[0] = acos(Cen[6]);
     rn[1] = acos(Cen[4]);
@@ -420,7 +421,7 @@ static void update(insstate_t *ins, const double *qbn, const double *vn, const d
 #if 1
     getaccl(ins->fb, ins->Cbe, ins->re, ins->ve, ins->ae);
 #else
-    matmul("TN", 3, 1, 3, 1.0, Cen, ins->an, 0.0, ins->ae);
+    mat3mulv_t(Cen, ins->an, ins->ae);
 #endif
     getvn(ins, ins->vn);
 }
@@ -521,7 +522,7 @@ extern int updateinsbn(const insopt_t *insopt, insstate_t *ins, const imud_t *da
     }
     rot2dcm(w, Cn);
     ned2xyz(rn, Cne);
-    matmul("NT", 3, 3, 3, 1.0, Cn, Cne, 0.0, Cen);
+    mat3mul_nt(Cn, Cne, Cen);
     h = rn[2] + vmid[2] * dt;
 
     update(ins, qbn, ins->vn, Cen, h);
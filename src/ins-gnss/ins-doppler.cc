@@ -340,7 +340,7 @@ static int doppfilt(insstate_t *ins, const prcopt_t *opt, const obsd_t *obs, int
         initP(irr, nrr, nx, opt->insopt.unc.rr, UNC_CLKR, P);
 
         /* ekf filter */
-        if (filter(x, P, H, v, R, nx, nv))
+        if (filter_ws(&ins->ws, x, P, H, v, R, nx, nv))
         {
             trace(2, "filter error\n");
         }
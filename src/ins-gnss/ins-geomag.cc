@@ -124,7 +124,7 @@ static int magfilt(insstate_t *ins, const insopt_t *opt, const mag_t *data)
     v = (NORMANG(magh) - NORMANG(yaw)) * D2R;
     R = SQR(VAR_MAG);
 
-    if (filter(x, P, H, &v, &R, ins->nx, 1))
+    if (filter_ws(&ins->ws, x, P, H, &v, &R, ins->nx, 1))
     { /* update */
         trace(2, "filter error\n");
         free(H);
@@ -27,6 +27,7 @@
 #define OUT_MONITOR 1        /* output solution to monitor */
 #define SOL_OUTPUT_FILE 0    /* output solution to file */
 #define DEGRADE_FACTOR 0.618 /* degrade factor to correction if combined solution is inconsistent */
+#define FWDSOL_PREC 0        /* precision of off-diagonal covariance in file (0:double,1:float) */
 
 typedef struct
 {                        /* forward ins solution data type */
@@ -37,6 +38,20 @@ typedef struct
     double *x, *P; /* forward ins solution data */
 } ins_fsol_t;
 
+typedef struct
+{                 /* forward solution index type */
+    gtime_t time; /* ins solution time */
+    long off;     /* offset of solution record in file (bytes) */
+} fsol_idx_t;
+
+typedef struct
+{                        /* forward solution index buffer type */
+    int n, nmax;         /* number and max number of index */
+    int bsize;           /* size of solution record (bytes) */
+    fsol_idx_t *data;    /* index data */
+    unsigned char *buff; /* solution record buffer */
+} fsol_idxbuf_t;
+
 /* constants/global variables -----------------------------------------------*/
 static stream_t moni = {0};    /* monitor stream */
 static stream_t frst = {0};    /* solution result file */
@@ -52,6 +67,7 @@ static int reconnect = 10000;   /* reconnect interval (ms) */
 static int week = 0;            /* GPS week */
 static char solfile[1024];      /* solution output file path */
 static FILE *fp_fwd_sol = NULL; /* foeward solution file pointer */
+static fsol_idxbuf_t fidx = {0}; /* forward solution index */
 
 /* initial ins forward solution ---------------------------------------------*/
 static void init_fsol(ins_fsol_t *fsol, const insopt_t *opt)
@@ -61,7 +77,7 @@ static void init_fsol(ins_fsol_t *fsol, const insopt_t *opt)
     fsol->time = t0;
     fsol->nx = xnX(opt);
 
-    fsol->x = mat(fsol->nx, 1);
+    fsol->x = mat(MAX(fsol->nx, 15), 1); /* {att,vel,pos,ba,bg} at least */
     fsol->P = mat(fsol->nx, fsol->nx);
 }
 /* free ins forward solution-------------------------------------------------*/
@@ -454,94 +470,202 @@ static void update_stat(const gmea_t *gm, insstate_t *ins)
         ins->gstat = SOLQ_NONE;
     }
 }
-/* add ins solutions to buffer-----------------------------------------------*/
-static int add_ins_sol(const insstate_t *ins)
+/* size of forward solution record------------------------------------------
+ * record: {time,ns,nx,stat,gstat,att,vel,pos,ba,bg,P} with P packed to upper
+ * triangle (see packcov())
+ * --------------------------------------------------------------------------*/
+static int fsol_bsize(int nx)
 {
-    double omg[3];
-    int i;
-
-    /* write solution to file in binary */
-    fwrite(&ins->time, sizeof(gtime_t), 1, fp_fwd_sol);
-    fwrite(&ins->ns, sizeof(int), 1, fp_fwd_sol);
-    fwrite(&ins->nx, sizeof(int), 1, fp_fwd_sol);
+    return sizeof(gtime_t) + 4 * sizeof(int) + 15 * sizeof(double) + sizecov(nx, FWDSOL_PREC);
+}
+/* free forward solution index-----------------------------------------------*/
+static void free_fidx(fsol_idxbuf_t *idx)
+{
+    if (idx->data)
+        free(idx->data);
+    idx->data = NULL;
+    if (idx->buff)
+        free(idx->buff);
+    idx->buff = NULL;
+    idx->n = idx->nmax = idx->bsize = 0;
+}
+/* add forward solution index------------------------------------------------*/
+static int add_fidx(fsol_idxbuf_t *idx, gtime_t time, long off)
+{
+    fsol_idx_t *data;
 
-    fwrite(&ins->stat, sizeof(int), 1, fp_fwd_sol);
-    fwrite(&ins->gstat, sizeof(int), 1, fp_fwd_sol);
+    if (idx->nmax <= idx->n)
+    {
+        idx->nmax = idx->nmax <= 0 ? 4096 : idx->nmax * 2;
+        if (!(data = (fsol_idx_t *)realloc(idx->data, sizeof(fsol_idx_t) * idx->nmax)))
+        {
+            trace(1, "add_fidx malloc error: n=%d\n", idx->nmax);
+            free_fidx(idx);
+            return 0;
+        }
+        idx->data = data;
+    }
+    idx->data[idx->n].time = time;
+    idx->data[idx->n++].off = off;
+    return 1;
+}
+/* index file path of forward solution file----------------------------------*/
+static void fidx_file(char *file)
+{
+    sprintf(file, "%s.idx", solfile);
+}
+/* write forward solution index file-----------------------------------------*/
+static int wrt_fidx(const fsol_idxbuf_t *idx)
+{
+    FILE *fp;
+    char file[1032];
+    int stat;
 
-    so3_log(ins->Cbe, omg, NULL);
-    fwrite(omg, sizeof(double), 3, fp_fwd_sol);
+    fidx_file(file);
+    if (!(fp = fopen(file, "wb")))
+    {
+        trace(2, "forward solution index file open error: %s\n", file);
+        return 0;
+    }
+    stat = fwrite(&idx->bsize, sizeof(int), 1, fp) == 1 &&
+           fwrite(&idx->n, sizeof(int), 1, fp) == 1 &&
+           fwrite(idx->data, sizeof(fsol_idx_t), idx->n, fp) == (size_t)idx->n;
+    fclose(fp);
+    return stat;
+}
+/* read forward solution index file------------------------------------------*/
+static int read_fidx(fsol_idxbuf_t *idx)
+{
+    FILE *fp;
+    char file[1032];
+    int n = 0, bsize = 0;
 
-    fwrite(ins->ve, sizeof(double), 3, fp_fwd_sol);
-    fwrite(ins->re, sizeof(double), 3, fp_fwd_sol);
-    fwrite(ins->ba, sizeof(double), 3, fp_fwd_sol);
-    fwrite(ins->bg, sizeof(double), 3, fp_fwd_sol);
+    free_fidx(idx);
 
-    for (i = 0; i < ins->nx * ins->nx; i++)
+    fidx_file(file);
+    if (!(fp = fopen(file, "rb")))
+    {
+        trace(2, "forward solution index file open error: %s\n", file);
+        return 0;
+    }
+    if (fread(&bsize, sizeof(int), 1, fp) != 1 || fread(&n, sizeof(int), 1, fp) != 1 || n <= 0 || bsize <= 0 ||
+        !(idx->data = (fsol_idx_t *)malloc(sizeof(fsol_idx_t) * n)) ||
+        !(idx->buff = (unsigned char *)malloc(bsize)))
+    {
+        fclose(fp);
+        free_fidx(idx);
+        return 0;
+    }
+    idx->n = idx->nmax = n;
+    idx->bsize = bsize;
+    if (fread(idx->data, sizeof(fsol_idx_t), n, fp) != (size_t)n)
     {
-        fwrite(&ins->P[i], sizeof(double), 1, fp_fwd_sol);
+        fclose(fp);
+        free_fidx(idx);
+        return 0;
     }
+    fclose(fp);
     return 1;
 }
-/* get forward ins solution data from file---------------------------------- */
-static int get_fwd_sol(ins_fsol_t *sol, int i, int bsize)
+/* add ins solutions to buffer-----------------------------------------------*/
+static int add_ins_sol(const insstate_t *ins)
 {
-    fread(&sol->time, sizeof(gtime_t), 1, fp_fwd_sol);
-    fread(&sol->ns, sizeof(int), 1, fp_fwd_sol);
-    fread(&sol->nx, sizeof(int), 1, fp_fwd_sol);
-
-    fread(&sol->stat, sizeof(int), 1, fp_fwd_sol);
-    fread(&sol->gstat, sizeof(int), 1, fp_fwd_sol);
+    unsigned char *p;
+    double omg[3];
+    long off;
 
-    fread(sol->x + 0, sizeof(double), 3, fp_fwd_sol);
-    fread(sol->x + 3, sizeof(double), 3, fp_fwd_sol);
-    fread(sol->x + 6, sizeof(double), 3, fp_fwd_sol);
-    fread(sol->x + 9, sizeof(double), 3, fp_fwd_sol);
-    fread(sol->x + 12, sizeof(double), 3, fp_fwd_sol);
-    for (i = 0; i < sol->nx * sol->nx; i++)
+    if (!fidx.buff)
     {
-        fread(&sol->P[i], sizeof(double), 1, fp_fwd_sol);
+        fidx.bsize = fsol_bsize(ins->nx);
+        if (!(fidx.buff = (unsigned char *)malloc(fidx.bsize)))
+            return 0;
     }
-    fseek(fp_fwd_sol, -bsize, SEEK_CUR);
+    /* pack solution record */
+    p = fidx.buff;
+    memcpy(p, &ins->time, sizeof(gtime_t));
+    p += sizeof(gtime_t);
+    memcpy(p, &ins->ns, sizeof(int));
+    p += sizeof(int);
+    memcpy(p, &ins->nx, sizeof(int));
+    p += sizeof(int);
+    memcpy(p, &ins->stat, sizeof(int));
+    p += sizeof(int);
+    memcpy(p, &ins->gstat, sizeof(int));
+    p += sizeof(int);
+
+    so3_log(ins->Cbe, omg, NULL);
+    memcpy(p, omg, sizeof(double) * 3);
+    p += sizeof(double) * 3;
+    memcpy(p, ins->ve, sizeof(double) * 3);
+    p += sizeof(double) * 3;
+    memcpy(p, ins->re, sizeof(double) * 3);
+    p += sizeof(double) * 3;
+    memcpy(p, ins->ba, sizeof(double) * 3);
+    p += sizeof(double) * 3;
+    memcpy(p, ins->bg, sizeof(double) * 3);
+    p += sizeof(double) * 3;
+    packcov(ins->P, ins->nx, FWDSOL_PREC, p);
+
+    /* write solution to file in binary */
+    off = ftell(fp_fwd_sol);
+    if (fwrite(fidx.buff, fidx.bsize, 1, fp_fwd_sol) != 1)
+        return 0;
+    return add_fidx(&fidx, ins->time, off);
 }
-/* get solution time from forward solution file -----------------------------*/
-static int get_time_fsol(FILE *fp_sol, gtime_t *time)
+/* get forward ins solution data from file---------------------------------- */
+static int get_fwd_sol(ins_fsol_t *sol, long off)
 {
-    gtime_t t0 = {0};
-    if (!fread(time, sizeof(gtime_t), 1, fp_sol))
-    {
-        *time = t0;
+    const unsigned char *p = fidx.buff;
+    int nx;
+
+    if (fseek(fp_fwd_sol, off, SEEK_SET) || fread(fidx.buff, fidx.bsize, 1, fp_fwd_sol) != 1)
         return 0;
-    }
-    fseek(fp_sol, -sizeof(gtime_t), SEEK_CUR);
+
+    memcpy(&nx, p + sizeof(gtime_t) + sizeof(int), sizeof(int));
+    if (nx != sol->nx || fsol_bsize(nx) != fidx.bsize)
+        return 0;
+
+    /* unpack solution record */
+    memcpy(&sol->time, p, sizeof(gtime_t));
+    p += sizeof(gtime_t);
+    memcpy(&sol->ns, p, sizeof(int));
+    p += sizeof(int) * 2;
+    memcpy(&sol->stat, p, sizeof(int));
+    p += sizeof(int);
+    memcpy(&sol->gstat, p, sizeof(int));
+    p += sizeof(int);
+    memcpy(sol->x, p, sizeof(double) * 15);
+    p += sizeof(double) * 15;
+    unpackcov(p, nx, FWDSOL_PREC, sol->P);
     return 1;
 }
 /* search forward ins solution by time---------------------------------------*/
-static int search_fsol(int bsize, gtime_t time, ins_fsol_t *sol)
+static int search_fsol(gtime_t time, ins_fsol_t *sol)
 {
-    gtime_t ts, t0 = {0};
-    int i = 0;
+    gtime_t t0 = {0};
+    int i = 0, j = fidx.n - 1, k;
 
     sol->time = t0;
-    while (true)
-    {
-        if (i == 1 && feof(fp_fwd_sol))
-            break;
-        else if (i == -1 && !ftell(fp_fwd_sol))
-            break;
-
-        fseek(fp_fwd_sol, (i == 0 ? -1 : i) * bsize, SEEK_CUR);
+    if (fidx.n <= 0)
+        return 0;
 
-        if (!get_time_fsol(fp_fwd_sol, &ts))
-            continue;
-        if (fabs(timediff(ts, time) <= DTTOL))
-        {
-            get_fwd_sol(sol, i, bsize);
-            break;
-        }
-        if (timediff(ts, time) > 0.0)
-            i = 1;
-        if (timediff(ts, time) < 0.0)
-            i = -1;
+    /* binary search of closest forward solution */
+    while (i < j)
+    {
+        k = (i + j) / 2;
+        if (timediff(fidx.data[k].time, time) < 0.0)
+            i = k + 1;
+        else
+            j = k;
+    }
+    if (i > 0 && fabs(timediff(fidx.data[i - 1].time, time)) < fabs(timediff(fidx.data[i].time, time)))
+        i--;
+    if (fabs(timediff(fidx.data[i].time, time)) > DTTOL)
+        return 0;
+    if (!get_fwd_sol(sol, fidx.data[i].off))
+    {
+        sol->time = t0;
+        return 0;
     }
     return sol->time.time > 0;
 }
@@ -640,6 +764,7 @@ static void copy_ins_state(const insstate_t *pins, insstate_t *inss)
     inss->Pb = inst.Pb;
     inss->F = inst.F;
     inss->P0 = inst.P0;
+    inss->ws = inst.ws;
 
     inss->rtkp = inst.rtkp;
     inss->gmeas.data = inst.gmeas.data;
@@ -660,7 +785,6 @@ static void copy_ins_state(const insstate_t *pins, insstate_t *inss)
 /* combine forward/backward solutions  --------------------------------------*/
 static int combres(insstate_t *ins, const insopt_t *opt, insstate_t *inss)
 {
-    static int bszie = sizeof(gtime_t) + 4 * sizeof(int) + (15 + ins->nx * ins->nx) * sizeof(double);
     ins_fsol_t fsol = {0};
     double *dx, omg[3], fCbe[9], dCbe[9], *Ps, *Pf, *Pb, *dxs, factor = 0.9999;
     int i, nx = ins->nx;
@@ -671,7 +795,7 @@ static int combres(insstate_t *ins, const insopt_t *opt, insstate_t *inss)
     return 1;
 #endif
     init_fsol(&fsol, opt);
-    if (!search_fsol(bszie, ins->time, &fsol))
+    if (!search_fsol(ins->time, &fsol))
     {
         fprintf(stderr, "%s: combine forward/backward fail\n", time_str(ins->time, 4));
         free_fsol(&fsol);
@@ -784,9 +908,9 @@ extern void set_fwdtmp_file(const char *file)
 /* open forward solution binary file-----------------------------------------*/
 static int open_fwdsol()
 {
+    if (!read_fidx(&fidx))
+        return 1;
     fp_fwd_sol = fopen(solfile, "rb");
-    if (fp_fwd_sol)
-        fseek(fp_fwd_sol, 0, SEEK_END);
     return fp_fwd_sol == NULL;
 }
 /* loosely coupled filter of smoother----------------------------------------
@@ -891,7 +1015,15 @@ static int fbfilt(const imu_t *imu, const gsof_data_t *pos, const prcopt_t *popt
         n++;
     }
 exit:
-    fclose(fp_fwd_sol);
+    /* write forward solution index */
+    if (type == 0 && !wrt_fidx(&fidx))
+    {
+        trace(2, "write forward solution index fail\n");
+        n = 0;
+    }
+    free_fidx(&fidx);
+    if (fp_fwd_sol)
+        fclose(fp_fwd_sol);
     fp_fwd_sol = NULL;
     rtkfree(&rtks);
     free(imuz);
@@ -938,6 +1070,8 @@ extern int lcfbsm(const imu_t *imu, const gsof_data_t *pos, const prcopt_t *popt
     /* close monitor/file */
     if (fp_fwd_sol)
         fclose(fp_fwd_sol);
+    fp_fwd_sol = NULL;
+    free_fidx(&fidx);
     if (port)
         close_moni(&moni);
     if (file)
@@ -14,6 +14,8 @@
  * history : 2018/09/17 1.0 new
  *----------------------------------------------------------------------------*/
 #include <navlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 /* constants-----------------------------------------------------------------*/
 #define MAXTIMEDIFF 3.0      /* max time difference for RTS smoother */
@@ -26,6 +28,9 @@
 #define OUT_MONITOR 1        /* output solution to monitor */
 #define SOL_OUTPUT_FILE 0    /* output solution to file */
 #define FORWARD_IN_MEMO 0    /* forward solution save in memory, otherwise in file */
+#define NFWDSOL 1024         /* initial number of epochs of forward solution store */
+#define NFWDWIN 256          /* epochs of read-ahead window for backward pass */
+#define FWDSOL_PREC 0        /* precision of off-diagonal covariance in store (0:double,1:float) */
 
 typedef struct
 {                        /* RTS ins solution data type */
@@ -48,19 +53,57 @@ typedef struct
 } ins_sol_t;
 
 typedef struct
-{                    /* ins solution buffer type */
-    int n, nmax;     /* number and max number of solutions */
-    ins_sol_t *data; /* ins solution data */
+{                        /* ins solution buffer type */
+    int n, nmax;         /* number and max number of solutions */
+    int nx, nb;          /* number of error states/coupled rows of transition matrix */
+    size_t rsize;        /* size of solution record (bytes) */
+    int fd;              /* file descriptor of store (-1: in memory) */
+    unsigned char *data; /* mapped solution records {ins_sol_t,Pc,Pp,F,...} */
 } ins_solbuf_t;
 
+typedef struct
+{                           /* forward filter type */
+    const imu_t *imu;       /* imu measurement data */
+    const gsof_data_t *pos; /* position measurement data */
+    const prcopt_t *popt;   /* processing options */
+    const solopt_t *solopt; /* solution options */
+    rtk_t *rtk;             /* rtk control/result */
+    int init, ws;           /* initialization flag/window size of static detect */
+    imud_t *imuz;           /* imu data for static detect */
+    gmea_t gmea;            /* gnss measurement of precious epoch */
+} fwd_filt_t;
+
+typedef struct
+{                           /* forward filter checkpoint type */
+    int iimu, ipos;         /* index of imu/position measurement data */
+    int week, nhcc;         /* GPS week/counter of non-holonomic constraint */
+    gmea_t gmea;            /* gnss measurement of precious epoch */
+    int ngmea;              /* number of gnss measurements of precious epochs */
+    gmea_t gmeas[NPOS + 1]; /* gnss measurements of precious epochs (ins->gmeas) */
+    insstate_t ins;         /* ins states (matrices in data) */
+    unsigned char *data;    /* {imuz,x,xa,P,Pa} (P/Pa packed by packcov()) */
+} fwd_chkpnt_t;
+
+typedef struct
+{                       /* forward filter checkpoint buffer type */
+    int n, nmax;        /* number and max number of checkpoints */
+    int k;              /* epochs between checkpoints (0: store every epoch) */
+    int nepoch;         /* number of epochs of forward solutions */
+    int iseg;           /* index of checkpoint of segment in store (-1: none) */
+    size_t csize;       /* size of checkpoint data (bytes) */
+    fwd_chkpnt_t *data; /* checkpoints */
+} fwd_chkbuf_t;
+
 /* constants/global variables -----------------------------------------------*/
 static stream_t moni = {0};       /* monitor stream */
 static stream_t frst = {0};       /* solution result file */
 static prcopt_t prcopt = {0};     /* processing options */
 static solopt_t solopt = {0};     /* solution options */
 static filopt_t filopt = {""};    /* file options */
-static ins_solbuf_t insbuf = {0}; /* ins solution buffer */
+static ins_solbuf_t insbuf = {0, 0, 0, 0, 0, -1}; /* ins solution buffer */
 static ins_sol_t insol = {0};     /* ins solution data for temporary savings */
+static fwd_chkbuf_t fchk = {0};   /* forward filter checkpoints */
+static double memlimit = 0.0;     /* memory limit of forward solutions (MB) (0: no limit) */
 
 static int ipos = 0;            /* current gsof message index */
 static int iimu = 0;            /* current imu measurement data */
@@ -68,8 +111,8 @@ static int keepalive = 0;       /* keep alive flag */
 static int timeout = 10000;     /* timeout time (ms) */
 static int reconnect = 10000;   /* reconnect interval (ms) */
 static int week = 0;            /* GPS week */
+static int nhcc = 0;            /* counter of non-holonomic constraint */
 static char solfile[1024];      /* solution output file path */
-static FILE *fp_fwd_sol = NULL; /* foeward solution file pointer */
 
 /* adjust imu measurement time ----------------------------------------------*/
 static void adj_imutime(imud_t *imu, const prcopt_t *opt)
@@ -257,7 +300,7 @@ static int init_ins(const imud_t *imu, const gsof_t *pos, const insopt_t *iopt,
 /* motion constraint for ins states update-----------------------------------*/
 static void motion(const insopt_t *opt, imud_t *imuz, insstate_t *ins, imud_t *imu, int ws)
 {
-    static int i, nc = 0, zf = 0;
+    static int i, zf = 0;
     double pos[3];
 
     trace(3, "motion:\n");
@@ -268,7 +311,7 @@ static void motion(const insopt_t *opt, imud_t *imuz, insstate_t *ins, imud_t *i
     imuz[i] = *imu;
 
     /* non-holonomic constraint */
-    if (opt->nhc && (nc++ > opt->nhz ? nc = 0, true : false))
+    if (opt->nhc && (nhcc++ > opt->nhz ? nhcc = 0, true : false))
     {
         nhc(ins, opt, imu);
     }
@@ -341,10 +384,6 @@ static int open_solfile(const char *file)
     trace(3, "open_solfile: file=%s\n", file);
     if (!stropen(&frst, STR_FILE, STR_MODE_W, file))
         return 0;
-#if !FORWARD_IN_MEMO
-    if (!(fp_fwd_sol = fopen(solfile, "wb")))
-        return 0;
-#endif
     return 1;
 }
 /* write solution header to output stream ------------------------------------*/
@@ -365,7 +404,9 @@ static void adj_bcksol_time(rtk_t *rtk)
     dt = timediff(out_time, rtk->sol.time);
     rtk->sol.time = timeadd(out_time, dt);
 }
-/* write solution status output stream ---------------------------------------*/
+/* write solution status output stream ----------------------------------------
+ * type: 0 (forward), 1 (backward), 2 (replay of forward, no output)
+ * --------------------------------------------------------------------------*/
 static int wrt_solution(rtk_t *rtk, const solopt_t *solopt, int type)
 {
     unsigned char buff[1024];
@@ -378,7 +419,7 @@ static int wrt_solution(rtk_t *rtk, const solopt_t *solopt, int type)
 #if SOL_OUTPUT_FILE
     /* output solution to file */
     n = outsols(buff, &rtk->sol, rtk->rb, solopt, &rtk->ins, &rtk->opt.insopt, 0);
-    if (frst.port)
+    if (frst.port && type != 2)
     {
         strwrite(&frst, buff, n);
     }
@@ -400,7 +441,7 @@ static int wrt_solution(rtk_t *rtk, const solopt_t *solopt, int type)
             adj_bcksol_time(rtk);
         }
         n = outsols(buff, &rtk->sol, rtk->rb, solopt, &rtk->ins, &rtk->opt.insopt, 1);
-        if (c++ > OUTSOLFRQ)
+        if (type != 2 && c++ > OUTSOLFRQ)
         {
             strwrite(&moni, buff, n);
             c = 0;
@@ -436,6 +477,7 @@ extern void freeins(insstate_t *ins)
     if (ins->F)
         free(ins->F);
     ins->F = NULL;
+    freefiltws(&ins->ws);
     if (ins->gmeas.data)
         free(ins->gmeas.data);
     ins->gmeas.data = NULL;
@@ -521,57 +563,106 @@ extern int bckup_ins_info(insstate_t *ins, const insopt_t *opt, int type)
     trace(3, "bckup_ins_info:\n");
     torts(&insol, ins, opt, type);
 }
-/* write forward solution to file in binary----------------------------------*/
-static int wrt_fwdsol_bin(const ins_sol_t *data)
+/* size of record of forward solution store----------------------------------*/
+static size_t fwdsol_rsize(int nx, int nb)
 {
-    int i;
-    fwrite(data, sizeof(ins_sol_t), 1, fp_fwd_sol);
+    size_t size = sizeof(ins_sol_t) + sizecov(nx, FWDSOL_PREC) * 2 + sizephi(nx, nb);
+    return (size + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+}
+/* open forward solution store----------------------------------------------
+ * records of forward solution are fixed-size {ins_sol_t,Pc,Pp,F} blocks mapped
+ * from the temporary file (or anonymous memory if FORWARD_IN_MEMO), so any
+ * epoch is addressed directly by its index
+ * args:  ins_solbuf_t *buf  IO  ins solution buffer
+ *        int nx             I   number of error states
+ *        int nb             I   number of coupled rows of transition matrix
+ *        int memo           I   store in memory (0: by FORWARD_IN_MEMO)
+ * return: 1 (ok) or 0 (fail)
+ * notes: Pc/Pp are packed to upper triangle (see packcov()) and F to its
+ *        coupled rows and diagonal (see packphi())
+ * --------------------------------------------------------------------------*/
+static int open_fwdsol(ins_solbuf_t *buf, int nx, int nb, int memo)
+{
+    trace(3, "open_fwdsol: nx=%d nb=%d memo=%d\n", nx, nb, memo);
+
+    buf->n = buf->nmax = 0;
+    buf->nx = nx;
+    buf->nb = MIN(nb, nx);
+    buf->rsize = fwdsol_rsize(nx, buf->nb);
+    buf->data = NULL;
+    buf->fd = -1;
+#if !FORWARD_IN_MEMO
+    if (!memo && (buf->fd = open(solfile, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+        trace(2, "forward solution file open error: %s\n", solfile);
+        return 0;
+    }
+#endif
+    return 1;
+}
+/* close forward solution store----------------------------------------------*/
+static void close_fwdsol(ins_solbuf_t *buf)
+{
+    trace(3, "close_fwdsol: n=%d\n", buf->n);
+
+    if (buf->data)
+        munmap(buf->data, buf->rsize * buf->nmax);
+    if (buf->fd >= 0)
+        close(buf->fd);
+    buf->data = NULL;
+    buf->fd = -1;
+    buf->nmax = 0;
+}
+/* extend capacity of forward solution store---------------------------------*/
+static int grow_fwdsol(ins_solbuf_t *buf, int nmax)
+{
+    void *p;
+    size_t size = buf->rsize * nmax;
 
-    for (i = 0; i < data->nx * data->nx; i++)
+    if (buf->fd >= 0 && ftruncate(buf->fd, (off_t)size) < 0)
+    {
+        trace(1, "grow_fwdsol: file extend error: n=%d\n", nmax);
+        return 0;
+    }
+    if (!buf->data)
     {
-        fwrite(&data->Pc[i], sizeof(double), 1, fp_fwd_sol);
-        fwrite(&data->Pp[i], sizeof(double), 1, fp_fwd_sol);
-        fwrite(&data->F[i], sizeof(double), 1, fp_fwd_sol);
+        p = mmap(NULL, size, PROT_READ | PROT_WRITE, buf->fd >= 0 ? MAP_SHARED : MAP_PRIVATE | MAP_ANONYMOUS,
+                 buf->fd, 0);
     }
+    else
+        p = mremap(buf->data, buf->rsize * buf->nmax, size, MREMAP_MAYMOVE);
+    if (p == MAP_FAILED)
+    {
+        trace(1, "grow_fwdsol: map error: n=%d\n", nmax);
+        return 0;
+    }
+    buf->data = (unsigned char *)p;
+    buf->nmax = nmax;
     return 1;
 }
+/* pointer to record of forward solution store-------------------------------*/
+static ins_sol_t *fwdsol_rec(const ins_solbuf_t *buf, int i)
+{
+    return (ins_sol_t *)(buf->data + buf->rsize * i);
+}
 /* add ins solutions to buffer-----------------------------------------------*/
 static int add_ins_sol(ins_solbuf_t *buf, const ins_sol_t *data)
 {
-#if FORWARD_IN_MEMO
-    int i;
     ins_sol_t *pins;
-    if (data->time.time == 0)
+    unsigned char *p;
+
+    if (data->time.time == 0 || data->nx != buf->nx)
+        return 0;
+    if (buf->nmax <= buf->n && !grow_fwdsol(buf, buf->nmax <= 0 ? NFWDSOL : buf->nmax * 2))
         return 0;
-    if (buf->nmax <= buf->n)
-    {
-        buf->nmax += 1024;
-        if (!(pins = (ins_sol_t *)realloc(buf->data, sizeof(ins_sol_t) * buf->nmax)))
-        {
-            trace(1, "add_ins_sol malloc error: n=%d\n", buf->nmax);
-            for (i = 0; i < buf->n; i++)
-                free_insol(buf->data + i);
-            return 0;
-        }
-        buf->data = pins;
-    }
-    pins = &buf->data[buf->n++];
-    *pins = *data;
 
-    pins->Ps = zeros(data->nx, data->nx);
-    pins->Pp = zeros(data->nx, data->nx);
-    pins->Pc = zeros(data->nx, data->nx);
-    pins->F = eye(data->nx);
+    pins = fwdsol_rec(buf, buf->n++);
+    *pins = *data;
 
-    matcpy(pins->Pp, data->Pp, data->nx, data->nx);
-    matcpy(pins->Ps, data->Ps, data->nx, data->nx);
-    matcpy(pins->Pc, data->Pc, data->nx, data->nx);
-    matcpy(pins->F, data->F, data->nx, data->nx);
-#else
-    /* write solution to file in binary */
-    wrt_fwdsol_bin(data);
-    insbuf.n++;
-#endif
+    p = (unsigned char *)(pins + 1);
+    p += packcov(data->Pc, buf->nx, FWDSOL_PREC, p);
+    p += packcov(data->Pp, buf->nx, FWDSOL_PREC, p);
+    packphi(data->F, buf->nx, buf->nb, p);
     return 1;
 }
 /* output solution------------------------------------------------------------*/
@@ -589,104 +680,281 @@ static void out_stat(const gmea_t *gm, insstate_t *ins)
         ins->gstat = SOLQ_NONE;
     }
 }
-/* free forward/backward solution--------------------------------------------*/
-static void free_fbsol(ins_solbuf_t *insbuf)
+/* free forward filter checkpoints-------------------------------------------*/
+static void free_chkpnt(fwd_chkbuf_t *chk)
 {
-#if FORWARD_IN_MEMO
     int i;
-    for (i = 0; i < insbuf->n; i++)
+
+    for (i = 0; i < chk->n; i++)
+        free(chk->data[i].data);
+    if (chk->data)
+        free(chk->data);
+    chk->data = NULL;
+    chk->n = chk->nmax = 0;
+    chk->iseg = -1;
+}
+/* interval of forward filter checkpoints------------------------------------
+ * square-root checkpointing: the forward pass keeps the filter state every k
+ * epochs and the backward pass recomputes one segment of k epochs at a time
+ * from its checkpoint. memory is about n/k*csize+k*rsize, which is minimum at
+ * k=sqrt(n*csize/rsize), and the recompute overhead is one forward pass
+ * args:  size_t rsize      I   size of forward solution record (bytes)
+ *        size_t csize      I   size of checkpoint (bytes)
+ *        int    n          I   max number of epochs
+ * return: epochs between checkpoints (0: store every epoch)
+ * --------------------------------------------------------------------------*/
+static int chkpnt_intv(size_t rsize, size_t csize, int n)
+{
+    double mem = memlimit * 1048576.0;
+    int k;
+
+    if (mem <= 0.0 || n <= 0 || (double)rsize * n <= mem)
+        return 0;
+    k = (int)ceil(sqrt((double)n * csize / rsize));
+
+    if ((double)(n / k + 1) * csize + (double)k * rsize > mem)
     {
-        free_insol(&insbuf->data[i]);
+        trace(2, "memory limit of forward solutions too small: limit=%.1fMB\n", memlimit);
     }
-#endif
+    trace(3, "chkpnt_intv: n=%d k=%d\n", n, k);
+    return k;
 }
-/* forward filter of rts-----------------------------------------------------
- * args:    imu_t *imu        I  imu measurement data
- *          gsof_data_t *pos  I  position measurement data
- *          insopt_t *opt     I  ins options
- * return:  number of epochs
+/* save forward filter checkpoint--------------------------------------------
+ * checkpoint of segment nepoch/k is saved (overwritten) until its first epoch
+ * is added to the store
+ * --------------------------------------------------------------------------*/
+static int save_chkpnt(fwd_chkbuf_t *chk, const fwd_filt_t *fwd, const insstate_t *ins)
+{
+    fwd_chkpnt_t *c, *data;
+    unsigned char *p;
+    int i = chk->nepoch / chk->k, nx = ins->nx;
+
+    if (i >= chk->n)
+    {
+        if (chk->nmax <= chk->n)
+        {
+            chk->nmax = chk->nmax <= 0 ? 64 : chk->nmax * 2;
+            if (!(data = (fwd_chkpnt_t *)realloc(chk->data, sizeof(fwd_chkpnt_t) * chk->nmax)))
+            {
+                trace(1, "save_chkpnt: malloc error: n=%d\n", chk->nmax);
+                return 0;
+            }
+            chk->data = data;
+        }
+        if (!(chk->data[chk->n].data = (unsigned char *)malloc(chk->csize)))
+        {
+            trace(1, "save_chkpnt: malloc error: size=%d\n", (int)chk->csize);
+            return 0;
+        }
+        i = chk->n++;
+    }
+    c = chk->data + i;
+    c->iimu = iimu;
+    c->ipos = ipos;
+    c->week = week;
+    c->nhcc = nhcc;
+    c->gmea = fwd->gmea;
+    c->ins = *ins;
+    c->ngmea = MIN(ins->gmeas.n, NPOS + 1);
+    for (i = 0; i < c->ngmea; i++)
+        c->gmeas[i] = ins->gmeas.data[i];
+
+    p = c->data;
+    memcpy(p, fwd->imuz, sizeof(imud_t) * fwd->ws);
+    p += sizeof(imud_t) * fwd->ws;
+    memcpy(p, ins->x, sizeof(double) * nx);
+    p += sizeof(double) * nx;
+    memcpy(p, ins->xa, sizeof(double) * nx);
+    p += sizeof(double) * nx;
+    p += packcov(ins->P, nx, 0, p);
+    packcov(ins->Pa, nx, 0, p);
+    return 1;
+}
+/* restore forward filter checkpoint-----------------------------------------*/
+static void load_chkpnt(const fwd_chkpnt_t *c, fwd_filt_t *fwd, insstate_t *ins)
+{
+    insstate_t inst = *ins;
+    const unsigned char *p = c->data;
+    int i, nx = ins->nx;
+
+    iimu = c->iimu;
+    ipos = c->ipos;
+    week = c->week;
+    nhcc = c->nhcc;
+    fwd->gmea = c->gmea;
+    fwd->init = 1;
+
+    *ins = c->ins;
+    ins->x = inst.x;
+    ins->P = inst.P;
+    ins->xa = inst.xa;
+    ins->Pa = inst.Pa;
+    ins->xb = inst.xb;
+    ins->Pb = inst.Pb;
+    ins->F = inst.F;
+    ins->P0 = inst.P0;
+    ins->ws = inst.ws;
+    ins->rtkp = inst.rtkp;
+    ins->gmeas = inst.gmeas;
+    ins->gmeas.n = 0;
+    for (i = 0; i < c->ngmea; i++)
+        addgmea(&ins->gmeas, c->gmeas + i);
+
+    memcpy(fwd->imuz, p, sizeof(imud_t) * fwd->ws);
+    p += sizeof(imud_t) * fwd->ws;
+    memcpy(ins->x, p, sizeof(double) * nx);
+    p += sizeof(double) * nx;
+    memcpy(ins->xa, p, sizeof(double) * nx);
+    p += sizeof(double) * nx;
+    p += unpackcov(p, nx, 0, ins->P);
+    unpackcov(p, nx, 0, ins->Pa);
+}
+/* forward filter epoch of rts-----------------------------------------------
+ * args:    fwd_filt_t *fwd   IO forward filter
+ *          int type          I  solution output type (see wrt_solution())
+ * return:  -1 (end of data), 0 (no solution added) or 1 (solution added)
  *---------------------------------------------------------------------------*/
-static int fwdfilt(const imu_t *imu, const gsof_data_t *pos, const prcopt_t *popt, const solopt_t *solopt, rtk_t *rtk)
+static int fwdstep(fwd_filt_t *fwd, int type)
 {
-    imud_t imus = {0}, *imuz = NULL;
+    imud_t imus = {0};
     gsof_t poss = {0};
-    gmea_t gmea = {0};
+    rtk_t *rtk = fwd->rtk;
     insstate_t *ins = &rtk->ins;
     const insopt_t *iopt = &rtk->opt.insopt;
-    int ws, init = 0;
-
-    trace(3, "fwdfilt: ni=%d  np=%d\n", imu->n, pos->n);
 
-    /* static detect window size */
-    ws = iopt->zvopt.ws <= 0 ? 5 : iopt->zvopt.ws;
-    imuz = (imud_t *)malloc(sizeof(imud_t) * ws);
+    if (!inputimu(fwd->imu, &imus, fwd->popt, fwd->imuz, fwd->ws))
+        return -1;
 
-    /* rtk init. */
-    rtkinit(rtk, popt);
-
-    /* initial ins solution temporary */
-    init_insol(&insol, rtk->ins.nx);
-
-    while (inputimu(imu, &imus, popt, imuz, ws))
+    if (inputpos(fwd->pos, &poss, imus.time, fwd->popt))
     {
-        if (inputpos(pos, &poss, imus.time, popt))
-        {
 
-            if (!gsof2gnss(&poss, &gmea) || outagegsof(popt, &poss))
-                continue;
-            if (!init)
-            {
-                /* initialization */
-                if (!(init = init_ins(&imus, &poss, iopt, ins)))
-                    continue;
-            }
-            else
-            {
-                /* coupled. */
-                lcigpos(iopt, &imus, ins, &gmea, INSUPD_MEAS);
-            }
-        }
-        else if (init == 1)
+        if (!gsof2gnss(&poss, &fwd->gmea) || outagegsof(fwd->popt, &poss))
+            return 0;
+        if (!fwd->init)
         {
-            /* ins mech. */
-            lcigpos(iopt, &imus, ins, NULL, INSUPD_TIME);
+            /* initialization */
+            if (!(fwd->init = init_ins(&imus, &poss, iopt, ins)))
+                return 0;
         }
         else
-            continue;
-
-        /* motion constraint update */
-        motion(iopt, imuz, ins, &imus, ws);
-
-        /* odometry velocity aid */
-        if (iopt->odo)
         {
-            odo(iopt, &imus, &imus.odo, ins);
+            /* coupled. */
+            lcigpos(iopt, &imus, ins, &fwd->gmea, INSUPD_MEAS);
         }
-        /* sol. status */
-        out_stat(&gmea, ins);
+    }
+    else if (fwd->init == 1)
+    {
+        /* ins mech. */
+        lcigpos(iopt, &imus, ins, NULL, INSUPD_TIME);
+    }
+    else
+        return 0;
 
-        /* solution. */
-        ins2sol(&rtk->ins, iopt, &rtk->sol);
+    /* motion constraint update */
+    motion(iopt, fwd->imuz, ins, &imus, fwd->ws);
+
+    /* odometry velocity aid */
+    if (iopt->odo)
+    {
+        odo(iopt, &imus, &imus.odo, ins);
+    }
+    /* sol. status */
+    out_stat(&fwd->gmea, ins);
+
+    /* solution. */
+    ins2sol(&rtk->ins, iopt, &rtk->sol);
 
 #if OUT_MONITOR
-        /* write solution */
-        if (!wrt_solution(rtk, solopt, 0))
-            continue;
+    /* write solution */
+    if (!wrt_solution(rtk, fwd->solopt, type))
+        return 0;
 #endif
-        /* ins solution add. */
-        if (!add_ins_sol(&insbuf, &insol))
-        {
-            trace(2, "add ins solution fail\n");
+    /* ins solution add. */
+    if (!add_ins_sol(&insbuf, &insol))
+    {
+        trace(2, "add ins solution fail\n");
+        return 0;
+    }
+    return 1;
+}
+/* forward filter of rts-----------------------------------------------------
+ * args:    fwd_filt_t *fwd   IO forward filter
+ * return:  1 (ok) or 0 (fail)
+ * notes:   if memory limit is set (see set_rts_memlimit()) and the forward
+ *          solutions exceed it, only checkpoints are kept (see chkpnt_intv())
+ *---------------------------------------------------------------------------*/
+static int fwdfilt(fwd_filt_t *fwd)
+{
+    rtk_t *rtk = fwd->rtk;
+    const insopt_t *iopt = &rtk->opt.insopt;
+    int stat, nx, nb;
+
+    trace(3, "fwdfilt: ni=%d  np=%d\n", fwd->imu->n, fwd->pos->n);
+
+    /* static detect window size */
+    fwd->ws = iopt->zvopt.ws <= 0 ? 5 : iopt->zvopt.ws;
+    fwd->imuz = (imud_t *)malloc(sizeof(imud_t) * fwd->ws);
+    fwd->init = 0;
+
+    /* rtk init. */
+    rtkinit(rtk, fwd->popt);
+    nx = rtk->ins.nx;
+    nb = xnA(iopt) + xnV(iopt) + xnP(iopt);
+
+    /* checkpoint interval by memory limit */
+    fchk.n = fchk.nepoch = 0;
+    fchk.iseg = -1;
+    fchk.csize = sizeof(imud_t) * fwd->ws + sizeof(double) * nx * 2 + sizecov(nx, 0) * 2;
+    fchk.k = chkpnt_intv(fwdsol_rsize(nx, nb), sizeof(fwd_chkpnt_t) + fchk.csize, fwd->imu->n);
+
+    /* open forward solution store */
+    if (!open_fwdsol(&insbuf, nx, nb, fchk.k > 0) || (fchk.k > 0 && !grow_fwdsol(&insbuf, fchk.k)))
+    {
+        return 0;
+    }
+    /* initial ins solution temporary */
+    init_insol(&insol, nx);
+
+    while (1)
+    {
+        /* save checkpoint before first epoch of segment */
+        if (fchk.k > 0 && fwd->init && insbuf.n == 0 && !save_chkpnt(&fchk, fwd, &rtk->ins))
+            break;
+
+        if ((stat = fwdstep(fwd, 0)) < 0)
+            break;
+        if (!stat)
             continue;
-        }
+        fchk.nepoch++;
+
+        /* segment recomputed in backward pass */
+        if (fchk.k > 0 && insbuf.n >= fchk.k)
+            insbuf.n = 0;
     }
-#if !FORWARD_IN_MEMO
-    fclose(fp_fwd_sol);
-    fp_fwd_sol = NULL;
-#endif
-    free_insol(&insol);
-    free(imuz);
-    return insbuf.n > 1;
+    trace(3, "fwdfilt: nepoch=%d nchk=%d k=%d\n", fchk.nepoch, fchk.n, fchk.k);
+    return fchk.nepoch > 1;
+}
+/* recompute forward solutions of segment from its checkpoint----------------*/
+static int replay_seg(fwd_filt_t *fwd, int iseg)
+{
+    int n;
+
+    trace(3, "replay_seg: iseg=%d\n", iseg);
+
+    if (iseg < 0 || iseg >= fchk.n)
+        return 0;
+    n = MIN(fchk.k, fchk.nepoch - iseg * fchk.k);
+
+    load_chkpnt(fchk.data + iseg, fwd, &fwd->rtk->ins);
+    insbuf.n = 0;
+    while (insbuf.n < n && fwdstep(fwd, 2) >= 0)
+        ;
+    if (insbuf.n < n)
+    {
+        trace(2, "replay of forward solutions incomplete: iseg=%d n=%d/%d\n", iseg, insbuf.n, n);
+    }
+    fchk.iseg = iseg;
+    return insbuf.n > 0;
 }
 /* get error correction of smoothed state------------------------------------*/
 static void err_corr(const ins_sol_t *pre, ins_sol_t *cur, const insopt_t *opt, double *x, double *P)
@@ -894,82 +1162,123 @@ static void init_bcksmh(ins_sol_t *cur)
     matcpy(cur->Ps, cur->Pc, cur->nx, cur->nx);
     matcpy(cur->slever, cur->clever, 3, 1);
 }
-/* get ins state from forwad solution binary file----------------------------*/
-static int get_ins_state(int n, int bsize, ins_sol_t *ins, const ins_sol_t *pins)
+/* advise read-ahead/release of forward solution store----------------------*/
+static void adv_fwdsol(const ins_solbuf_t *buf, int i)
+{
+    size_t pg = (size_t)sysconf(_SC_PAGESIZE), s, e;
+
+    if (i % NFWDWIN)
+        return;
+
+    /* read-ahead of next window of backward pass */
+    s = buf->rsize * (i > NFWDWIN ? i - NFWDWIN : 0);
+    s -= s % pg;
+    e = buf->rsize * (i + 1);
+    madvise(buf->data + s, e - s, MADV_WILLNEED);
+
+    /* release smoothed epochs */
+    s = buf->rsize * (i + 2);
+    s += (pg - s % pg) % pg;
+    e = buf->rsize * buf->nmax;
+    if (s < e)
+        madvise(buf->data + s, e - s, MADV_DONTNEED);
+}
+/* get ins state from forward solution store---------------------------------
+ * args:  ins_solbuf_t *buf  I   ins solution buffer
+ *        int i              I   index of epoch
+ *        ins_sol_t *ins     O   ins solution
+ *        double *P          I   buffer of {Pc,Pp,F,Ps} (nx x nx x 4)
+ * return: 1 (ok) or 0 (fail)
+ * --------------------------------------------------------------------------*/
+static int get_ins_state(const ins_solbuf_t *buf, int i, ins_sol_t *ins, double *P)
 {
-    int i, gsize = 0;
+    const ins_sol_t *pins;
+    const unsigned char *p;
+    int nn = buf->nx * buf->nx;
 
-    fseek(fp_fwd_sol, (long)bsize * (n - 1), SEEK_SET);
+    if (i < 0 || i >= buf->n)
+        return 0;
+    adv_fwdsol(buf, i);
 
-    gsize += fread(ins, sizeof(ins_sol_t), 1, fp_fwd_sol);
+    pins = fwdsol_rec(buf, i);
+    *ins = *pins;
+    if (ins->nx != buf->nx)
+        return 0;
 
-    ins->Ps = pins->Ps;
-    ins->Pp = pins->Pp;
-    ins->Pc = pins->Pc;
-    ins->F = pins->F;
+    ins->Pc = P;
+    ins->Pp = P + nn;
+    ins->F = P + nn * 2;
+    ins->Ps = P + nn * 3;
 
-    for (i = 0; i < ins->nx * ins->nx; i++)
-    {
-        gsize += fread(&ins->Pc[i], sizeof(double), 1, fp_fwd_sol);
-        gsize += fread(&ins->Pp[i], sizeof(double), 1, fp_fwd_sol);
-        gsize += fread(&ins->F[i], sizeof(double), 1, fp_fwd_sol);
-    }
-    return gsize == (1 + ins->nx * ins->nx * 3);
+    p = (const unsigned char *)(pins + 1);
+    p += unpackcov(p, buf->nx, FWDSOL_PREC, ins->Pc);
+    p += unpackcov(p, buf->nx, FWDSOL_PREC, ins->Pp);
+    unpackphi(p, buf->nx, buf->nb, ins->F);
+    return 1;
 }
-/* backward smoother solution------------------------------------------------
- * args:    rtk_t *rtk       I  rtk data struct
- *          prcopt_t *opt    I  process option
- *          solopt_t *solopt I  solution output option
- * return: numbers of epochs
+/* get ins state of forward epoch--------------------------------------------
+ * args:  fwd_filt_t *fwd    IO  forward filter for replay of segment
+ *        int i              I   index of epoch
+ *        ins_sol_t *ins     O   ins solution
+ *        double *P          I   buffer of {Pc,Pp,F,Ps} (nx x nx x 4)
+ * return: 1 (ok) or 0 (fail)
+ * notes: with checkpoints, the segment of the epoch is recomputed if it is not
+ *        in the forward solution store
  * --------------------------------------------------------------------------*/
-static int bwdsmh(rtk_t *rtk, const prcopt_t *popt, const solopt_t *solopt)
+static int get_fwd_state(fwd_filt_t *fwd, int i, ins_sol_t *ins, double *P)
 {
-    ins_sol_t *cur, *pre;
-    ins_sol_t fins[2], pfins[2] = {0};
-    int i, j = 0, bsize;
+    int k;
 
-#if FORWARD_IN_MEMO
-    cur = &insbuf.data[insbuf.n - 1];
-#else
-    bsize = sizeof(ins_sol_t) + SQR(rtk->ins.nx) * sizeof(double) * 3;
+    if (fchk.k <= 0)
+        return get_ins_state(&insbuf, i, ins, P);
 
-    if (!(fp_fwd_sol = fopen(solfile, "rb")))
+    k = i / fchk.k;
+    if (k != fchk.iseg && !replay_seg(fwd, k))
         return 0;
+    return get_ins_state(&insbuf, i - k * fchk.k, ins, P);
+}
+/* backward smoother solution------------------------------------------------
+ * args:    rtk_t *rtk       I  rtk data struct
+ *          fwd_filt_t *fwd  IO forward filter for replay of segment
+ * return: numbers of epochs
+ * --------------------------------------------------------------------------*/
+static int bwdsmh(rtk_t *rtk, fwd_filt_t *fwd)
+{
+    const prcopt_t *popt = fwd->popt;
+    const solopt_t *solopt = fwd->solopt;
+    ins_sol_t *cur, *pre, fins[2];
+    double *P[2];
+    int i, j = 0, n = 0;
 
-    init_insol(&fins[0], rtk->ins.nx);
-    init_insol(&fins[1], rtk->ins.nx);
-
-    pfins[0] = fins[0];
-    pfins[1] = fins[1];
+    P[0] = mat(insbuf.nx, insbuf.nx * 4);
+    P[1] = mat(insbuf.nx, insbuf.nx * 4);
 
-    if (!get_ins_state(insbuf.n, bsize, &fins[0], &pfins[0]))
+    if (!get_fwd_state(fwd, fchk.nepoch - 1, &fins[0], P[0]))
     {
         trace(2, "read ins state fail\n");
-        free_insol(&fins[0]);
-        free_insol(&fins[1]);
+        free(P[0]);
+        free(P[1]);
         return 0;
     }
     cur = &fins[0];
-#endif
+
     /* first smoother epoch */
     init_bcksmh(cur);
 
-    for (i = insbuf.n - 2; i >= 0; i--)
+    for (i = fchk.nepoch - 2; i >= 0; i--)
     {
-#if FORWARD_IN_MEMO
-        pre = cur;
-        cur = &insbuf.data[i];
-#else
         pre = &fins[j % 2];
         j++;
-        if (!get_ins_state(i + 1, bsize, &fins[j % 2], &pfins[j % 2]))
+        if (!get_fwd_state(fwd, i, &fins[j % 2], P[j % 2]))
             continue;
         cur = &fins[j % 2];
-#endif
+
         if (!upd_ins_rts(pre, cur, &rtk->ins, &popt->insopt))
         {
             fprintf(stderr, "rts fail,time=%s\n", time_str(cur->time, 4));
         }
+        n++;
+
         /* solution. */
         ins2sol(&rtk->ins, &rtk->opt.insopt, &rtk->sol);
 
@@ -981,9 +1290,9 @@ static int bwdsmh(rtk_t *rtk, const prcopt_t *popt, const solopt_t *solopt)
         }
 #endif
     }
-    free_insol(&fins[0]);
-    free_insol(&fins[1]);
-    return cur == insbuf.data;
+    free(P[0]);
+    free(P[1]);
+    return n;
 }
 /* set the temporary path saved by the forward solution file-----------------*/
 extern void set_fwd_soltmp_file(const char *file)
@@ -1002,6 +1311,17 @@ extern void set_fwd_soltmp_file(const char *file)
     }
 #endif
 }
+/* set memory limit of forward solutions of RTS smoother---------------------
+ * args:  double mem        I  memory limit (MB) (0: no limit)
+ * return: none
+ * notes: if the forward solutions exceed the limit, the forward filter state is
+ *        kept every sqrt(n) epochs and forward segments are recomputed in the
+ *        backward pass (about one more forward pass)
+ * --------------------------------------------------------------------------*/
+extern void set_rts_memlimit(double mem)
+{
+    memlimit = mem;
+}
 /* rts smoother for ins/gnss loosely coupled---------------------------------
  * args:  imu_t *imup       I  imu measurement data
  *        gsof_data_t *posp I  position measurement data
@@ -1014,7 +1334,8 @@ extern void set_fwd_soltmp_file(const char *file)
 extern int lcrts(const imu_t *imu, const gsof_data_t *pos, const prcopt_t *popt, const solopt_t *solopt, int port,
                  const char *file)
 {
-    rtk_t rtk = {0};
+    rtk_t rtk = {0}, rtkf = {0};
+    fwd_filt_t fwd = {imu, pos, popt, solopt, &rtk};
     int n;
 
     trace(3, "lcrts: port=%d  file=%s\n", port, file);
@@ -1032,18 +1353,30 @@ extern int lcrts(const imu_t *imu, const gsof_data_t *pos, const prcopt_t *popt,
         return 0;
     }
     /* forward filter */
-    if (fwdfilt(imu, pos, popt, solopt, &rtk))
-        bwdsmh(&rtk, popt, solopt);
-    if (!(n = insbuf.n))
+    if (fwdfilt(&fwd))
+    {
+        /* replay of forward segments from checkpoints */
+        if (fchk.k > 0)
+        {
+            rtkinit(&rtkf, popt);
+            fwd.rtk = &rtkf;
+        }
+        bwdsmh(&rtk, &fwd);
+        if (fchk.k > 0)
+            rtkfree(&rtkf);
+    }
+    if (!(n = fchk.nepoch))
     {
         trace(2, "rts solution fail\n");
     }
-    free_fbsol(&insbuf);
+    close_fwdsol(&insbuf);
+    free_chkpnt(&fchk);
+    free_insol(&insol);
+    if (fwd.imuz)
+        free(fwd.imuz);
     rtkfree(&rtk);
 
     /* close monitor/file */
-    if (fp_fwd_sol)
-        fclose(fp_fwd_sol);
     if (port)
         close_moni(&moni);
     if (file)
@@ -12,8 +12,10 @@
  *
  * version : $Revision: 1.1 $ $Date: 2008/09/05 01:32:44 $
  * history : 2017/10/02 1.0 new
+ *           2026/10/17 1.1 keep gps measurements for reboot lc in ins states
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
+#include <mat3.h>
 
 /* constants/macros ----------------------------------------------------------*/
 #define MAXDT 3600.0           /* max time difference for ins-gnss coupled */
@@ -68,7 +70,6 @@
 #define MAXSYNDIFF 1.0      /* max time difference of ins and gnss time synchronization */
 #define CORRETIME 360.0     /* correlation time for gauss-markov process */
 #define MAXROT (10.0 * D2R) /* max rotation of vehicle when velocity matching alignment */
-#define MAXSOLS 5           /* max number of solutions for reboot lc  */
 #define MAXDIFF 10.0        /* max time difference between solution */
 #define MAXVARDIS (10.0)    /* max variance of disable estimated state */
 #define REBOOT 1            /* ins loosely coupled reboot if always update fail */
@@ -293,6 +294,7 @@ extern void initlc(insopt_t *opt, insstate_t *ins)
     ins->Pb = mat(ins->nb, ins->nb);
     ins->F = eye(ins->nx);
     ins->P0 = zeros(ins->nx, ins->nx);
+    initfiltws(&ins->ws, ins->nx, NM);
 
     ins->ptime = ins->ptct = ins->plct = t0;
     ins->dtrr = 0.0;
@@ -300,6 +302,8 @@ extern void initlc(insopt_t *opt, insstate_t *ins)
     ins->gmeas.data = NULL;
     ins->rtkp = NULL;
     ins->gmeas.n = ins->gmeas.nmax = 0;
+    memset(ins->sols, 0, sizeof(ins->sols));
+    ins->nzvu = ins->nzaru = 0;
 
     for (i = 0; i < ins->nx; i++)
         ins->x[i] = 0.0;
@@ -353,6 +357,7 @@ extern void freelc(insstate_t *ins)
     if (ins->gmeas.data)
         free(ins->gmeas.data);
     ins->gmeas.data = NULL;
+    freefiltws(&ins->ws);
 
     ins->nx = ins->nb = 0;
     ins->gmeas.n = ins->gmeas.nmax = 0;
@@ -671,27 +676,75 @@ static void getF(const insopt_t *opt, const double *Cbe, const double *pos, cons
     stochasticF(opt->cmaopt, icm, ncm, nx, F);
     stochasticF(opt->vmaopt, ivm, nvm, nx, F);
 }
-/* propagate state estimation error covariance-------------------------------*/
+/* propagate state estimation error covariance-------------------------------
+ * note: only attitude/velocity/position rows of phi are coupled to other
+ *       states, rows of the other states (random constant, random walk and
+ *       gauss-markov) have only a diagonal element, so they are applied as
+ *       diagonal scaling and only the coupled rows are multiplied by the
+ *       covariance matrix (O(nc*nx^2) instead of O(nx^3))
+ *       P0 and P may be the same matrix
+ * --------------------------------------------------------------------------*/
 static void propP(const insopt_t *opt, const double *Q, const double *phi, const double *P0, double *P)
 {
-    int i, j, nx = xnX(opt);
-    double *PQ = mat(nx, nx), *Phi2 = mat(nx, nx);
+    int i, j, k, nx = xnX(opt), nc = 0, ic[9], *ci = imat(nx, 1);
+    double *PQ = mat(nx, nx), *d = mat(nx, 1), *Pc, *T, *Tc;
 
+    /* coupled rows and diagonal of transition matrix */
     for (i = 0; i < nx; i++)
     {
-        for (j = 0; j < nx; j++)
-            PQ[i + j * nx] = P0[i + j * nx] + 0.5 * Q[i + j * nx];
+        ci[i] = -1;
+        d[i] = phi[i + i * nx];
     }
-    matmul33("NNT", phi, PQ, phi, nx, nx, nx, nx, Phi2);
-    for (i = 0; i < nx; i++)
+    for (i = IA; i < IA + NA; i++)
+        ic[ci[i] = nc++] = i;
+    for (i = IV; i < IV + NV; i++)
+        ic[ci[i] = nc++] = i;
+    for (i = IP; i < IP + NP; i++)
+        ic[ci[i] = nc++] = i;
+
+    for (i = 0; i < nx * nx; i++)
+        PQ[i] = P0[i] + 0.5 * Q[i];
+    for (j = 0; j < nx; j++)
     {
-        for (j = 0; j < nx; j++)
-            P[i + j * nx] = Phi2[i + j * nx] + 0.5 * Q[i + j * nx];
+        for (i = 0; i < nx; i++)
+            P[i + j * nx] = d[i] * d[j] * PQ[i + j * nx] + 0.5 * Q[i + j * nx];
+    }
+    if (nc > 0)
+    {
+        Pc = mat(nc, nx);
+        T = mat(nc, nx);
+        Tc = mat(nc, nc);
+        for (k = 0; k < nc; k++)
+        {
+            for (j = 0; j < nx; j++)
+                Pc[k + j * nc] = phi[ic[k] + j * nx];
+        }
+        matmul("NN", nc, nx, nx, 1.0, Pc, PQ, 0.0, T); /* T=phi(c,:)*PQ */
+        matmul("NT", nc, nc, nx, 1.0, T, Pc, 0.0, Tc); /* Tc=T*phi(c,:)' */
+
+        for (k = 0; k < nc; k++)
+        {
+            for (j = 0; j < nx; j++)
+            {
+                i = ic[k];
+                if (ci[j] >= 0)
+                {
+                    P[i + j * nx] = Tc[k + ci[j] * nc] + 0.5 * Q[i + j * nx];
+                    continue;
+                }
+                P[i + j * nx] = T[k + j * nc] * d[j] + 0.5 * Q[i + j * nx];
+                P[j + i * nx] = T[k + j * nc] * d[j] + 0.5 * Q[j + i * nx];
+            }
+        }
+        free(Pc);
+        free(T);
+        free(Tc);
     }
     /* initialize every epoch for clock (white noise) */
     initP(irc, nrc, nx, opt->unc.rc, UNC_CLK, P);
     free(PQ);
-    free(Phi2);
+    free(d);
+    free(ci);
 }
 /* propagate state estimates noting that all states are zero due to closed-loop
  * correction----------------------------------------------------------------*/
@@ -720,17 +773,17 @@ static void jacobian_prot_pang(const double *Cbe, double *S)
 static void jacobian_p_att(const double *Cbe, const double *lever, double *dpdatt)
 {
     double cl[3];
-    matmul3v("N", Cbe, lever, cl);
+    mat3mulv_n(Cbe, lever, cl);
     skewsym3(cl, dpdatt);
 }
 /* jacobian of position measurement by ins-gnss time synchronization error---*/
 static void jacobian_p_dt(const double *omgb, const double *lever, const double *Cbe, const double *ve, double *dpddt)
 {
     int i;
-    double wl[9], cl[9];
+    double wl[9], cl[3];
     skewsym3(omgb, wl);
-    matmul3v("N", wl, lever, cl);
-    matmul3v("N", Cbe, cl, dpddt);
+    mat3mulv_n(wl, lever, cl);
+    mat3mulv_n(Cbe, cl, dpddt);
     for (i = 0; i < 3; i++)
         dpddt[i] += ve[i];
 }
@@ -738,13 +791,14 @@ static void jacobian_p_dt(const double *omgb, const double *lever, const double
 static void jacobian_v_att(const double *Cbe, const double *lever, const double *omgb, double *dvdatt)
 {
     int i;
-    double cl[9], wl[9], omgie[3];
+    double cl[9], wl[3], omgie[3];
 
     skewsym3(omgb, cl);
-    matmul3("NN", cl, lever, wl);
-    matmul3("NN", Cbe, wl, cl);
+    mat3mulv_n(cl, lever, wl);
+    mat3mulv_n(Cbe, wl, cl);
 
-    matmul33("NNN", Omge, Cbe, lever, 3, 3, 3, 1, wl);
+    mat3mulv_n(Cbe, lever, wl);
+    mat3mulv_n(Omge, wl, wl);
     for (i = 0; i < 3; i++)
         omgie[i] = cl[i] - wl[i];
     skewsym3(omgie, dvdatt);
@@ -761,7 +815,7 @@ static void jacobian_v_bg(const double *Cbe, const double *lever, double *dvdbg)
 {
     double cl[9];
     skewsym3(lever, cl);
-    matmul3("NN", Cbe, cl, dvdbg);
+    mat3mul_nn(Cbe, cl, dvdbg);
 }
 /* jacobian of velocity measurement by ins-gnss time synchronization error term-*/
 static void jacobian_v_dt(const double *omgb, const double *Cbe, const double *lever, const double *ae, double *dvddt)
@@ -769,8 +823,9 @@ static void jacobian_v_dt(const double *omgb, const double *Cbe, const double *l
     int i;
     double wl[9], cl[9];
     skewsym3(omgb, wl);
-    matmul33("NNN", Cbe, wl, wl, 3, 3, 3, 3, cl);
-    matmul3v("N", cl, lever, dvddt);
+    mat3mul_nn(Cbe, wl, cl);
+    mat3mul_nn(cl, wl, cl);
+    mat3mulv_n(cl, lever, dvddt);
     for (i = 0; i < 3; i++)
         dvddt[i] += ae[i];
 }
@@ -779,12 +834,11 @@ static void jacobian_v_dsg(const double *Cbe, const double *lever, const double
 {
     /* dwib=bg+diag(wib)*sg+T_g*r_g (ref[4]) */
     int i;
-    double dvdbg[9], wib[9] = {0};
+    double dvdbg[9];
 
     jacobian_v_bg(Cbe, lever, dvdbg);
-    for (i = 0; i < 3; i++)
-        wib[i + i * 3] = omgb[i];
-    matmul3("NN", dvdbg, wib, dvds);
+    for (i = 0; i < 9; i++)
+        dvds[i] = dvdbg[i] * omgb[i / 3]; /* dvdbg*diag(wib) */
 }
 /* jacobian of velecity measurement by non-orthogonal between sensor axes of gyro.*/
 static void jacobian_v_drg(const double *Cbe, const double *lever, const double *omgb, double *dvdrg)
@@ -799,15 +853,19 @@ static void jacobian_v_drg(const double *Cbe, const double *lever, const double
     T[10] = omgb[2];
     T[14] = omgb[0];
     T[17] = omgb[1];
-    matmul("NN", 3, 6, 3, 1.0, dvdbg, T, 0.0, dvdrg);
+    mat3mul_nn(dvdbg, T, dvdrg);
+    mat3mul_nn(dvdbg, T + 9, dvdrg + 9);
 }
 /* jacobian of velocity measurement by lever arm--------------------------------*/
 static void jacobian_v_dla(const double *Cbe, const double *omgb, double *dvdla)
 {
     double T[9];
-    matmul3("NN", Omge, Cbe, dvdla);
+    int i;
+    mat3mul_nn(Omge, Cbe, dvdla);
     skewsym3(omgb, T);
-    matmul("NN", 3, 3, 3, -1.0, Cbe, T, 1.0, dvdla);
+    mat3mul_nn(Cbe, T, T);
+    for (i = 0; i < 9; i++)
+        dvdla[i] -= T[i];
 }
 /* measurement sensitive-matrix----------------------------------------------
  * set-up measurement sensitive mtarix
@@ -851,7 +909,7 @@ static int build_HVR(const insopt_t *opt, const double *pos, const double *Cbe,
     jacobian_prot_pang(Cbe, S);
 
     matcpy(r1p, r1, 3, 3);
-    matmul("NN", 3, 3, 3, 1.0, r1p, S, 0.0, r1);
+    mat3mul_nn(r1p, S, r1);
 #endif
     for (i = IMP; i < IMP + NMP; i++)
     {
@@ -889,7 +947,7 @@ static int build_HVR(const insopt_t *opt, const double *pos, const double *Cbe,
     jacobian_prot_pang(Cbe, S);
 
     matcpy(r1p, v1, 3, 3);
-    matmul("NN", 3, 3, 3, 1.0, r1p, S, 0.0, v1);
+    mat3mul_nn(r1p, S, v1);
 #endif
     for (i = IMV; i < IMV + NMV; i++)
     {
@@ -1251,7 +1309,7 @@ static int lcfilt(const insopt_t *opt, insstate_t *ins, const double *meas, cons
                 unusex(opt, i, ins, x);
         }
         /* ekf filter */
-        if ((info = filter(x, P, H, v, R, nx, nm)))
+        if ((info = filter_seq(&ins->ws, x, P, H, v, R, nx, nm)))
         {
             trace(2, "filter error (info=%d)\n", info);
             free(H);
@@ -1577,7 +1635,7 @@ static int chkgmea(const gmea_t *data)
  * --------------------------------------------------------------------------*/
 static int rebootlc(const insopt_t *opt, const gmea_t *data, const imud_t *imu, insstate_t *ins)
 {
-    static gmea_t sols[MAXSOLS] = {0};
+    gmea_t *sols = ins->sols;
     int i;
     double v[3];
 
@@ -180,7 +180,7 @@ extern int nhc(insstate_t *ins, const insopt_t *opt, const imud_t *imu)
     {
 
         /* kalman filter */
-        info = filter(x, ins->P, H, v, R, nx, nv);
+        info = filter_seq(&ins->ws, x, ins->P, H, v, R, nx, nv);
 
         /*  check ok? */
         if (info)
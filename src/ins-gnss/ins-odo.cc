@@ -12,6 +12,7 @@
  *
  * version : $Revision: 1.1 $ $Date: 2008/09/05 01:32:44 $
  * history : 2017/11/13 1.0 new
+ *           2026/10/17 1.1 keep accumulated odometry in ins states
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 
@@ -88,6 +89,7 @@ extern void initodo(const odopt_t *opt, insstate_t *ins)
     matcpy(ins->Cbr, I, 3, 3);
 
     ins->os = opt->s;
+    ins->odt = ins->odr = 0.0;
 }
 /* jacobian of odometry velocity measurement by odometry scale factor--------*/
 static void jacobian_ov_ds(const double *vr, double *dvdds)
@@ -282,7 +284,7 @@ static int odofilt(const insopt_t *opt, const imud_t *imu, const odod_t *odo, in
     {
 
         /* ekf filter */
-        info = filter(x, ins->P, H, v, R, nx, nv);
+        info = filter_seq(&ins->ws, x, ins->P, H, v, R, nx, nv);
 
         /* solution fail */
         if (info)
@@ -307,19 +309,17 @@ static int odofilt(const insopt_t *opt, const imud_t *imu, const odod_t *odo, in
     return info;
 }
 /* adjust odometry measurement data----------------------------------------*/
-static int odomeas(const insopt_t *opt, const odod_t *odo, odod_t *odom)
+static int odomeas(const insopt_t *opt, const odod_t *odo, insstate_t *ins, odod_t *odom)
 {
-    static double dt = 0.0, dr = 0.0;
+    ins->odt += odo->dt;
+    ins->odr += odo->dr;
 
-    dt += odo->dt;
-    dr += odo->dr;
-
-    if (dt > (opt->odopt.odt == 0.0 ? 0.5 : opt->odopt.odt))
+    if (ins->odt > (opt->odopt.odt == 0.0 ? 0.5 : opt->odopt.odt))
     {
-        odom->dt = dt;
-        odom->dr = dr;
-        odom->vr[0] = dr / dt;
-        dt = dr = 0.0;
+        odom->dt = ins->odt;
+        odom->dr = ins->odr;
+        odom->vr[0] = ins->odr / ins->odt;
+        ins->odt = ins->odr = 0.0;
         return 1;
     }
     return 0;
@@ -337,7 +337,7 @@ extern int odo(const insopt_t *opt, const imud_t *imu, const odod_t *odo, inssta
 
     trace(3, "odo:\n");
 
-    if (odomeas(opt, odo, &odom))
+    if (odomeas(opt, odo, ins, &odom))
     {
         return odofilt(opt, imu, &odom, ins);
     }
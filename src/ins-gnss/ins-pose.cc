@@ -509,7 +509,7 @@ static int poseantfilt(const insopt_t *opt, const pose_meas_t *data, insstate_t
     matcpy(P, ins->P, nx, nx);
 
     /* ekf filter for pose fusion */
-    if (!filter(x, P, H, v, R, nx, nv))
+    if (!filter_ws(&ins->ws, x, P, H, v, R, nx, nv))
     {
 
         if (!chkest_state(x, opt))
@@ -643,7 +643,7 @@ static int posecamfilt(const insopt_t *opt, const pose_meas_t *data, insstate_t
         return 0;
     }
     matcpy(P, ins->P, nx, nx);
-    if (!filter(x, P, H, v, R, nv, nv))
+    if (!filter_ws(&ins->ws, x, P, H, v, R, nv, nv))
     {
 
         /* update estimated states */
@@ -16,6 +16,7 @@
  * history : 2018/03/15 1.0 new
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
+#include <mat3.h>
 
 /* constants -----------------------------------------------------------------*/
 #define NUMPOSE 10            /* numbers of camera transform matrix for detect motion*/
@@ -108,7 +109,7 @@ extern int zvu_cam(const insopt_t *opt, const double *dT, int status, const imud
     {
 
         /* ekf filter */
-        info = filter(x, ins->P, H, v, R, nx, 3);
+        info = filter_ws(&ins->ws, x, ins->P, H, v, R, nx, 3);
 
         /* solution fail */
         if (info)
@@ -284,7 +285,7 @@ extern int updatecam(insstate_t *ins, const insopt_t *opt, const double *dT, gti
     rt2tf(ins->vo.Cce, ins->vo.rc, Tp);
     matcpy(TT, dT, 4, 4);
     matinv(TT, 4);
-    matmul("NN", 4, 4, 4, 1.0, Tp, TT, 0.0, T);
+    mat4mul_nn(Tp, TT, T);
 
     tf2rt(T, ins->vo.Cce, ins->vo.rc);
 #if 1
@@ -300,7 +301,7 @@ extern int updatecam(insstate_t *ins, const insopt_t *opt, const double *dT, gti
             ins->vo.vc[i] = 0.0;
         }
     }
-    matmul("NN", 4, 4, 4, 1.0, ins->vo.T, TT, 0.0, T);
+    mat4mul_nn(ins->vo.T, TT, T);
     matcpy(ins->vo.T, T, 4, 4);
 
     ins->vo.time = time;
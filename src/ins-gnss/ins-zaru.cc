@@ -12,6 +12,7 @@
  *
  * version : $Revision: 1.1 $ $Date: 2008/09/05 01:32:44 $
  * history : 2017/11/11 1.0 new
+ *           2026/10/17 1.1 keep update counter in ins states
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 
@@ -31,12 +32,11 @@
 extern int zaru(insstate_t *ins, const insopt_t *opt, const imud_t *imu, int flag)
 {
     int info = 0, nx = ins->nx;
-    static int nz = 0;
     double *v, *x, *H, *R, I[9] = {-1, 0, 0, 0, -1, 0, 0, 0, -1};
 
     trace(3, "zaru:\n");
 
-    flag &= nz++ > MINZAC ? nz = 0, true : false;
+    flag &= ins->nzaru++ > MINZAC ? ins->nzaru = 0, true : false;
 
     if (flag == 0 || opt->bgopt != INS_BGEST)
         return 0;
@@ -60,7 +60,7 @@ extern int zaru(insstate_t *ins, const insopt_t *opt, const imud_t *imu, int fla
     {
 
         /* ekf filter */
-        info = filter(x, ins->P, H, v, R, nx, 3);
+        info = filter_seq(&ins->ws, x, ins->P, H, v, R, nx, 3);
 
         /* solution fail */
         if (info)
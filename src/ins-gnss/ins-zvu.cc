@@ -12,6 +12,7 @@
  *
  * version : $Revision: 1.1 $ $Date: 2008/09/05 01:32:44 $
  * history : 2017/11/11 1.0 new
+ *           2026/10/17 1.1 keep update counter in ins states
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 
@@ -51,12 +52,11 @@ extern int detstc(const imud_t *imu, int n, const insopt_t *opt, const double *p
 extern int zvu(insstate_t *ins, const insopt_t *opt, const imud_t *imu, int flag)
 {
     int nx = ins->nx, info = 0;
-    static int nz = 0;
     double *x, *H, *R, *v, I[9] = {-1, 0, 0, 0, -1, 0, 0, 0, -1};
 
     trace(3, "zvu:\n");
 
-    flag &= nz++ > MINZC ? nz = 0, true : false;
+    flag &= ins->nzvu++ > MINZC ? ins->nzvu = 0, true : false;
 
     if (!flag)
         return info;
@@ -80,7 +80,7 @@ extern int zvu(insstate_t *ins, const insopt_t *opt, const imud_t *imu, int flag
     {
 
         /* ekf filter */
-        info = filter(x, ins->P, H, v, R, nx, 3);
+        info = filter_seq(&ins->ws, x, ins->P, H, v, R, nx, 3);
 
         /* solution fail */
         if (info)
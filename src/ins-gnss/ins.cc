@@ -9,8 +9,11 @@
  *
  * version : $Revision: 1.1 $ $Date: 2008/09/05 01:32:44 $
  * history : 2017/09/29 1.0 new
+ *           2026/10/16 1.1 fix transpose flag of matmul33() with vector C
+ *           2026/10/17 1.2 add imu measurement data stream functions
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
+#include <mat3.h>
 
 /* constants -----------------------------------------------------------------*/
 #define MAXDT 60.0               /* max interval to update imu (s) */
@@ -23,6 +26,7 @@
 #define RP 6356752.31425         /* WGS84 Polar radius in meters */
 #define FLAT 1.0 / 298.257223563 /* WGS84 flattening */
 #define E_SQR 0.00669437999014   /* sqr of linear eccentricity of the ellipsoid */
+#define MAXLOGHEAD 100           /* max number of lines to check imu log file */
 #define SCULL_CORR 1             /* rotational and sculling motion correction */
 
 /* global variable -----------------------------------------------------------*/
@@ -31,14 +35,22 @@ extern const double Omge[9] = {0, OMGE, 0, -OMGE, 0, 0, 0, 0, 0}; /* (5.18) */
 /* multiply 3d matries -------------------------------------------------------*/
 extern void matmul3(const char *tr, const double *A, const double *B, double *C)
 {
-    matmul(tr, 3, 3, 3, 1.0, A, B, 0.0, C);
+    if (tr[0] == 'N' && tr[1] == 'N')
+        mat3mul_nn(A, B, C);
+    else if (tr[0] == 'N')
+        mat3mul_nt(A, B, C);
+    else if (tr[1] == 'N')
+        mat3mul_tn(A, B, C);
+    else
+        mat3mul_tt(A, B, C);
 }
 /* multiply 3d matrix and vector ---------------------------------------------*/
 extern void matmul3v(const char *tr, const double *A, const double *b, double *c)
 {
-    char t[] = "NN";
-    t[0] = tr[0];
-    matmul(t, 3, 1, 3, 1.0, A, b, 0.0, c);
+    if (tr[0] == 'N')
+        mat3mulv_n(A, b, c);
+    else
+        mat3mulv_t(A, b, c);
 }
 /* 3d skew symmetric matrix --------------------------------------------------*/
 extern void skewsym3(const double *ang, double *C)
@@ -79,7 +91,22 @@ extern void matmul33(const char *tr, const double *A, const double *B, const dou
                      double *D)
 {
     char tr_[8];
-    double *T = mat(n, q);
+    double T3[9], *T;
+
+    if (n == 3 && p == 3 && q == 3 && (m == 1 || m == 3))
+    {
+        matmul3(tr, A, B, T3);
+        if (m == 1)
+            mat3mulv_n(T3, C, D); /* vector C is same for op(C) */
+        else
+        {
+            tr_[0] = 'N';
+            tr_[1] = tr[2];
+            matmul3(tr_, T3, C, D);
+        }
+        return;
+    }
+    T = mat(n, q);
     matmul(tr, n, q, p, 1.0, A, B, 0.0, T);
     sprintf(tr_, "N%c", tr[2]);
     matmul(tr_, n, m, q, 1.0, T, C, 0.0, D);
@@ -267,14 +294,14 @@ extern void ins_errmodel(const double *accl, const double *gyro, double *cor_acc
 
     if (!matinv(Mai, 3) && !matinv(Mgi, 3))
     {
-        matmul("NN", 3, 1, 3, 1.0, Mai, accl, 0.0, T);
-        matmul("NN", 3, 1, 3, 1.0, Mgi, gyro, 0.0, T + 3);
+        mat3mulv_n(Mai, accl, T);
+        mat3mulv_n(Mgi, gyro, T + 3);
     }
     if (cor_accl)
     {
         for (i = 0; i < 3; i++)
             cor_accl[i] = T[i] - ins->ba[i];
-        matmul("NN", 3, 1, 3, 1.0, ins->Gg, accl, 0.0, Gf);
+        mat3mulv_n(ins->Gg, accl, Gf);
     }
     if (cor_gyro)
     {
@@ -314,14 +341,14 @@ extern void ins_errmodel2(const double *accl, const double *gyro, const double *
 
     if (!matinv(Mai, 3) && !matinv(Mgi, 3))
     {
-        matmul("NN", 3, 1, 3, 1.0, Mai, accl, 0.0, T);
-        matmul("NN", 3, 1, 3, 1.0, Mgi, gyro, 0.0, T + 3);
+        mat3mulv_n(Mai, accl, T);
+        mat3mulv_n(Mgi, gyro, T + 3);
     }
     if (cor_accl)
     {
         for (i = 0; i < 3; i++)
             cor_accl[i] = T[i] - ba[i];
-        matmul("NN", 3, 1, 3, 1.0, Gg, accl, 0.0, Gf);
+        mat3mulv_n(Gg, accl, Gf);
     }
     if (cor_gyro)
     {
@@ -350,7 +377,7 @@ extern void dcm2rpy(const double *Cnb, double *rpy)
 extern void rov2dcm(const double *rv, double *C)
 {
     int i;
-    double a, *I = eye(3), rs[9], rs2[9], n1, n2;
+    double a, I[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1}, rs[9], rs2[9], n1, n2;
 
     if ((a = norm(rv, 3)) < 1E-8)
     {
@@ -361,10 +388,9 @@ extern void rov2dcm(const double *rv, double *C)
         n1 = sin(a) / a, n2 = (1.0 - cos(a)) / SQR(a);
 
     skewsym3(rv, rs);
-    matmul("NN", 3, 3, 3, 1.0, rs, rs, 0.0, rs2);
+    mat3mul_nn(rs, rs, rs2);
     for (i = 0; i < 9; i++)
         C[i] = I[i] - n1 * rs[i] + n2 * rs2[i];
-    free(I);
 }
 /* convert rotation vector to transformation quaternion-------------------
  * args  : double *rv       I rotate vector
@@ -397,7 +423,7 @@ extern void qmulv(const double *vi, const quat_t *quat, double *vo)
 {
     double C[9];
     quat_to_rh_rot_matrix(quat, C);
-    matmul("NN", 3, 1, 3, 1.0, C, vi, 0.0, vo);
+    mat3mulv_n(C, vi, vo);
 }
 /* convert quaternion to euler -----------------------------------------------
  * args  : quat_t *quat    I  transformation quaternion
@@ -464,7 +490,7 @@ extern void gravity(const double *re, double *ge)
     ecef2pos(re, pos);
     gn[2] = gravity0(pos) * (1.0 - 2.0 * pos[2] / RE);
     ned2xyz(pos, Cne);
-    matmul3v("N", Cne, gn, ge);
+    mat3mulv_n(Cne, gn, ge);
 }
 /* Calculates  acceleration due to gravity resolved about ecef-frame ---------
  * args  : double *pos     I   cartesian position of body frame w.r.t. ecef frame,
@@ -561,11 +587,11 @@ extern void initins(insstate_t *ins, const double *re, double angh, const imud_t
     rpy2dcm(rpy, Cnb);
     matt(Cnb, 3, 3, ins->Cbn);
     ned2xyz(pos, Cne);
-    matmul3("NT", Cne, Cnb, ins->Cbe); /* conversion order */
+    mat3mul_nt(Cne, Cnb, ins->Cbe); /* conversion order */
     if (n > 0)
     {
         gravity(re, ge);
-        matmul3v("T", ins->Cbe, ge, gb);
+        mat3mulv_t(ins->Cbe, ge, gb);
         for (i = 0; i < 3; i++)
         {
             ins->ba[i] = fb[i] + gb[i];
@@ -601,7 +627,7 @@ static void updateatt(double t, double *Cbe, const double *omgb, const double *d
     for (i = 0; i < 3; i++)
         alpha[i] = omgb[i] * t + das[i];
     skewsym3(alpha, Ca);
-    matmul3("NN", Ca, Ca, Ca2);
+    mat3mul_nn(Ca, Ca, Ca2);
     a = norm(alpha, 3);
     if (a < 1E-8)
     {
@@ -623,11 +649,11 @@ static void updateatt(double t, double *Cbe, const double *omgb, const double *d
     Cei[1] = -sin(OMGE * t);
     Cei[4] = cos(OMGE * t);
     Cei[8] = 1.0;
-    matmul3("NN", Cei, Cbe, Cbep);
-    matmul3("NN", Cbep, Cbb, Cbe);
+    mat3mul_nn(Cei, Cbe, Cbep);
+    mat3mul_nn(Cbep, Cbb, Cbe);
 #else
-    matmul3("NN", Cbe, Cbb, Cbep);
-    matmul3("NN", Omge, Cbe, Comg); /* (5.65) */
+    mat3mul_nn(Cbe, Cbb, Cbep);
+    mat3mul_nn(Omge, Cbe, Comg); /* (5.65) */
     for (i = 0; i < 9; i++)
         Cbe[i] = Cbep[i] - Comg[i] * t; /* (5.20) */
 #endif
@@ -652,11 +678,11 @@ static void updinsn(insstate_t *ins)
 
     /* attitude/velocity */
     ned2xyz(ins->rn, Cne);
-    matmul("TN", 3, 3, 3, 1.0, Cne, ins->Cbe, 0.0, ins->Cbn);
-    matmul("TN", 3, 1, 3, 1.0, Cne, ins->ve, 0.0, ins->vn);
+    mat3mul_tn(Cne, ins->Cbe, ins->Cbn);
+    mat3mulv_t(Cne, ins->ve, ins->vn);
 
     /* acceleration */
-    matmul("TN", 3, 1, 3, 1.0, Cne, ins->ae, 0.0, ins->an);
+    mat3mulv_t(Cne, ins->ae, ins->an);
 }
 /* update ins states ----------------------------------------------------------
  * updata ins states with imu measurement data in e-frame
@@ -821,7 +847,8 @@ extern int updateins(const insopt_t *insopt, insstate_t *ins, const imud_t *data
     dvbk[0] = ins->fb[0] * dt + dv[0];
     dvbk[1] = ins->fb[1] * dt + dv[1];
     dvbk[2] = ins->fb[2] * dt + dv[2];
-    matmul33("NNN", dCe, Ck_1, dvbk, 3, 3, 3, 1, dvfk);
+    mat3mulv_n(Ck_1, dvbk, dvfk);
+    mat3mulv_n(dCe, dvfk, dvfk);
 
     Omge[0] = 0.0;
     Omge[1] = 0.0;
@@ -905,16 +932,17 @@ extern void rmlever(const double *pos, const double *re, const double *ve, const
     trace(3, "rmlever :\n");
 
     /* correct position */
-    matmul3v("N", Cbe, lever, T);
+    mat3mulv_n(Cbe, lever, T);
     if (rec)
         for (i = 0; i < 3; i++)
             rec[i] = re[i] + T[i];
 
     /* correct velecity */
     skewsym3(omgb, Omg);
-    matmul3v("N", Omg, lever, wl);
-    matmul3v("N", Cbe, wl, T);
-    matmul33("NNN", Omge, Cbe, lever, 3, 3, 3, 1, wl);
+    mat3mulv_n(Omg, lever, wl);
+    mat3mulv_n(Cbe, wl, T);
+    mat3mulv_n(Cbe, lever, wl);
+    mat3mulv_n(Omge, wl, wl);
     if (vec)
         for (i = 0; i < 3; i++)
             vec[i] = ve[i] + T[i] - wl[i];
@@ -965,17 +993,17 @@ extern void traceins(int level, const insstate_t *ins)
     trace(level, "time  =%s\n", s);
     ecef2pos(ins->re, pos);
     ned2xyz(pos, Cne);
-    matmul3("TN", ins->Cbe, Cne, Cnb);
+    mat3mul_tn(ins->Cbe, Cne, Cnb);
     dcm2rpy(Cnb, rpy);
     trace(level, "attn =%8.5f %8.5f %8.5f\n", rpy[0] * R2D, rpy[1] * R2D, rpy[2] * R2D);
 
-    matmul3v("T", Cne, ins->ve, vel);
-    matmul3v("T", Cne, ins->ae, acc);
+    mat3mulv_t(Cne, ins->ve, vel);
+    mat3mulv_t(Cne, ins->ae, acc);
     trace(level, "veln =%8.5f %8.5f %8.5f accn =%8.5f %8.5f %8.5f\n", vel[0], vel[1], vel[2], acc[0], acc[1],
           acc[2]); /* n-frame */
 
-    matmul3v("T", ins->Cbe, ins->ve, vel);
-    matmul3v("T", ins->Cbe, ins->ae, acc);
+    mat3mulv_t(ins->Cbe, ins->ve, vel);
+    mat3mulv_t(ins->Cbe, ins->ae, acc);
     trace(level, "velb =%8.5f %8.5f %8.5f accb =%8.5f %8.5f %8.5f\n", vel[0], vel[1], vel[2], acc[0], acc[1],
           acc[2]); /* b-frame */
 
@@ -983,6 +1011,27 @@ extern void traceins(int level, const insstate_t *ins)
           ins->ba[1], ins->ba[2]);
 #endif
 }
+/* decode imu measurement log line ------------------------------------------*/
+static int decimulog(const char *buff, int week, imud_t *data)
+{
+    double v[8];
+
+    /* time gyrox gyroy gyroz accx accy accz odometry */
+    if (sscanf(buff, "%lf %lf %lf %lf %lf %lf %lf %lf \n", v, v + 1, v + 2, v + 3, v + 4, v + 5, v + 6, v + 7) < 8)
+    {
+        return 0;
+    }
+    data->gyro[0] = v[1]; /* rad */
+    data->gyro[1] = v[2];
+    data->gyro[2] = v[3];
+    data->accl[0] = v[4]; /* m/s */
+    data->accl[1] = v[5];
+    data->accl[2] = v[6];
+
+    /* time record */
+    data->time = gpst2time(week, v[0]);
+    return 1;
+}
 /* read imu measurement log file -----------------------------------------------
  * read imu measurement log file
  * args   : char   *file     I   imu measurement log file
@@ -996,12 +1045,10 @@ extern void traceins(int level, const insstate_t *ins)
 extern int readimu(const char *file, imu_t *imu, int decfmt, int format, int coor, int valfmt)
 {
     FILE *fp;
-    imud_t *p;
-    double v[12], sow;
+    imud_t data = {0};
     size_t siz;
     int week;
     char buff[1024];
-    gtime_t t0;
 
     trace(3, "readimulog:s=%s\n", file);
     imu->n = imu->nmax = 0;
@@ -1016,16 +1063,13 @@ extern int readimu(const char *file, imu_t *imu, int decfmt, int format, int coo
         fprintf(stderr, "file open error : %s\n", file);
         return 0;
     }
-    t0 = timeget();
-    sow = time2gpst(t0, &week);
+    time2gpst(timeget(), &week);
 
     while (fgets(buff, sizeof(buff), fp))
     {
-        /* time gyrox gyroy gyroz accx accy accz odometry */
-        if (sscanf(buff, "%lf %lf %lf %lf %lf %lf %lf %lf \n", v, v + 1, v + 2, v + 3, v + 4, v + 5, v + 6, v + 7) < 8)
-        {
+        if (!decimulog(buff, week, &data))
             continue;
-        }
+
         if (imu->n >= imu->nmax)
         {
             trace(5, "readimulog:imu->n=%d nmax=%d\n", imu->n, imu->nmax);
@@ -1038,22 +1082,104 @@ extern int readimu(const char *file, imu_t *imu, int decfmt, int format, int coo
                 break;
             }
         }
-        p = imu->data + imu->n++;
-
-        p->gyro[0] = v[1]; /* rad */
-        p->gyro[1] = v[2];
-        p->gyro[2] = v[3];
-        p->accl[0] = v[4]; /* m/s */
-        p->accl[1] = v[5];
-        p->accl[2] = v[6];
-
-        /* time record */
-        sow = v[0];
-        p->time = gpst2time(week, sow);
+        imu->data[imu->n++] = data;
     }
     fclose(fp);
     return imu->n <= 0 ? 0 : 1;
 }
+/* open imu measurement data stream --------------------------------------------
+ * open imu measurement log file or binary imu raw data file as stream. the file
+ * is decoded as text log if any of the first lines is imu measurement log
+ * line, or else as binary imu raw data as readimub()
+ * args   : imustr_t *str    O   imu measurement data stream
+ *          char   *file     I   imu measurement data file
+ *          int    imufmt    I   imu measurement data format
+ * return : status (1:ok,0:error)
+ *-----------------------------------------------------------------------------*/
+extern int open_imustr(imustr_t *str, const char *file, int imufmt)
+{
+    imud_t data;
+    char buff[1024];
+    int i, text = 0;
+
+    trace(3, "open_imustr: file=%s\n", file);
+
+    memset(str, 0, sizeof(imustr_t));
+
+    if (!(str->fp = fopen(file, "r")))
+    {
+        trace(2, "imu measurement data file open error: %s\n", file);
+        return 0;
+    }
+    time2gpst(timeget(), &str->week);
+
+    /* check text log by first lines */
+    for (i = 0; i < MAXLOGHEAD && !text && fgets(buff, sizeof(buff), str->fp); i++)
+    {
+        text = decimulog(buff, str->week, &data);
+    }
+    rewind(str->fp);
+
+    if (!text)
+    {
+        if (!(str->raw = (raw_t *)calloc(1, sizeof(raw_t))))
+        {
+            close_imustr(str);
+            return 0;
+        }
+        str->raw->imufmt = imufmt;
+    }
+    return 1;
+}
+/* input imu measurement data from stream --------------------------------------
+ * input next imu measurement data from stream in the same way as readimu() or
+ * readimub(). the time of the data is in gps seconds of week of the week given
+ * by the file as read by readimu() and readimub()
+ * args   : imustr_t *str    IO  imu measurement data stream
+ * return : status (1:ok,0:end of file/error)
+ *          str->data is set to the imu measurement data if ok
+ *-----------------------------------------------------------------------------*/
+extern int input_imustr(imustr_t *str)
+{
+    char buff[1024];
+    int data;
+
+    if (!str->fp)
+        return 0;
+
+    if (!str->raw)
+    { /* text log */
+        while (fgets(buff, sizeof(buff), str->fp))
+        {
+            memset(&str->data, 0, sizeof(imud_t));
+            if (decimulog(buff, str->week, &str->data))
+                return 1;
+        }
+        return 0;
+    }
+    while ((data = fgetc(str->fp)) != EOF)
+    {
+        if (input_m39(str->raw, (unsigned char)data))
+        {
+            str->data = str->raw->imu;
+            return 1;
+        }
+    }
+    return 0;
+}
+/* close imu measurement data stream -----------------------------------------*/
+extern void close_imustr(imustr_t *str)
+{
+    trace(3, "close_imustr:\n");
+
+    if (str->fp)
+        fclose(str->fp);
+    str->fp = NULL;
+    if (str->raw)
+        free(str->raw->imut.data);
+    free(str->raw);
+    str->raw = NULL;
+}
 /* use imu stationaly imu measurement data to estimate attitude--------------
  * args  :  imud_t *data  I  stationaly imu measurement data
  *          int n         I  number of imu measurement data
@@ -1110,8 +1236,8 @@ extern void gapv2ipv(const double *pos, const double *vel, const double *Cbe, co
     if (veli)
     {
         skewsym3(imu->gyro, T);
-        matmul("NN", 3, 1, 3, 1.0, T, lever, 0.0, TT);
-        matmul("NN", 3, 1, 3, 1.0, Cbe, TT, 0.0, T);
+        mat3mulv_n(T, lever, TT);
+        mat3mulv_n(Cbe, TT, T);
 
         matmul33("NNN", Omge, Cbe, lever, 3, 3, 3, 1, TT);
         for (i = 0; i < 3; i++)
@@ -1133,7 +1259,7 @@ extern void corratt(const double *dx, double *C)
         I[i] -= T[i];
 
     matcpy(T, C, 3, 3);
-    matmul("NN", 3, 3, 3, 1.0, I, T, 0.0, C);
+    mat3mul_nn(I, T, C);
     free(I);
 }
 /* get attitude from ins states----------------------------------------------
@@ -1147,7 +1273,7 @@ extern void getatt(const insstate_t *ins, double *rpy)
 
     ecef2pos(ins->re, llh);
     ned2xyz(llh, C);
-    matmul("TN", 3, 3, 3, 1.0, ins->Cbe, C, 0.0, Cnb);
+    mat3mul_tn(ins->Cbe, C, Cnb);
     dcm2rpy(Cnb, rpy);
 }
 /* adjust imu data to frd-ned frame and convert to angular rate/acceleration
@@ -1166,8 +1292,8 @@ extern void adjustimu(const prcopt_t *opt, imud_t *imu)
     { /* convert to frd-ned-frame */
         matcpy(gyro, imu->gyro, 1, 3);
         matcpy(accl, imu->accl, 1, 3);
-        matmul("NN", 3, 1, 3, 1.0, Crf, gyro, 0.0, imu->gyro);
-        matmul("NN", 3, 1, 3, 1.0, Crf, accl, 0.0, imu->accl);
+        mat3mulv_n(Crf, gyro, imu->gyro);
+        mat3mulv_n(Crf, accl, imu->accl);
     }
     if (opt->insopt.imudecfmt == IMUDECFMT_INCR)
     {
@@ -1299,7 +1425,7 @@ extern void getvn(const insstate_t *ins, double *vn)
 
     ecef2pos(ins->re, pos);
     ned2xyz(pos, C);
-    matmul("TN", 3, 1, 3, 1.0, C, ins->ve, 0.0, vn);
+    mat3mulv_t(C, ins->ve, vn);
 }
 /* update ins states in n-frame----------------------------------------------*/
 extern void update_ins_state_n(insstate_t *ins)
@@ -1311,11 +1437,11 @@ extern void update_ins_state_n(insstate_t *ins)
 
     /* attitude/velocity */
     ned2xyz(ins->rn, Cne);
-    matmul("TN", 3, 3, 3, 1.0, Cne, ins->Cbe, 0.0, ins->Cbn);
-    matmul("TN", 3, 1, 3, 1.0, Cne, ins->ve, 0.0, ins->vn);
+    mat3mul_tn(Cne, ins->Cbe, ins->Cbn);
+    mat3mulv_t(Cne, ins->ve, ins->vn);
 
     /* acceleration */
-    matmul("TN", 3, 1, 3, 1.0, Cne, ins->ae, 0.0, ins->an);
+    mat3mulv_t(Cne, ins->ae, ins->an);
 }
 /* update ins states in e-frame----------------------------------------------*/
 extern void update_ins_state_e(insstate_t *ins)
@@ -1324,8 +1450,8 @@ extern void update_ins_state_e(insstate_t *ins)
 
     /* attitude and velocity */
     ned2xyz(ins->rn, Cne);
-    matmul("NN", 3, 3, 3, 1.0, Cne, ins->Cbn, 0.0, ins->Cbe);
-    matmul("NN", 3, 1, 3, 1.0, Cne, ins->vn, 0.0, ins->ve);
+    mat3mul_nn(Cne, ins->Cbn, ins->Cbe);
+    mat3mulv_n(Cne, ins->vn, ins->ve);
 
     /* position */
     pos2ecef(ins->rn, ins->re);
@@ -1334,7 +1460,7 @@ extern void update_ins_state_e(insstate_t *ins)
     getaccl(ins->fb, ins->Cbe, ins->re, ins->ve, ins->ae);
 #else
     /* update acceleration in n-frame */
-    matmul("NN", 3, 1, 3, 1.0, Cne, ins->an, 0.0, ins->ae);
+    mat3mulv_n(Cne, ins->an, ins->ae);
 #endif
 }
 /* computes the curvature matrix and the gravity-----------------------------*/
@@ -1388,7 +1514,7 @@ static void getqbn(const insstate_t *ins, double *qbn)
     double pos[3], Cne[9], Cbn[9];
     ecef2pos(ins->re, pos);
     ned2xyz(pos, Cne);
-    matmul3("TN", Cne, ins->Cbe, Cbn);
+    mat3mul_tn(Cne, ins->Cbe, Cbn);
     dcm2quatx(Cbn, qbn);
 }
 /* rotational and sculling motion correction --------------------------------*/
@@ -1554,3 +1680,128 @@ extern int updateinsn(const insopt_t *insopt, insstate_t *ins, const imud_t *dat
     traceins(5, ins);
     return 1;
 }
+/* size of packed covariance matrix -------------------------------------------
+ * args   : int    n        I   number of rows/columns of covariance
+ *          int    prec     I   precision of off-diagonal terms (0:double,1:float)
+ * return : size of packed covariance (bytes)
+ *----------------------------------------------------------------------------*/
+extern int sizecov(int n, int prec)
+{
+    return n * (int)sizeof(double) + n * (n - 1) / 2 * (prec ? (int)sizeof(float) : (int)sizeof(double));
+}
+/* pack covariance matrix -----------------------------------------------------
+ * pack symmetric covariance matrix to upper triangle
+ * args   : double *P       I   covariance matrix (n x n)
+ *          int    n        I   number of rows/columns of covariance
+ *          int    prec     I   precision of off-diagonal terms (0:double,1:float)
+ *          unsigned char *buff O packed covariance {diag,upper triangle by column}
+ * return : size of packed covariance (bytes)
+ * notes  : diagonal terms are always kept in double
+ *----------------------------------------------------------------------------*/
+extern int packcov(const double *P, int n, int prec, unsigned char *buff)
+{
+    unsigned char *p = buff;
+    float f;
+    int i, j;
+
+    for (i = 0; i < n; i++, p += sizeof(double))
+        memcpy(p, P + i + i * n, sizeof(double));
+    for (j = 1; j < n; j++)
+    {
+        if (!prec)
+        {
+            memcpy(p, P + j * n, sizeof(double) * j);
+            p += sizeof(double) * j;
+            continue;
+        }
+        for (i = 0; i < j; i++, p += sizeof(float))
+        {
+            f = (float)P[i + j * n];
+            memcpy(p, &f, sizeof(float));
+        }
+    }
+    return (int)(p - buff);
+}
+/* unpack covariance matrix ---------------------------------------------------
+ * args   : unsigned char *buff I packed covariance by packcov()
+ *          int    n        I   number of rows/columns of covariance
+ *          int    prec     I   precision of off-diagonal terms (0:double,1:float)
+ *          double *P       O   covariance matrix (n x n)
+ * return : size of packed covariance (bytes)
+ *----------------------------------------------------------------------------*/
+extern int unpackcov(const unsigned char *buff, int n, int prec, double *P)
+{
+    const unsigned char *p = buff;
+    float f;
+    int i, j;
+
+    for (i = 0; i < n; i++, p += sizeof(double))
+        memcpy(P + i + i * n, p, sizeof(double));
+    for (j = 1; j < n; j++)
+    {
+        for (i = 0; i < j; i++)
+        {
+            if (prec)
+            {
+                memcpy(&f, p, sizeof(float));
+                p += sizeof(float);
+                P[i + j * n] = f;
+            }
+            else
+            {
+                memcpy(P + i + j * n, p, sizeof(double));
+                p += sizeof(double);
+            }
+            P[j + i * n] = P[i + j * n];
+        }
+    }
+    return (int)(p - buff);
+}
+/* size of packed transition matrix -------------------------------------------
+ * args   : int    n        I   number of states
+ *          int    nb       I   number of coupled rows of nav block
+ * return : size of packed transition matrix (bytes)
+ *----------------------------------------------------------------------------*/
+extern int sizephi(int n, int nb)
+{
+    return (nb * n + n - nb) * (int)sizeof(double);
+}
+/* pack transition matrix -----------------------------------------------------
+ * pack block-sparse transition matrix of ins error states
+ * args   : double *F       I   transition matrix (n x n)
+ *          int    n        I   number of states
+ *          int    nb       I   number of coupled rows of nav block
+ *          unsigned char *buff O packed matrix {F(0:nb-1,:),diag(F(nb:n-1,nb:n-1))}
+ * return : size of packed transition matrix (bytes)
+ * notes  : rows outside the nav block {att,vel,pos} are diagonal (see propP())
+ *----------------------------------------------------------------------------*/
+extern int packphi(const double *F, int n, int nb, unsigned char *buff)
+{
+    unsigned char *p = buff;
+    int i, j;
+
+    for (j = 0; j < n; j++, p += sizeof(double) * nb)
+        memcpy(p, F + j * n, sizeof(double) * nb);
+    for (i = nb; i < n; i++, p += sizeof(double))
+        memcpy(p, F + i + i * n, sizeof(double));
+    return (int)(p - buff);
+}
+/* unpack transition matrix ---------------------------------------------------
+ * args   : unsigned char *buff I packed matrix by packphi()
+ *          int    n        I   number of states
+ *          int    nb       I   number of coupled rows of nav block
+ *          double *F       O   transition matrix (n x n)
+ * return : size of packed transition matrix (bytes)
+ *----------------------------------------------------------------------------*/
+extern int unpackphi(const unsigned char *buff, int n, int nb, double *F)
+{
+    const unsigned char *p = buff;
+    int i, j;
+
+    setzero(F, n, n);
+    for (j = 0; j < n; j++, p += sizeof(double) * nb)
+        memcpy(F + j * n, p, sizeof(double) * nb);
+    for (i = nb; i < n; i++, p += sizeof(double))
+        memcpy(F + i + i * n, p, sizeof(double));
+    return (int)(p - buff);
+}
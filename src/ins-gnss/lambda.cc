@@ -11,6 +11,10 @@
  * version : $Revision: 1.1 $ $Date: 2008/07/17 21:48:06 $
  * history : 2007/01/13 1.0 new
  *           2015/05/31 1.1 add api lambda_reduction(), lambda_search()
+ *           2026/10/16 1.2 add api lambda_init(), lambda_drop(), lambda_solve(),
+ *                          lambda_free()
+ *                          search with work area instead of allocations
+ *                          work area of lambda_drop() in workspace
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
 
@@ -128,11 +132,15 @@ static void reduction(int n, double *L, double *D, double *Z)
     }
 }
 /* modified lambda (mlambda) search (ref. [2]) -------------------------------*/
-static int search(int n, int m, const double *L, const double *D, const double *zs, double *zn, double *s)
+static int search(int n, int m, const double *L, const double *D, const double *zs, double *zn, double *s,
+                  double *work)
 {
     int i, j, k, c, nn = 0, imax = 0;
     double newdist, maxdist = 1E99, y;
-    double *S = zeros(n, n), *dist = mat(n, 1), *zb = mat(n, 1), *z = mat(n, 1), *step = mat(n, 1);
+    double *S = work, *dist = S + n * n, *zb = dist + n, *z = zb + n, *step = z + n;
+
+    for (i = 0; i < n * n; i++)
+        S[i] = 0.0;
 
     k = n - 1;
     dist[k] = 0.0;
@@ -207,12 +215,6 @@ static int search(int n, int m, const double *L, const double *D, const double *
                 SWAP(zn[k + i * n], zn[k + j * n]);
         }
     }
-    free(S);
-    free(dist);
-    free(zb);
-    free(z);
-    free(step);
-
     if (c >= LOOPMAX)
     {
         trace(2, "%s : search loop count overflow\n", __FILE__);
@@ -231,40 +233,25 @@ static int search(int n, int m, const double *L, const double *D, const double *
  *          double *s     O  sum of squared residulas of fixed solutions (1 x m)
  * return : status (0:ok,other:error)
  * notes  : matrix stored by column-major order (fortran convension)
+ *          workspace is allocated per call. for repeated estimation use
+ *          lambda_init() and lambda_solve() with a persistent workspace
  *-----------------------------------------------------------------------------*/
 extern int lambda(int n, int m, const double *a, const double *Q, double *F, double *s)
 {
+    lambda_t lam = {0};
     int info;
-    double *L, *D, *Z, *z, *E;
 
     if (n <= 0 || m <= 0)
         return -1;
-    L = zeros(n, n);
-    D = mat(n, 1);
-    Z = eye(n);
-    z = mat(n, 1);
-    E = mat(n, m);
 
     /* LD factorization */
-    if (!(info = LD(n, Q, L, D)))
+    if (!(info = lambda_init(&lam, n, a, Q)))
     {
 
-        /* lambda reduction */
-        reduction(n, L, D, Z);
-        matmul("TN", n, 1, n, 1.0, Z, a, 0.0, z); /* z=Z'*a */
-
-        /* mlambda search */
-        if (!(info = search(n, m, L, D, z, E, s)))
-        {
-
-            info = solve("T", Z, E, n, m, F); /* F=Z'\E */
-        }
+        /* lambda reduction and mlambda search */
+        info = lambda_solve(&lam, m, F, s);
     }
-    free(L);
-    free(D);
-    free(Z);
-    free(z);
-    free(E);
+    lambda_free(&lam);
     return info;
 }
 /* lambda reduction ------------------------------------------------------------
@@ -316,7 +303,7 @@ extern int lambda_reduction(int n, const double *Q, double *Z)
  *-----------------------------------------------------------------------------*/
 extern int lambda_search(int n, int m, const double *a, const double *Q, double *F, double *s)
 {
-    double *L, *D;
+    double *L, *D, *work;
     int info;
 
     if (n <= 0 || m <= 0)
@@ -333,9 +320,173 @@ extern int lambda_search(int n, int m, const double *a, const double *Q, double
         return info;
     }
     /* mlambda search */
-    info = search(n, m, L, D, a, F, s);
+    work = mat(n, n + 4);
+    info = search(n, m, L, D, a, F, s, work);
 
     free(L);
     free(D);
+    free(work);
+    return info;
+}
+/* initialize lambda workspace -------------------------------------------------
+ * LD factorization of covariance of float parameters into lambda workspace
+ * args   : lambda_t *lam   IO lambda workspace ({0} or previously used)
+ *          int    n        I  number of float parameters
+ *          double *a       I  float parameters (n x 1)
+ *          double *Q       I  covariance matrix of float parameters (n x n)
+ * return : status (0:ok,other:error)
+ * notes  : buffers are reallocated only if n exceeds allocated size.
+ *          the workspace should be freed by lambda_free()
+ *-----------------------------------------------------------------------------*/
+extern int lambda_init(lambda_t *lam, int n, const double *a, const double *Q)
+{
+    double *p;
+    int i;
+
+    trace(4, "lambda_init: n=%d\n", n);
+
+    if (n <= 0)
+        return -1;
+
+    if (n > lam->nmax)
+    {
+        if (!(p = (double *)realloc(lam->L, sizeof(double) * n * (n + 3))))
+        {
+            trace(1, "lambda_init: malloc error n=%d\n", n);
+            return -1;
+        }
+        lam->L = p;
+        lam->D = p + n * n;
+        lam->a = p + n * (n + 1);
+        lam->w = p + n * (n + 2);
+        lam->nmax = n;
+    }
+    lam->n = n;
+    for (i = 0; i < n; i++)
+        lam->a[i] = a[i];
+    for (i = 0; i < n * n; i++)
+        lam->L[i] = 0.0;
+
+    return LD(n, Q, lam->L, lam->D);
+}
+/* exclude float parameter from lambda workspace -------------------------------
+ * exclude a float parameter and update LD factorization without refactorizing
+ * the covariance matrix
+ * args   : lambda_t *lam   IO lambda workspace
+ *          int    k        I  index of float parameter to exclude (0:n-1)
+ * return : status (0:ok,other:error)
+ * notes  : rows of L below k are kept, and the leading k x k factors are
+ *          updated by rank-one term D[k]*l*l' with l=L(k,0:k-1).
+ *          indexes of the float parameters after k are shifted by one
+ *-----------------------------------------------------------------------------*/
+extern int lambda_drop(lambda_t *lam, int k)
+{
+    double *L = lam->L, *D = lam->D, *w = lam->w, alpha, p, d, r;
+    int i, j, n = lam->n;
+
+    trace(4, "lambda_drop: n=%d k=%d\n", n, k);
+
+    if (k < 0 || k >= n || n <= 1)
+        return -1;
+
+    /* rank-one update of leading factors (Q=L'*D*L+alpha*w*w') */
+    for (j = 0; j < k; j++)
+        w[j] = L[k + j * n];
+    for (i = k - 1, alpha = D[k]; i >= 0; i--)
+    {
+        p = w[i];
+        d = D[i] + alpha * p * p;
+        for (j = 0; j < i; j++)
+        {
+            r = L[i + j * n];
+            L[i + j * n] = (D[i] * r + alpha * p * w[j]) / d;
+            w[j] -= p * r;
+        }
+        alpha *= D[i] / d;
+        D[i] = d;
+    }
+
+    /* remove row and column k (column-major, in place) */
+    for (j = 0; j < n; j++)
+        for (i = 0; i < n; i++)
+        {
+            if (i == k || j == k)
+                continue;
+            L[(i < k ? i : i - 1) + (j < k ? j : j - 1) * (n - 1)] = L[i + j * n];
+        }
+    for (i = k; i < n - 1; i++)
+    {
+        D[i] = D[i + 1];
+        lam->a[i] = lam->a[i + 1];
+    }
+    lam->n = n - 1;
+    return 0;
+}
+/* lambda/mlambda integer least-square estimation by workspace -----------------
+ * integer least-square estimation of float parameters in lambda workspace
+ * args   : lambda_t *lam   IO lambda workspace
+ *          int    m        I  number of fixed solutions
+ *          double *F       O  fixed solutions (n x m)
+ *          double *s       O  sum of squared residulas of fixed solutions (1 x m)
+ * return : status (0:ok,other:error)
+ * notes  : same as lambda(). LD factors in workspace are kept, so that the
+ *          estimation can be repeated after lambda_drop()
+ *-----------------------------------------------------------------------------*/
+extern int lambda_solve(lambda_t *lam, int m, double *F, double *s)
+{
+    double *p, *L, *D, *Z, *z, *E;
+    int i, info, n = lam->n, nw = n * (3 * n + 6 + m);
+
+    trace(4, "lambda_solve: n=%d m=%d\n", n, m);
+
+    if (n <= 0 || m <= 0)
+        return -1;
+
+    if (nw > lam->nwork)
+    {
+        if (!(p = (double *)realloc(lam->work, sizeof(double) * nw)))
+        {
+            trace(1, "lambda_solve: malloc error n=%d\n", n);
+            return -1;
+        }
+        lam->work = p;
+        lam->nwork = nw;
+    }
+    L = lam->work;
+    D = L + n * n;
+    Z = D + n;
+    z = Z + n * n;
+    E = z + n;
+
+    for (i = 0; i < n * n; i++)
+    {
+        L[i] = lam->L[i];
+        Z[i] = i % (n + 1) ? 0.0 : 1.0;
+    }
+    for (i = 0; i < n; i++)
+        D[i] = lam->D[i];
+
+    /* lambda reduction */
+    reduction(n, L, D, Z);
+    matmul("TN", n, 1, n, 1.0, Z, lam->a, 0.0, z); /* z=Z'*a */
+
+    /* mlambda search */
+    if (!(info = search(n, m, L, D, z, E, s, E + n * m)))
+    {
+
+        info = solve("T", Z, E, n, m, F); /* F=Z'\E */
+    }
     return info;
 }
+/* free lambda workspace -------------------------------------------------------
+ * free buffers of lambda workspace
+ * args   : lambda_t *lam   IO lambda workspace
+ * return : none
+ *-----------------------------------------------------------------------------*/
+extern void lambda_free(lambda_t *lam)
+{
+    free(lam->L);
+    free(lam->work);
+    lam->L = lam->D = lam->a = lam->w = lam->work = NULL;
+    lam->n = lam->nmax = lam->nwork = 0;
+}
@@ -22,6 +22,7 @@
  *           2016/06/10  1.9  add ant2-maxaveep,ant2-initrst
  *           2016/07/31  1.10 add out-outsingle,out-maxsolstd
  *           2017/06/14  1.11 add out-outvel
+ *           2026/10/16  1.12 add misc-rnxcache,misc-streamwin,misc-orbint
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
 #include <navlib.h>
@@ -182,6 +183,9 @@ EXPORT opt_t sysopts[] = {
     {"misc-rnxopt1", 2, (void *)prcopt_.rnxopt[0], ""},
     {"misc-rnxopt2", 2, (void *)prcopt_.rnxopt[1], ""},
     {"misc-pppopt", 2, (void *)prcopt_.pppopt, ""},
+    {"misc-rnxcache", 3, (void *)&prcopt_.rnxcache, SWTOPT},
+    {"misc-streamwin", 1, (void *)&prcopt_.streamwin, "s"},
+    {"misc-orbint", 1, (void *)&prcopt_.orbint, "s"},
 
     {"file-satantfile", 2, (void *)filopt_.satantp, ""},
     {"file-rcvantfile", 2, (void *)filopt_.rcvantp, ""},
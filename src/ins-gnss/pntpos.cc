@@ -14,6 +14,7 @@
  *           2012/12/25 1.3  add variable snr mask
  *           2014/05/26 1.4  support galileo and beidou
  *           2015/03/19 1.5  fix bug on ionosphere correction for GLO and BDS
+ *           2026/10/16 1.6  make ins states of estinspr() thread-local
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 
@@ -527,7 +528,7 @@ static int estinspr(const obsd_t *obs, int n, const double *rs, const double *dt
     int i, nx, nv, ns, stat = 0, irc = 0, IP;
     double *x, *R, *v, *H, *var, *P;
     const insopt_t *insopt = &opt->insopt;
-    static insstate_t inss = {0};
+    static thread_local insstate_t inss = {0};
 
     trace(3, "estinspr:\n");
 
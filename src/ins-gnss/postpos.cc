@@ -37,12 +37,37 @@
  *           2016/08/29  1.21 suppress warnings
  *           2016/10/10  1.22 fix bug on identification of file fopt->blq
  *           2017/06/13  1.23 add smoother of velocity solution
+ *           2026/10/16  1.24 read rinex obs and nav files in parallel
+ *                                enable cache of parsed input files
+ *                                add streaming input of obs data for forward
+ *                                processing
+ *                                run forward and backward passes of combined
+ *                                mode concurrently
+ *                                free ephemeris index with navigation data
+ *                                set interpolation interval of broadcast orbit
+ *           2026/10/17  1.25 no streaming input of obs data in ins and vo modes
+ *           2026/10/17  1.26 add streaming input of imu and gsof data for
+ *                            forward ins-gnss coupled processing
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 
 #define MAXPRCDAYS 100 /* max days of continuous processing */
 #define MAXINFILE 1000 /* max number of input files */
 #define MINEXPIRE 200
+#define STRKEEP 100    /* data kept before current index in streaming */
+
+typedef struct {            /* processing pass type */
+    int revs;               /* analysis direction (0:forward,1:backward) */
+    int iobsu;              /* current rover observation data index */
+    int iobsr;              /* current reference observation data index */
+    int isbs;               /* current sbas message index */
+    int ilex;               /* current lex message index */
+    sol_t *sol;             /* solutions of combined mode */
+    double *rb;             /* base positions of combined mode */
+    int nsol;               /* number of solutions of combined mode */
+    const prcopt_t *popt;   /* processing options of pass thread */
+    const solopt_t *sopt;   /* solution options of pass thread */
+} pass_t;
 
 /* constants/global variables ------------------------------------------------*/
 static pcvs_t pcvss = {0};        /* receiver antenna parameters */
@@ -57,26 +82,29 @@ static gsof_data_t gsof = {0};    /* gsof measurement data for ins-gnss coupled
 static int nepoch = 0;            /* number of observation epochs */
 static int nimu = 0;              /* number of imu measurements epochs */
 static int ngsof = 0;             /* number of gsof measurement data */
-static int iobsu = 0;             /* current rover observation data index */
-static int iobsr = 0;             /* current reference observation data index */
-static int isbs = 0;              /* current sbas message index */
-static int ilex = 0;              /* current lex message index */
 static int igsof = 0;             /* current gsof message index */
 static int iimu = 0;              /* current imu measurement data */
 static int revs = 0;              /* analysis direction (0:forward,1:backward) */
 static int aborts = 0;            /* abort status */
-static sol_t *solf;               /* forward solutions */
-static sol_t *solb;               /* backward solutions */
-static double *rbf;               /* forward base positions */
-static double *rbb;               /* backward base positions */
-static int isolf = 0;             /* current forward solutions index */
-static int isolb = 0;             /* current backward solutions index */
 static char proc_rov[64] = "";    /* rover for current processing */
 static char proc_base[64] = "";   /* base station for current processing */
 static char rtcm_file[1024] = ""; /* rtcm data file */
 static char rtcm_path[1024] = ""; /* rtcm data path */
 static rtcm_t rtcm;               /* rtcm control struct */
 static FILE *fp_rtcm = NULL;      /* rtcm data file pointer */
+static rnxstr_t strs[2];          /* rinex obs streams of rover and base */
+static int strpend[2] = {0};      /* stream epoch pending (1:pending,0:end) */
+static gtime_t strtime[2];        /* time of last epoch added by streams */
+static int nstrs = 0;             /* number of obs streams (0:batch input) */
+static double strwin = 0.0;       /* data window of streaming input (s) */
+static imustr_t imustr;           /* imu measurement data stream */
+static gsofstr_t gsofstr;         /* gsof message stream */
+static int imustrs = 0;           /* imu data stream opened (0:batch input) */
+static int gsofstrs = 0;          /* gsof message stream opened (0:batch input) */
+static int imupend = 0;           /* imu data pending (1:pending,0:end) */
+static int gsofpend = 0;          /* gsof message pending (1:pending,0:end) */
+static int imuweek = -1;          /* gps week added to streaming imu data time */
+static const prcopt_t *stropt;    /* processing options of imu data stream */
 
 /* show message and check break ----------------------------------------------*/
 static int checkbrk(const char *format, ...)
@@ -183,7 +211,10 @@ static void outheader(FILE *fp, char **file, int n, const prcopt_t *popt, const
         time2str(ts, s2, 1);
         time2str(te, s3, 1);
         fprintf(fp, "%s obs start : %s %s (week%04d %8.1fs)\n", COMMENTH, s2, s1[sopt->times], w1, t1);
-        fprintf(fp, "%s obs end   : %s %s (week%04d %8.1fs)\n", COMMENTH, s3, s1[sopt->times], w2, t2);
+        if (popt->mode >= PMODE_INS_UPDATE ? imustrs <= 0 : nstrs <= 0)
+        { /* obs end unknown in streaming input */
+            fprintf(fp, "%s obs end   : %s %s (week%04d %8.1fs)\n", COMMENTH, s3, s1[sopt->times], w2, t2);
+        }
     }
     if (sopt->outopt)
     {
@@ -200,13 +231,255 @@ static void outheader(FILE *fp, char **file, int n, const prcopt_t *popt, const
 
     outsolhead(fp, sopt, &popt->insopt);
 }
+/* adjust imu data to frd-ned frame and add gps week to time ----------------*/
+static void adjimud(const prcopt_t *opt, int week, imud_t *data)
+{
+    double gyro[3], accl[3], dt = 1.0 / opt->insopt.hz;
+    int j;
+
+    /* add gps week to imu time */
+    data->time = timeadd(data->time, week * 604800.0);
+
+    if (opt->insopt.imucoors == IMUCOOR_RFU)
+    { /* convert to frd-ned-frame */
+        matcpy(gyro, data->gyro, 1, 3);
+        matcpy(accl, data->accl, 1, 3);
+        matmul("NN", 3, 1, 3, 1.0, Crf, gyro, 0.0, data->gyro);
+        matmul("NN", 3, 1, 3, 1.0, Crf, accl, 0.0, data->accl);
+    }
+    if (opt->insopt.imudecfmt == IMUDECFMT_INCR)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            data->gyro[j] /= dt;
+            data->accl[j] /= dt; /* convert to rate/acceleration */
+        }
+    }
+    if (opt->insopt.imuvalfmt == IMUVALFMT_DEG)
+    {
+        for (j = 0; j < 3; j++)
+            data->gyro[j] *= D2R; /* convert to rad */
+    }
+}
+/* add next streaming imu data -----------------------------------------------*/
+static int pullimu(const gtime_t *tmax)
+{
+    double tt;
+
+    if (!imupend || (tmax && timediff(imustr.data.time, *tmax) > DTTOL))
+        return 0;
+
+    tt = imu.n > 0 ? timediff(imustr.data.time, imu.data[imu.n - 1].time) : 1.0;
+
+    if (tt > 0.0)
+    {
+        if (addimudata(&imu, &imustr.data) < 0)
+        {
+            imupend = gsofpend = 0;
+            return 0;
+        }
+    }
+    else if (tt < 0.0)
+    {
+        trace(2, "imu data not in time order: time=%s\n", time_str(imustr.data.time, 3));
+    }
+    if ((imupend = input_imustr(&imustr)) && imuweek >= 0)
+    {
+        adjimud(stropt, imuweek, &imustr.data);
+    }
+    return 1;
+}
+/* add next streaming gsof message -------------------------------------------*/
+static int pullgsof(const gtime_t *tmax)
+{
+    gsof_t *data;
+    double tt;
+
+    if (!gsofpend || (tmax && timediff(gsofstr.data.t, *tmax) > DTTOL))
+        return 0;
+
+    tt = gsof.n > 0 ? timediff(gsofstr.data.t, gsof.data[gsof.n - 1].t) : 1.0;
+
+    if (tt > 0.0)
+    {
+        if (gsof.n >= gsof.nmax)
+        {
+            gsof.nmax = gsof.nmax <= 0 ? 64 : gsof.nmax * 2;
+            if (!(data = (gsof_t *)realloc(gsof.data, sizeof(gsof_t) * gsof.nmax)))
+            {
+                trace(1, "insufficient memory\n");
+                free(gsof.data);
+                gsof.data = NULL;
+                gsof.n = gsof.nmax = 0;
+                imupend = gsofpend = 0;
+                return 0;
+            }
+            gsof.data = data;
+        }
+        gsof.data[gsof.n++] = gsofstr.data;
+    }
+    else if (tt < 0.0)
+    {
+        trace(2, "gsof message not in time order: time=%s\n", time_str(gsofstr.data.t, 3));
+    }
+    gsofpend = input_gsofstr(&gsofstr);
+    return 1;
+}
+/* input streaming imu and gsof data up to time ------------------------------*/
+static void pullins(gtime_t tmax)
+{
+    if (imustrs <= 0)
+        return;
+
+    while (pullimu(&tmax))
+        ;
+    while (pullgsof(&tmax))
+        ;
+}
+/* input streaming imu and gsof data up to window after imu index ------------*/
+static void fillins(int i)
+{
+    if (imustrs <= 0)
+        return;
+
+    while (i >= imu.n && pullimu(NULL))
+        ;
+    if (i < imu.n)
+        pullins(timeadd(imu.data[i].time, strwin));
+}
+/* extend streaming imu and gsof data by buffered time span (at least window) */
+static int growins(void)
+{
+    gtime_t time;
+    double tt;
+    int n = imu.n, m = gsof.n;
+
+    if (imustrs <= 0 || imu.n <= 0)
+        return 0;
+
+    time = imupend ? imustr.data.time : imu.data[imu.n - 1].time;
+    tt = timediff(time, imu.data[0].time);
+
+    pullins(timeadd(time, MAX(tt, strwin)));
+
+    return imu.n > n || gsof.n > m;
+}
+/* discard streaming imu and gsof data before current index ------------------*/
+static void compactins(void)
+{
+    int n;
+
+    if (imustrs <= 0)
+        return;
+
+    if ((n = iimu - STRKEEP) > 0 && n >= imu.n / 2)
+    {
+        trace(4, "compactins: n=%d nimu=%d\n", n, imu.n);
+
+        memmove(imu.data, imu.data + n, sizeof(imud_t) * (imu.n - n));
+        imu.n -= n;
+        iimu -= n;
+    }
+    if (gsofstrs > 0 && (n = igsof - STRKEEP) > 0 && n >= gsof.n / 2)
+    {
+        trace(4, "compactins: n=%d ngsof=%d\n", n, gsof.n);
+
+        memmove(gsof.data, gsof.data + n, sizeof(gsof_t) * (gsof.n - n));
+        gsof.n -= n;
+        igsof -= n;
+    }
+}
+/* add next epoch of streaming obs data --------------------------------------*/
+static int pullobs(const gtime_t *tmax)
+{
+    obs_t obs = {0};
+    int i, j = -1, n = obss.n;
+
+    /* select stream of earliest epoch (rover first at same time) */
+    for (i = 0; i < nstrs; i++)
+    {
+        if (strpend[i] && (j < 0 || timediff(strs[i].time, strs[j].time) < -DTTOL))
+            j = i;
+    }
+    if (j < 0 || (tmax && timediff(strs[j].time, *tmax) > DTTOL))
+        return 0;
+
+    if (strtime[j].time == 0 || timediff(strs[j].time, strtime[j]) > DTTOL)
+    {
+        for (i = 0; i < strs[j].n; i++)
+        {
+            if (addobsdata(&obss, strs[j].data + i) < 0)
+            {
+                trace(1, "insufficient memory\n");
+                strpend[0] = strpend[1] = 0;
+                return 0;
+            }
+        }
+        /* sort epoch by satellite and delete duplicated data */
+        obs.data = obss.data + n;
+        obs.n = obss.n - n;
+        sortobs(&obs);
+        obss.n = n + obs.n;
+        strtime[j] = strs[j].time;
+
+        /* input streaming imu and gsof data up to window after epoch */
+        pullins(timeadd(strtime[j], strwin));
+    }
+    else
+    {
+        trace(2, "obs epoch not in time order: rcv=%d time=%s\n", strs[j].rcv, time_str(strs[j].time, 3));
+    }
+    strpend[j] = input_rnxstr(strs + j) > 0;
+    return 1;
+}
+/* input streaming obs data up to window after index -------------------------*/
+static void fillobs(int i)
+{
+    gtime_t tmax;
+
+    if (nstrs <= 0)
+        return;
+
+    while (i >= obss.n && pullobs(NULL))
+        ;
+    if (i >= obss.n)
+        return;
+
+    tmax = timeadd(obss.data[i].time, strwin);
+    while (pullobs(&tmax))
+        ;
+}
+/* add next epoch of streaming obs data while receiver stream not end --------*/
+static int pullrcv(const obs_t *obs, int rcv)
+{
+    return obs == &obss && 1 <= rcv && rcv <= nstrs && strpend[rcv - 1] && pullobs(NULL);
+}
+/* discard streaming obs data before current index ---------------------------*/
+static void compactobs(pass_t *pas)
+{
+    int n = MIN(pas->iobsu, pas->iobsr) - STRKEEP;
+
+    if (nstrs <= 0 || n <= 0 || n < obss.n / 2)
+        return;
+
+    trace(4, "compactobs: n=%d nobs=%d\n", n, obss.n);
+
+    memmove(obss.data, obss.data + n, sizeof(obsd_t) * (obss.n - n));
+    obss.n -= n;
+    pas->iobsu -= n;
+    pas->iobsr -= n;
+}
 /* search next observation data index ----------------------------------------*/
 extern int nextobsf(const obs_t *obs, int *i, int rcv)
 {
     double tt;
     int n;
 
-    for (; *i < obs->n; (*i)++)
+    /* input streaming obs data */
+    if (obs == &obss)
+        fillobs(*i);
+
+    for (; *i < obs->n || pullrcv(obs, rcv); (*i)++)
         if (obs->data[*i].rcv == rcv)
             break;
     for (n = 0; *i + n < obs->n; n++)
@@ -308,16 +581,16 @@ static int sysncimugsof(const imu_t *imu, const gsof_data_t *gsof, int direction
     return direction == 0 ? (iimu = i) < imu->n && (igsof = j) < gsof->n : (iimu = i) >= 0 && (igsof = j) >= 0;
 }
 /* input obs data, navigation messages and sbas correction -------------------*/
-static int inputobs(obsd_t *obs, int solq, const prcopt_t *popt)
+static int inputobs(pass_t *pas, obsd_t *obs, int solq, const prcopt_t *popt)
 {
     gtime_t time = {0};
     int i, nu, nr, n = 0;
 
-    trace(3, "infunc  : revs=%d iobsu=%d iobsr=%d isbs=%d\n", revs, iobsu, iobsr, isbs);
+    trace(3, "infunc  : revs=%d iobsu=%d iobsr=%d isbs=%d\n", pas->revs, pas->iobsu, pas->iobsr, pas->isbs);
 
-    if (0 <= iobsu && iobsu < obss.n)
+    if (0 <= pas->iobsu && pas->iobsu < obss.n)
     {
-        settime((time = obss.data[iobsu].time));
+        settime((time = obss.data[pas->iobsu].time));
         if (checkbrk("processing : %s Q=%d", time_str(time, 0), solq))
         {
             aborts = 1;
@@ -325,55 +598,57 @@ static int inputobs(obsd_t *obs, int solq, const prcopt_t *popt)
             return -1;
         }
     }
-    if (!revs)
+    if (!pas->revs)
     { /* input forward data */
-        if ((nu = nextobsf(&obss, &iobsu, 1)) <= 0)
+        compactobs(pas);
+
+        if ((nu = nextobsf(&obss, &pas->iobsu, 1)) <= 0)
             return -1;
         if (popt->intpref)
         {
-            for (; (nr = nextobsf(&obss, &iobsr, 2)) > 0; iobsr += nr)
-                if (timediff(obss.data[iobsr].time, obss.data[iobsu].time) > -DTTOL)
+            for (; (nr = nextobsf(&obss, &pas->iobsr, 2)) > 0; pas->iobsr += nr)
+                if (timediff(obss.data[pas->iobsr].time, obss.data[pas->iobsu].time) > -DTTOL)
                     break;
         }
         else
         {
-            for (i = iobsr; (nr = nextobsf(&obss, &i, 2)) > 0; iobsr = i, i += nr)
-                if (timediff(obss.data[i].time, obss.data[iobsu].time) > DTTOL)
+            for (i = pas->iobsr; (nr = nextobsf(&obss, &i, 2)) > 0; pas->iobsr = i, i += nr)
+                if (timediff(obss.data[i].time, obss.data[pas->iobsu].time) > DTTOL)
                     break;
         }
-        nr = nextobsf(&obss, &iobsr, 2);
+        nr = nextobsf(&obss, &pas->iobsr, 2);
         if (nr <= 0)
         {
-            nr = nextobsf(&obss, &iobsr, 2);
+            nr = nextobsf(&obss, &pas->iobsr, 2);
         }
         for (i = 0; i < nu && n < MAXOBS * 2; i++)
-            obs[n++] = obss.data[iobsu + i];
+            obs[n++] = obss.data[pas->iobsu + i];
         for (i = 0; i < nr && n < MAXOBS * 2; i++)
-            obs[n++] = obss.data[iobsr + i];
-        iobsu += nu;
+            obs[n++] = obss.data[pas->iobsr + i];
+        pas->iobsu += nu;
 
         /* update sbas corrections */
-        while (isbs < sbss.n)
+        while (pas->isbs < sbss.n)
         {
-            time = gpst2time(sbss.msgs[isbs].week, sbss.msgs[isbs].tow);
+            time = gpst2time(sbss.msgs[pas->isbs].week, sbss.msgs[pas->isbs].tow);
 
-            if (getbitu(sbss.msgs[isbs].msg, 8, 6) != 9)
+            if (getbitu(sbss.msgs[pas->isbs].msg, 8, 6) != 9)
             { /* except for geo nav */
-                sbsupdatecorr(sbss.msgs + isbs, &navs);
+                sbsupdatecorr(sbss.msgs + pas->isbs, &navs);
             }
             if (timediff(time, obs[0].time) > -1.0 - DTTOL)
                 break;
-            isbs++;
+            pas->isbs++;
         }
         /* update lex corrections */
-        while (ilex < lexs.n)
+        while (pas->ilex < lexs.n)
         {
-            if (lexupdatecorr(lexs.msgs + ilex, &navs, &time))
+            if (lexupdatecorr(lexs.msgs + pas->ilex, &navs, &time))
             {
                 if (timediff(time, obs[0].time) > -1.0 - DTTOL)
                     break;
             }
-            ilex++;
+            pas->ilex++;
         }
         /* update rtcm ssr corrections */
         if (*rtcm_file)
@@ -383,49 +658,49 @@ static int inputobs(obsd_t *obs, int solq, const prcopt_t *popt)
     }
     else
     { /* input backward data */
-        if ((nu = nextobsb(&obss, &iobsu, 1)) <= 0)
+        if ((nu = nextobsb(&obss, &pas->iobsu, 1)) <= 0)
             return -1;
         if (popt->intpref)
         {
-            for (; (nr = nextobsb(&obss, &iobsr, 2)) > 0; iobsr -= nr)
-                if (timediff(obss.data[iobsr].time, obss.data[iobsu].time) < DTTOL)
+            for (; (nr = nextobsb(&obss, &pas->iobsr, 2)) > 0; pas->iobsr -= nr)
+                if (timediff(obss.data[pas->iobsr].time, obss.data[pas->iobsu].time) < DTTOL)
                     break;
         }
         else
         {
-            for (i = iobsr; (nr = nextobsb(&obss, &i, 2)) > 0; iobsr = i, i -= nr)
-                if (timediff(obss.data[i].time, obss.data[iobsu].time) < -DTTOL)
+            for (i = pas->iobsr; (nr = nextobsb(&obss, &i, 2)) > 0; pas->iobsr = i, i -= nr)
+                if (timediff(obss.data[i].time, obss.data[pas->iobsu].time) < -DTTOL)
                     break;
         }
-        nr = nextobsb(&obss, &iobsr, 2);
+        nr = nextobsb(&obss, &pas->iobsr, 2);
         for (i = 0; i < nu && n < MAXOBS * 2; i++)
-            obs[n++] = obss.data[iobsu - nu + 1 + i];
+            obs[n++] = obss.data[pas->iobsu - nu + 1 + i];
         for (i = 0; i < nr && n < MAXOBS * 2; i++)
-            obs[n++] = obss.data[iobsr - nr + 1 + i];
-        iobsu -= nu;
+            obs[n++] = obss.data[pas->iobsr - nr + 1 + i];
+        pas->iobsu -= nu;
 
         /* update sbas corrections */
-        while (isbs >= 0)
+        while (pas->isbs >= 0)
         {
-            time = gpst2time(sbss.msgs[isbs].week, sbss.msgs[isbs].tow);
+            time = gpst2time(sbss.msgs[pas->isbs].week, sbss.msgs[pas->isbs].tow);
 
-            if (getbitu(sbss.msgs[isbs].msg, 8, 6) != 9)
+            if (getbitu(sbss.msgs[pas->isbs].msg, 8, 6) != 9)
             { /* except for geo nav */
-                sbsupdatecorr(sbss.msgs + isbs, &navs);
+                sbsupdatecorr(sbss.msgs + pas->isbs, &navs);
             }
             if (timediff(time, obs[0].time) < 1.0 + DTTOL)
                 break;
-            isbs--;
+            pas->isbs--;
         }
         /* update lex corrections */
-        while (ilex >= 0)
+        while (pas->ilex >= 0)
         {
-            if (lexupdatecorr(lexs.msgs + ilex, &navs, &time))
+            if (lexupdatecorr(lexs.msgs + pas->ilex, &navs, &time))
             {
                 if (timediff(time, obs[0].time) < 1.0 + DTTOL)
                     break;
             }
-            ilex--;
+            pas->ilex--;
         }
     }
     return n;
@@ -436,6 +711,12 @@ static int inputimu(imud_t *imudata, const prcopt_t *opt, imud_t *imuz, int ws)
     int i, k;
     gtime_t time;
 
+    /* input streaming imu and gsof data */
+    if (!revs)
+    {
+        compactins();
+        fillins(iimu + ws - 1);
+    }
     if (0 <= iimu && iimu < imu.n)
     {
         settime((time = imu.data[iimu].time));
@@ -569,6 +850,7 @@ static int detzerovel(const prcopt_t *popt, insstate_t *ins, int *inds, int *ind
     if (!detstatic(&imu, ins, &popt->insopt, &span, popt->insopt.zvopt.sp))
     {
         trace(2, "no zero velocity measurement \n");
+        free(span.tt);
         return 0;
     }
     /* choose max time-span of zero velocity */
@@ -584,6 +866,7 @@ static int detzerovel(const prcopt_t *popt, insstate_t *ins, int *inds, int *ind
     /* check synchronization */
     *inds = time2index(span.tt[j].ts, &imu);
     *inde = time2index(span.tt[j].te, &imu);
+    free(span.tt);
 
     if (*inde <= iimu + MINEXPIRE)
     {
@@ -747,6 +1030,10 @@ static int fnobs(gtime_t imut, int *iobs, const imu_t *imu, const obs_t *obs)
 
     if (!revs)
     { /* forward */
+        /* input streaming obs data up to imu time */
+        while (obs == &obss && pullobs(&imut))
+            ;
+
         for (i = *iobs - 100 < 0 ? 0 : *iobs - 50; i < obs->n; i++)
         {
             if (fabs(timediff(obs->data[i].time, imut)) < DTTOL)
@@ -776,10 +1063,14 @@ static void proclcgsof(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int
 
     trace(3, "procinsgsof : mode=%d\n", mode);
 
-    if (!sysncimugsof(&imu, &gsof, revs))
+    while (!sysncimugsof(&imu, &gsof, revs))
     {
-        trace(2, "synchronization of ins and gnss fail\n");
-        return;
+        /* extend streaming input and retry */
+        if (!growins())
+        {
+            trace(2, "synchronization of ins and gnss fail\n");
+            return;
+        }
     }
     rtkinit(&rtk, popt);
 
@@ -787,11 +1078,15 @@ static void proclcgsof(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int
     if (revs == 0)
     { /* forward */
 
-        if (!initinspva(popt, &rtk.ins, &gs))
+        while (!initinspva(popt, &rtk.ins, &gs))
         {
-            trace(2, "initial ins state fail\n");
-            rtkfree(&rtk);
-            return;
+            /* extend streaming input and retry */
+            if (!growins())
+            {
+                trace(2, "initial ins state fail\n");
+                rtkfree(&rtk);
+                return;
+            }
         }
     }
     else
@@ -910,16 +1205,19 @@ static void proclcobs(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int
     rtk_t rtk = {{0}};
     gmea_t gmeas = {0};
     obsd_t obs[MAXOBS * 2]; /* for rover and base */
+    pass_t pas = {0};
     int ws, flag = 0, nobs, i, n, stat = 0, nc = 0, zf = 0;
     double pos[3];
 
     trace(3, "proclcobs:\n");
 
+    pas.revs = revs;
+
     /* initial ins states */
     rtkinit(&rtk, popt);
 
     /* initial ins states */
-    if (!initcapv(&obss, &navs, &imu, popt, &rtk.ins, &iobsu, &iobsr, &iimu))
+    if (!initcapv(&obss, &navs, &imu, popt, &rtk.ins, &pas.iobsu, &pas.iobsr, &iimu))
     {
         trace(2, "initial ins states fail\n");
         rtkfree(&rtk);
@@ -938,11 +1236,11 @@ static void proclcobs(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int
             continue;
 
         /* match observation for imu measurement data */
-        flag = fnobs(imus.time, &iobsu, &imu, &obss);
+        flag = fnobs(imus.time, &pas.iobsu, &imu, &obss);
 
         if (flag)
         {
-            nobs = inputobs(obs, rtk.sol.stat, popt);
+            nobs = inputobs(&pas, obs, rtk.sol.stat, popt);
 
             if (nobs)
             {
@@ -1071,13 +1369,16 @@ static void proctcpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int
     rtk_t rtk;
     imud_t imus, *imuz;
     obsd_t obs[MAXOBS * 2]; /* for rover and base */
+    pass_t pas = {0};
 
     trace(3, "proctcpos:\n");
 
+    pas.revs = revs;
+
     rtkinit(&rtk, popt);
 
     /* initial ins states */
-    if (!initcapv(&obss, &navs, &imu, &rtk.opt, &rtk.ins, &iobsu, &iobsr, &iimu))
+    if (!initcapv(&obss, &navs, &imu, &rtk.opt, &rtk.ins, &pas.iobsu, &pas.iobsr, &iimu))
     {
         trace(2, "initial ins states fail\n");
         rtkfree(&rtk);
@@ -1096,12 +1397,12 @@ static void proctcpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int
             continue;
 
         /* match observation for imu measurement data */
-        flag = fnobs(imus.time, &iobsu, &imu, &obss);
+        flag = fnobs(imus.time, &pas.iobsu, &imu, &obss);
 
         if (flag)
         {
             /* observation data */
-            nobs = inputobs(obs, rtk.sol.stat, popt);
+            nobs = inputobs(&pas, obs, rtk.sol.stat, popt);
 
             if (nobs)
             {
@@ -1194,7 +1495,7 @@ static void proctcpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int
     free(imuz);
 }
 /* process positioning -------------------------------------------------------*/
-static void procpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int mode)
+static void procpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, pass_t *pas, int mode)
 {
     gtime_t time = {0};
     sol_t sol = {{0}};
@@ -1208,9 +1509,10 @@ static void procpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int mo
     solstatic = sopt->solstatic && (popt->mode == PMODE_STATIC || popt->mode == PMODE_PPP_STATIC);
 
     rtkinit(&rtk, popt);
-    rtcm_path[0] = '\0';
+    if (!pas->revs)
+        rtcm_path[0] = '\0';
 
-    while ((nobs = inputobs(obs, rtk.sol.stat, popt)) >= 0)
+    while ((nobs = inputobs(pas, obs, rtk.sol.stat, popt)) >= 0)
     {
 
         /* exclude satellites */
@@ -1257,23 +1559,14 @@ static void procpos(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, int mo
                 }
             }
         }
-        else if (!revs)
-        { /* combined-forward */
-            if (isolf >= nepoch)
-                return;
-            solf[isolf] = rtk.sol;
-            for (i = 0; i < 3; i++)
-                rbf[i + isolf * 3] = rtk.rb[i];
-            isolf++;
-        }
         else
-        { /* combined-backward */
-            if (isolb >= nepoch)
+        { /* combined-forward/backward */
+            if (pas->nsol >= nepoch)
                 return;
-            solb[isolb] = rtk.sol;
+            pas->sol[pas->nsol] = rtk.sol;
             for (i = 0; i < 3; i++)
-                rbb[i + isolb * 3] = rtk.rb[i];
-            isolb++;
+                pas->rb[i + pas->nsol * 3] = rtk.rb[i];
+            pas->nsol++;
         }
     }
     if (mode == 0 && solstatic && time.time != 0.0)
@@ -1311,10 +1604,13 @@ static int valcomb(const sol_t *solf, const sol_t *solb)
     return 1;
 }
 /* combine forward/backward solutions and output results ---------------------*/
-static void combres(FILE *fp, const prcopt_t *popt, const solopt_t *sopt)
+static void combres(FILE *fp, const prcopt_t *popt, const solopt_t *sopt, const pass_t *pf, const pass_t *pb)
 {
     gtime_t time = {0};
     sol_t sols = {{0}}, sol = {{0}};
+    const sol_t *solf = pf->sol, *solb = pb->sol;
+    const double *rbf = pf->rb, *rbb = pb->rb;
+    int isolf = pf->nsol, isolb = pb->nsol;
     double tt, Qf[9], Qb[9], Qs[9], rbs[3] = {0}, rb[3] = {0}, rr_f[3], rr_b[3], rr_s[3];
     int i, j, k, solstatic, pri[] = {0, 1, 2, 3, 4, 5, 1, 6};
 
@@ -1443,6 +1739,52 @@ static void combres(FILE *fp, const prcopt_t *popt, const solopt_t *sopt)
         outsol(fp, &sol, rb, sopt, NULL, &popt->insopt);
     }
 }
+/* backward pass of combined mode --------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI procbwd(void *arg)
+#else
+static void *procbwd(void *arg)
+#endif
+{
+    pass_t *pas = (pass_t *)arg;
+
+    procpos(NULL, pas->popt, pas->sopt, pas, 1);
+    return 0;
+}
+/* forward and backward passes of combined mode ------------------------------*/
+static void proccomb(const prcopt_t *popt, const solopt_t *sopt, pass_t *pf, pass_t *pb)
+{
+    thread_t thread;
+    int conc;
+
+    /* run backward pass concurrently unless passes share ins states, the rtk
+       status file or sbas, lex and ssr corrections updated in navs */
+    conc = popt->mode < PMODE_INS_UPDATE && sopt->sstat <= 0 && sbss.n <= 0 && lexs.n <= 0 && !*rtcm_file;
+
+    trace(3, "proccomb: conc=%d\n", conc);
+
+    if (conc)
+    {
+#ifdef WIN32
+        conc = (thread = CreateThread(NULL, 0, procbwd, pb, 0, NULL)) != NULL;
+#else
+        conc = !pthread_create(&thread, NULL, procbwd, pb);
+#endif
+    }
+    procpos(NULL, popt, sopt, pf, 1); /* forward */
+
+    if (!conc)
+    {
+        procbwd(pb); /* backward */
+        return;
+    }
+#ifdef WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
 /* read prec ephemeris, sbas data, lex data, tec grid and open rtcm ----------*/
 static void readpreceph(char **infile, int n, const prcopt_t *prcopt, nav_t *nav, sbs_t *sbs, lex_t *lex)
 {
@@ -1549,9 +1891,7 @@ static void freepreceph(nav_t *nav, sbs_t *sbs, lex_t *lex)
     free(nav->fcb);
     nav->fcb = NULL;
     nav->nf = nav->nfmax = 0;
-    free(nav->seph);
-    nav->seph = NULL;
-    nav->ns = nav->nsmax = 0;
+    freenav(nav, 0x04);
     free(sbs->msgs);
     sbs->msgs = NULL;
     sbs->n = sbs->nmax = 0;
@@ -1571,11 +1911,115 @@ static void freepreceph(nav_t *nav, sbs_t *sbs, lex_t *lex)
         fclose(fp_rtcm);
     free_rtcm(&rtcm);
 }
+/* close obs streams ---------------------------------------------------------*/
+static void closeobsstr(void)
+{
+    int i;
+
+    for (i = 0; i < nstrs; i++)
+        close_rnxstr(strs + i);
+    nstrs = 0;
+}
+/* open obs streams and read nav data ------------------------------------------
+ * open rinex obs files of rover and base as streams and read nav data for
+ * streaming forward processing. obs data are input epoch by epoch in time
+ * order while processing and only the window of prcopt->streamwin (s) after
+ * current epoch and STRKEEP data before it are kept in obss. in ins-gnss
+ * coupled modes imu data are streamed along with obs data (see openimustr()).
+ * vo and ins update modes which read image data in full are not applicable
+ * return : status (1:ok,0:error,-1:streaming not applicable)
+ *-----------------------------------------------------------------------------*/
+static int openobsstr(gtime_t ts, gtime_t te, double ti, char **infile, const int *index, int n, prcopt_t *prcopt,
+                      obs_t *obs, nav_t *nav, sta_t *sta)
+{
+    const char *opt[2] = {prcopt->rnxopt[0], prcopt->rnxopt[1]};
+    char *navfile[MAXINFILE];
+    int i, j, k, m = 0, navindex[MAXINFILE];
+
+    trace(3, "openobsstr: n=%d win=%.0f\n", n, prcopt->streamwin);
+
+    /* no streaming for vo and ins update modes */
+    if (prcopt->mode > PMODE_PPP_FIXED && prcopt->mode != PMODE_INS_LGNSS && prcopt->mode != PMODE_INS_TGNSS)
+        return -1;
+
+    /* no streaming for stdin */
+    for (i = 0; i < n; i++)
+    {
+        if (!*infile[i])
+            return -1;
+    }
+    closeobsstr();
+    strwin = prcopt->streamwin;
+
+    /* open obs streams of first two receivers */
+    for (i = 0; i < n && m < MAXINFILE; i = j)
+    {
+        for (j = i + 1; j < n && index[j] == index[i]; j++)
+            ;
+        if (nstrs < 2 && open_rnxstr(strs + nstrs, infile + i, j - i, nstrs + 1, ts, te, ti, opt[nstrs ? 1 : 0], nav,
+                                     sta + nstrs))
+        {
+            nstrs++;
+            continue;
+        }
+        for (k = i; k < j && m < MAXINFILE; k++)
+        {
+            navfile[m] = infile[k];
+            navindex[m++] = index[k];
+        }
+    }
+    /* read rinex nav files */
+    if (readrnxm(navfile, navindex, m, ts, te, ti, opt, NULL, nav, NULL) < 0)
+    {
+        checkbrk("error : insufficient memory");
+        trace(1, "insufficient memory\n");
+        closeobsstr();
+        return 0;
+    }
+    /* input first window of obs data */
+    for (i = 0; i < nstrs; i++)
+    {
+        strpend[i] = input_rnxstr(strs + i) > 0;
+        strtime[i].time = 0;
+        strtime[i].sec = 0.0;
+    }
+    fillobs(0);
+
+    if (obs->n <= 0)
+    {
+        checkbrk("error : no obs data");
+        trace(1, "\n");
+        closeobsstr();
+        return 0;
+    }
+    if (nav->n <= 0 && nav->ng <= 0 && nav->ns <= 0)
+    {
+        checkbrk("error : no nav data");
+        trace(1, "\n");
+        closeobsstr();
+        return 0;
+    }
+    /* observation signal index for rover and base */
+    for (i = 0; i < 2; i++)
+    {
+        for (j = 0; j < 7 && i < nstrs; j++)
+            obs->sind[i][j] = strs[i].sind[j];
+        for (j = 0; j < 7; j++)
+            prcopt->sind[i][j] = obs->sind[i][j];
+        for (j = 0; j < 7; j++)
+            navs.sind[i][j] = obs->sind[i][j];
+    }
+    /* delete duplicated ephemeris */
+    uniqnav(nav);
+
+    return 1;
+}
 /* read obs and nav data -----------------------------------------------------*/
 static int readobsnav(gtime_t ts, gtime_t te, double ti, char **infile, const int *index, int n, prcopt_t *prcopt,
                       obs_t *obs, nav_t *nav, sta_t *sta)
 {
-    int i, j, ind = 0, nobs = 0, rcv = 1;
+    const char *opt[2] = {prcopt->rnxopt[0], prcopt->rnxopt[1]};
+    int i, j, stat;
 
     trace(3, "readobsnav: ts=%s n=%d\n", time_str(ts, 0), n);
 
@@ -1589,26 +2033,21 @@ static int readobsnav(gtime_t ts, gtime_t te, double ti, char **infile, const in
     nav->ns = nav->nsmax = 0;
     nepoch = 0;
 
-    for (i = 0; i < n; i++)
-    {
-        if (checkbrk(""))
-            return 0;
+    if (checkbrk(""))
+        return 0;
 
-        if (index[i] != ind)
-        {
-            if (obs->n > nobs)
-                rcv++;
-            ind = index[i];
-            nobs = obs->n;
-        }
-        /* read rinex obs and nav file */
-        if (readrnxt(infile[i], rcv, ts, te, ti, prcopt->rnxopt[rcv <= 1 ? 0 : 1], obs, nav,
-                     rcv <= 2 ? sta + rcv - 1 : NULL) < 0)
-        {
-            checkbrk("error : insufficient memory");
-            trace(1, "insufficient memory\n");
-            return 0;
-        }
+    /* open obs streams for forward processing */
+    if (prcopt->streamwin > 0.0 && (prcopt->mode == PMODE_SINGLE || prcopt->soltype == 0) &&
+        (stat = openobsstr(ts, te, ti, infile, index, n, prcopt, obs, nav, sta)) >= 0)
+    {
+        return stat;
+    }
+    /* read rinex obs and nav files */
+    if (readrnxm(infile, index, n, ts, te, ti, opt, obs, nav, sta) < 0)
+    {
+        checkbrk("error : insufficient memory");
+        trace(1, "insufficient memory\n");
+        return 0;
     }
     if (obs->n <= 0)
     {
@@ -1656,47 +2095,48 @@ static int readobsnav(gtime_t ts, gtime_t te, double ti, char **infile, const in
     }
     return 1;
 }
-/* adjust imu measurement data to frd-ned-frame and get imu time---------------
- * args    :  prcopt_t *opt  I   ins options
- *            imu_t *imu     IO  imu measurement data
- * return  : none
- * ---------------------------------------------------------------------------*/
-extern void adjimudata(const prcopt_t *opt, imu_t *imu)
+/* gps week of imu measurement data by gsof message or observation data ------*/
+static int imugpsweek(const imu_t *imu, int *week)
 {
-    int i, j, week, flag = 0;
-    double gyro[3], accl[3], dt = 1.0 / opt->insopt.hz, sg, si, so;
-
-    trace(3, "adjimudata:\n");
+    int i, j;
+    double sg, si, so;
 
     /* obtain gps week from gsof message for adjust imu time */
-    for (i = 0; i < gsof.n && !flag; i++)
+    for (i = 0; i < gsof.n; i++)
     {
-        sg = time2gpst(gsof.data[i].t, &week);
+        sg = time2gpst(gsof.data[i].t, week);
         for (j = 0; j < imu->n; j++)
         {
             si = time2gpst(imu->data[j].time, NULL);
             if (fabs(si - sg) <= DTTOL)
-            {
-                flag = 1;
-                break;
-            }
+                return 1;
         }
     }
     /* obtain gps week from observation data */
-    for (i = 0; i < imu->n && !flag; i++)
+    for (i = 0; i < imu->n; i++)
     {
         si = time2gpst(imu->data[i].time, NULL);
         for (j = 0; j < obss.n; j++)
         {
-            so = time2gpst(obss.data[j].time, &week);
+            so = time2gpst(obss.data[j].time, week);
             if (fabs(si - so) <= DTTOL)
-            {
-                flag = 1;
-                break;
-            }
+                return 1;
         }
     }
-    if (!flag)
+    return 0;
+}
+/* adjust imu measurement data to frd-ned-frame and get imu time---------------
+ * args    :  prcopt_t *opt  I   ins options
+ *            imu_t *imu     IO  imu measurement data
+ * return  : none
+ * ---------------------------------------------------------------------------*/
+extern void adjimudata(const prcopt_t *opt, imu_t *imu)
+{
+    int i, week;
+
+    trace(3, "adjimudata:\n");
+
+    if (!imugpsweek(imu, &week))
     {
         trace(2, "imu and gsof measurement data synchro fail\n");
         return;
@@ -1704,31 +2144,137 @@ extern void adjimudata(const prcopt_t *opt, imu_t *imu)
     /* adjust imu data to frd-ned frame and convert to angular rate/acceleration */
     for (i = 0; i < imu->n; i++)
     {
+        adjimud(opt, week, imu->data + i);
+    }
+}
+/* close imu and gsof streams ------------------------------------------------*/
+static void closeinsstr(void)
+{
+    if (imustrs > 0)
+        close_imustr(&imustr);
+    if (gsofstrs > 0)
+        close_gsofstr(&gsofstr);
+    imustrs = gsofstrs = imupend = gsofpend = 0;
+    imuweek = -1;
+}
+/* check streaming input of imu and gsof data --------------------------------*/
+static int insstrmode(const prcopt_t *popt)
+{
+    if (popt->streamwin <= 0.0 || popt->soltype != 0)
+        return 0;
+    if (popt->mode == PMODE_INS_LGNSS && popt->insopt.lcopt == IGCOM_USEGSOF)
+        return 1;
 
-        /* add gps week to imu time */
-        imu->data[i].time = timeadd(imu->data[i].time, week * 604800.0);
+    /* imu data are streamed only along with obs streams */
+    return (popt->mode == PMODE_INS_LGNSS || popt->mode == PMODE_INS_TGNSS) && nstrs > 0;
+}
+/* open imu data stream --------------------------------------------------------
+ * open the last imu data file in input files as stream for forward ins-gnss
+ * coupled processing. imu data are input in time order while processing and
+ * only the window of prcopt->streamwin (s) after current data and STRKEEP data
+ * before it are kept in imu, as well as gsof messages of gsof stream in gsof.
+ * the gps week of imu data is obtained by the first window of imu data as
+ * adjimudata(), or else by the first gsof message or obs data. ins alignment
+ * extends the windows until it succeeds, so static alignment selects the
+ * zero velocity span in the data read up to then instead of all the data
+ * return : status (1:ok,0:error)
+ *-----------------------------------------------------------------------------*/
+static int openimustr(char **infile, int n, const prcopt_t *prcopt)
+{
+    gtime_t t, tmax;
+    double sg, si;
+    int i, week = 0;
 
-        if (opt->insopt.imucoors == IMUCOOR_RFU)
-        { /* convert to frd-ned-frame */
-            matcpy(gyro, imu->data[i].gyro, 1, 3);
-            matcpy(accl, imu->data[i].accl, 1, 3);
-            matmul("NN", 3, 1, 3, 1.0, Crf, gyro, 0.0, imu->data[i].gyro);
-            matmul("NN", 3, 1, 3, 1.0, Crf, accl, 0.0, imu->data[i].accl);
-        }
-        if (opt->insopt.imudecfmt == IMUDECFMT_INCR)
-        {
-            for (j = 0; j < 3; j++)
-            {
-                imu->data[i].gyro[j] /= dt;
-                imu->data[i].accl[j] /= dt; /* convert to rate/acceleration */
-            }
-        }
-        if (opt->insopt.imuvalfmt == IMUVALFMT_DEG)
+    trace(3, "openimustr: n=%d win=%.0f\n", n, prcopt->streamwin);
+
+    for (i = n - 1; i >= 0; i--)
+    {
+        if (!strstr(infile[i], "imu") || !open_imustr(&imustr, infile[i], prcopt->insopt.imuformat))
+            continue;
+        if ((imupend = input_imustr(&imustr)))
+            break;
+        close_imustr(&imustr);
+    }
+    if (i < 0)
+        return 0;
+
+    imustrs = 1;
+    imuweek = -1;
+    stropt = prcopt;
+    strwin = prcopt->streamwin;
+
+    /* input first window of imu data */
+    tmax = timeadd(imustr.data.time, strwin);
+    while (pullimu(&tmax))
+        ;
+
+    /* gps week by first windows of gsof message or obs data */
+    if (!imugpsweek(&imu, &week))
+    {
+        if (gsof.n > 0 || obss.n > 0)
         {
-            for (j = 0; j < 3; j++)
-                imu->data[i].gyro[j] *= D2R; /* convert to rad */
+            t = gsof.n > 0 ? gsof.data[0].t : obss.data[0].time;
+            sg = time2gpst(t, &week);
+            si = time2gpst(imu.data[0].time, NULL);
+            if (si - sg > 302400.0)
+                week--;
+            else if (si - sg < -302400.0)
+                week++;
         }
+        else
+            trace(2, "imu and gsof measurement data synchro fail\n");
+    }
+    for (i = 0; i < imu.n; i++)
+    {
+        adjimud(prcopt, week, imu.data + i);
     }
+    if (imupend)
+        adjimud(prcopt, week, &imustr.data);
+    imuweek = week;
+
+    /* input imu and gsof data up to window after first imu data */
+    fillins(0);
+
+    if (imu.n <= 0)
+    {
+        closeinsstr();
+        return 0;
+    }
+    return 1;
+}
+/* open gsof message stream --------------------------------------------------*/
+static int opengsofstr(char **infile, int n, const prcopt_t *prcopt)
+{
+    char *file[MAXINFILE];
+    gtime_t tmax;
+    int i, m = 0;
+
+    trace(3, "opengsofstr: n=%d win=%.0f\n", n, prcopt->streamwin);
+
+    for (i = 0; i < n && m < MAXINFILE; i++)
+    {
+        if (strstr(infile[i], "gsof"))
+            file[m++] = infile[i];
+    }
+    if (m <= 0 || !open_gsofstr(&gsofstr, file, m))
+        return 0;
+
+    gsofstrs = 1;
+    strwin = prcopt->streamwin;
+
+    /* input first window of gsof messages */
+    if ((gsofpend = input_gsofstr(&gsofstr)))
+    {
+        tmax = timeadd(gsofstr.data.t, strwin);
+        while (pullgsof(&tmax))
+            ;
+    }
+    if (gsof.n <= 0)
+    {
+        closeinsstr();
+        return 0;
+    }
+    return 1;
 }
 /* read imu measurements data-------------------------------------------------*/
 static int readimudata(char **infile, const int *index, int n, const prcopt_t *prcopt, imu_t *imu)
@@ -1740,6 +2286,17 @@ static int readimudata(char **infile, const int *index, int n, const prcopt_t *p
     imu->data = NULL;
     imu->n = imu->nmax = 0;
 
+    /* open imu data stream for forward processing */
+    if (insstrmode(prcopt))
+    {
+        if (!openimustr(infile, n, prcopt))
+        {
+            checkbrk("error : no obs data");
+            trace(1, "\n");
+            return 0;
+        }
+        return 1;
+    }
     for (i = 0; i < n; i++)
     {
         if (checkbrk(""))
@@ -1781,6 +2338,17 @@ static int readgsofs(char **infile, const int *index, int n, const prcopt_t *prc
     gsof->data = NULL;
     gsof->n = gsof->nmax = 0;
 
+    /* open gsof message stream for forward processing */
+    if (insstrmode(prcopt))
+    {
+        if (!opengsofstr(infile, n, prcopt))
+        {
+            checkbrk("error : no  data");
+            trace(1, "\n");
+            return 0;
+        }
+        return 1;
+    }
     for (i = 0; i < n; i++)
     {
         if (checkbrk(""))
@@ -1808,18 +2376,12 @@ static void freeobsnav(obs_t *obs, nav_t *nav)
 {
     trace(3, "freeobsnav:\n");
 
+    closeobsstr();
+
     free(obs->data);
     obs->data = NULL;
     obs->n = obs->nmax = 0;
-    free(nav->eph);
-    nav->eph = NULL;
-    nav->n = nav->nmax = 0;
-    free(nav->geph);
-    nav->geph = NULL;
-    nav->ng = nav->ngmax = 0;
-    free(nav->seph);
-    nav->seph = NULL;
-    nav->ns = nav->nsmax = 0;
+    freenav(nav, 0x07);
 }
 /* average of single position ------------------------------------------------*/
 static int avepos(double *ra, int rcv, const obs_t *obs, const nav_t *nav, const prcopt_t *opt)
@@ -1964,6 +2526,12 @@ static int openses(const prcopt_t *popt, const solopt_t *sopt, const filopt_t *f
 
     trace(3, "openses :\n");
 
+    /* cache of parsed obs, nav, sp3 and clock files */
+    setcache(popt->rnxcache);
+
+    /* interpolation of broadcast orbit */
+    setorbint(popt->orbint);
+
     /* read satellite antenna parameters */
     if (*fopt->satantp && !(readpcv(fopt->satantp, pcvs)))
     {
@@ -2117,6 +2685,7 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt, cons
 {
     FILE *fp;
     prcopt_t popt_ = *popt;
+    pass_t pf = {0}, pb = {0};
     char tracefile[1024], statfile[1024], path[1024];
     const char *ext;
 
@@ -2235,6 +2804,7 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt, cons
         if (!antpos(&popt_, 2, &obss, &navs, stas, fopt->stapos))
         {
             freeobsnav(&obss, &navs);
+            closeinsstr();
             freeimudata(&imu);
             freegsofdata(&gsof);
             return 0;
@@ -2252,18 +2822,27 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt, cons
     if (flag && !outhead(outfile, infile, n, &popt_, sopt))
     {
         freeobsnav(&obss, &navs);
+        closeinsstr();
         freeimudata(&imu);
         freegsofdata(&gsof);
         return 0;
     }
-    iobsu = iobsr = isbs = ilex = revs = aborts = 0;
+    revs = aborts = 0;
+
+    /* backward pass starts from last obs data and messages */
+    pb.revs = 1;
+    pb.iobsu = pb.iobsr = obss.n - 1;
+    pb.isbs = sbss.n - 1;
+    pb.ilex = lexs.n - 1;
+    pb.popt = &popt_;
+    pb.sopt = sopt;
 
     if (popt_.mode == PMODE_SINGLE || popt_.soltype == 0)
     { /* forward */
         if ((fp = openfile(outfile)))
         {
             if (popt_.mode < PMODE_INS_UPDATE)
-                procpos(fp, &popt_, sopt, 0);
+                procpos(fp, &popt_, sopt, &pf, 0);
             else if (popt_.mode == PMODE_INS_LGNSS)
             {
                 if (popt_.insopt.lcopt == IGCOM_USEGSOF)
@@ -2281,48 +2860,40 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt, cons
         if ((fp = openfile(outfile)))
         {
             revs = 1;
-            iobsu = iobsr = obss.n - 1;
-            isbs = sbss.n - 1;
-            ilex = lexs.n - 1;
-            procpos(fp, &popt_, sopt, 0);
+            procpos(fp, &popt_, sopt, &pb, 0);
             fclose(fp);
         }
     }
     else
     { /* combined */
-        solf = (sol_t *)malloc(sizeof(sol_t) * nepoch);
-        solb = (sol_t *)malloc(sizeof(sol_t) * nepoch);
-        rbf = (double *)malloc(sizeof(double) * nepoch * 3);
-        rbb = (double *)malloc(sizeof(double) * nepoch * 3);
+        pf.sol = (sol_t *)malloc(sizeof(sol_t) * nepoch);
+        pb.sol = (sol_t *)malloc(sizeof(sol_t) * nepoch);
+        pf.rb = (double *)malloc(sizeof(double) * nepoch * 3);
+        pb.rb = (double *)malloc(sizeof(double) * nepoch * 3);
 
-        if (solf && solb)
+        if (pf.sol && pb.sol)
         {
-            isolf = isolb = 0;
-            procpos(NULL, &popt_, sopt, 1); /* forward */
-            revs = 1;
-            iobsu = iobsr = obss.n - 1;
-            isbs = sbss.n - 1;
-            ilex = lexs.n - 1;
-            procpos(NULL, &popt_, sopt, 1); /* backward */
+            proccomb(&popt_, sopt, &pf, &pb);
 
             /* combine forward/backward solutions */
             if (!aborts && (fp = openfile(outfile)))
             {
-                combres(fp, &popt_, sopt);
+                combres(fp, &popt_, sopt, &pf, &pb);
                 fclose(fp);
             }
         }
         else
             showmsg("error : memory allocation");
-        free(solf);
-        free(solb);
-        free(rbf);
-        free(rbb);
+        free(pf.sol);
+        free(pb.sol);
+        free(pf.rb);
+        free(pb.rb);
     }
     /* free obs and nav data */
     freeobsnav(&obss, &navs);
 
     /* free imu measurement data and gsof data*/
+    closeinsstr();
     freeimudata(&imu);
     freegsofdata(&gsof);
 
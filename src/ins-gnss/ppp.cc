@@ -54,6 +54,7 @@
  *                           support support option opt->pppopt=-GAP_RESION=nnnn
  *           2016/01/22 1.12 delete support for yaw-model bug
  *                           add support for ura of ephemeris
+ *           2026/10/16 1.13 make previous ionosphere estimates thread-local
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 
@@ -1126,8 +1127,8 @@ static int model_trop(gtime_t time, const double *pos, const double *azel, const
 static int model_iono(gtime_t time, const double *pos, const double *azel, const prcopt_t *opt, int sat,
                       const double *x, const nav_t *nav, double *dion, double *var)
 {
-    static double iono_p[MAXSAT] = {0}, std_p[MAXSAT] = {0};
-    static gtime_t time_p;
+    static thread_local double iono_p[MAXSAT] = {0}, std_p[MAXSAT] = {0};
+    static thread_local gtime_t time_p;
     int ii, tc;
 
     /* tc=0: common rtk mode
@@ -1752,7 +1753,7 @@ extern void pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
             break;
         }
         /* measurement update of ekf states */
-        if ((info = filter(xp, Pp, H, v, R, nx, nv)))
+        if ((info = filter_seq(&rtk->ws, xp, Pp, H, v, R, nx, nv)))
         {
             trace(2, "%s ppp (%d) filter error info=%d\n", str, i + 1, info);
             break;
@@ -11,6 +11,7 @@
  *
  * version : $Revision:$ $Date:$
  * history : 2013/03/11 1.0  new
+ *           2026/10/17 1.1  use lambda workspace in rtk control struct
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
 
@@ -324,7 +325,7 @@ static int fix_sol(rtk_t *rtk, const int *sat1, const int *sat2, const double *N
         R[i + i * n] = SQR(CONST_AMB);
     }
     /* update states with constraints */
-    if ((info = filter(rtk->x, rtk->P, H, v, R, rtk->nx, n)))
+    if ((info = filter_ws(&rtk->ws, rtk->x, rtk->P, H, v, R, rtk->nx, n)))
     {
         trace(1, "filter error (info=%d)\n", info);
         free(v);
@@ -462,7 +463,7 @@ static int fix_amb_ILS(rtk_t *rtk, int *sat1, int *sat2, int *NW, int n)
     matmul("NN", m, m, rtk->nx, 1.0, E, D, 0.0, Q);
 
     /* integer least square */
-    if ((info = lambda(m, 2, B1, Q, N1, s)))
+    if ((info = lambda_init(&rtk->lam, m, B1, Q)) || (info = lambda_solve(&rtk->lam, 2, N1, s)))
     {
         trace(2, "lambda error: info=%d\n", info);
         return 0;
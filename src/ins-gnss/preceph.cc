@@ -39,6 +39,8 @@
  *           2015/05/10 1.15 add api readfcb()
  *                           modify api readdcb()
  *           2017/04/11 1.16 fix bug on antenna offset correction in peph2pos()
+ *           2026/10/16 1.17 load and save parsed sp3 files by cache
+ *           2026/10/17 1.18 update generation of navigation data in readsp3()
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
 
@@ -131,6 +133,26 @@ static int addpeph(nav_t *nav, peph_t *peph)
     nav->peph[nav->ne++] = *peph;
     return 1;
 }
+/* load precise ephemeris from cache ----------------------------------------*/
+static int loadsp3(cache_t *cache, int index, nav_t *nav)
+{
+    peph_t peph;
+    int i, n;
+
+    if (!getcache(cache, &n, 4) || n < 0 || cache->pos + (int)sizeof(peph_t) * n != cache->n)
+    {
+        trace(2, "sp3 cache read error\n");
+        return 0;
+    }
+    for (i = 0; i < n; i++)
+    {
+        getcache(cache, &peph, sizeof(peph_t));
+        peph.index = index;
+        if (!addpeph(nav, &peph))
+            return 0;
+    }
+    return 1;
+}
 /* read sp3 body -------------------------------------------------------------*/
 static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact, char *tsys, int index, int opt, nav_t *nav)
 {
@@ -306,9 +328,10 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
 {
     FILE *fp;
     gtime_t time = {0};
+    cache_t cache = {0};
     double bfact[2] = {0};
-    int i, j, n, ns, sats[MAXSAT] = {0};
-    char *efiles[MAXEXFILE], *ext, type = ' ', tsys[4] = "";
+    int i, j, n, ne, ns, cstat, sats[MAXSAT] = {0};
+    char *efiles[MAXEXFILE], *ext, type = ' ', tsys[4] = "", key[64];
 
     trace(3, "readpephs: file=%s\n", file);
 
@@ -332,6 +355,17 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
         if (!strstr(ext + 1, "sp3") && !strstr(ext + 1, ".SP3") && !strstr(ext + 1, "eph") && !strstr(ext + 1, ".EPH"))
             continue;
 
+        /* load precise ephemeris from cache */
+        sprintf(key, "sp3 opt=%d", opt);
+
+        if ((cstat = readcache(efiles[i], key, &cache)) > 0 && loadsp3(&cache, j, nav))
+        {
+            freecache(&cache);
+            j++;
+            continue;
+        }
+        freecache(&cache);
+
         if (!(fp = fopen(efiles[i], "r")))
         {
             trace(2, "sp3 file open error %s\n", efiles[i]);
@@ -341,9 +375,21 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
         ns = readsp3h(fp, &time, &type, sats, bfact, tsys);
 
         /* read sp3 body */
+        ne = nav->ne;
         readsp3b(fp, type, sats, ns, bfact, tsys, j++, opt, nav);
 
         fclose(fp);
+
+        /* save precise ephemeris of the file to cache */
+        if (cstat == 0 && nav->ne >= ne)
+        {
+            n = nav->ne - ne;
+            if (putcache(&cache, &n, 4) && putcache(&cache, nav->peph + ne, sizeof(peph_t) * n))
+            {
+                writecache(efiles[i], key, &cache);
+            }
+            freecache(&cache);
+        }
     }
     for (i = 0; i < MAXEXFILE; i++)
         free(efiles[i]);
@@ -351,6 +397,7 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
     /* combine precise ephemeris */
     if (nav->ne > 0)
         combpeph(nav, opt);
+    updnavgen();
 }
 /* read satellite antenna parameters -------------------------------------------
  * read satellite antenna parameters
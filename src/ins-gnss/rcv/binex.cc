@@ -93,14 +93,7 @@ static int getbnxi(unsigned char *p, unsigned int *val)
 /* checksum 8 parity ---------------------------------------------------------*/
 static unsigned char csum8(const unsigned char *buff, int len)
 {
-    unsigned char cs = 0;
-    int i;
-
-    for (i = 0; i < len; i++)
-    {
-        cs ^= buff[i];
-    }
-    return cs;
+    return rtk_xor8(buff, len);
 }
 /* adjust weekly rollover of gps time ----------------------------------------*/
 static gtime_t adjweek(gtime_t time, double tow)
@@ -1677,23 +1677,14 @@ static void CheckCmrFlags(cmr_t *Cmr, unsigned char *p)
 */
 static int CheckMessageChecksum(unsigned char *MessageBuffer)
 {
-    unsigned char Checksum = 0;
     unsigned char *p = &MessageBuffer[1];       /* Starting with status */
     unsigned int Length = MessageBuffer[3] + 3; /* status, type, length, data */
 
-    /* Compute the message checksum */
-    while (Length > 0)
-    {
-        Checksum += *p++;
-        Length--;
-    }
-
     /*
-    | Make sure our computed checksum matches the one at the end of the
-    | message. (Note that the above loop by design very conveniently left
-    | *p pointing to the checksum byte at the end of the message.)
+    | Compute the message checksum and make sure it matches the one at the
+    | end of the message, which immediately follows the summed bytes.
     */
-    return (Checksum == *p);
+    return ((unsigned char)rtk_sum8(p, Length) == p[Length]);
 }
 
 /* CheckMessageFlags - Check for a message */
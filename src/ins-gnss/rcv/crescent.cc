@@ -81,11 +81,8 @@ static double R8(unsigned char *p)
 /* checksum ------------------------------------------------------------------*/
 static int chksum(const unsigned char *buff, int len)
 {
-    unsigned short sum = 0;
-    int i;
+    unsigned short sum = (unsigned short)rtk_sum8(buff + 8, len - 12);
 
-    for (i = 8; i < len - 4; i++)
-        sum += buff[i];
     trace(4, "checksum=%02X%02X %02X%02X:%02X%02X\n", sum >> 8, sum & 0xFF, buff[len - 3], buff[len - 4], buff[len - 2],
           buff[len - 1]);
     return (sum >> 8) == buff[len - 3] && (sum & 0xFF) == buff[len - 4] && buff[len - 2] == 0x0D &&
@@ -6,6 +6,7 @@
  *
  * version : $Revision:$ $Date:$
  * history : 2017/10/27  1.0  new
+ *           2026/10/17  1.1  add gsof message stream functions
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 
@@ -248,11 +249,8 @@ static int chkhead(raw_t *raw)
 /* check sum of message ------------------------------------------------------*/
 static int chksum(raw_t *raw)
 {
-    unsigned char cs = 0;
-    int i;
-    for (i = 1; i < raw->len + 4; i++)
-        cs += raw->buff[i];
-    return cs % 256 == raw->buff[raw->len + 4] && raw->buff[raw->len + 5] == 0x03;
+    unsigned char cs = (unsigned char)rtk_sum8(raw->buff + 1, raw->len + 3);
+    return cs == raw->buff[raw->len + 4] && raw->buff[raw->len + 5] == 0x03;
 }
 /* decode gsof message--------------------------------------------------------*/
 static void decode_gsof(raw_t *raw)
@@ -515,6 +513,92 @@ extern int readgsoff(const char *file, gsof_data_t *gsof)
     fclose(fp);
     return gsof->n > 0;
 }
+/* open gsof message stream ----------------------------------------------------
+ * open gsof message files as stream. the files are input in the order given
+ * args   : gsofstr_t *str  O  gsof message stream
+ *          char **file     I  gsof message files
+ *          int n           I  number of files
+ * return : status (1:ok,0:error)
+ *-----------------------------------------------------------------------------*/
+extern int open_gsofstr(gsofstr_t *str, char **file, int n)
+{
+    int i;
+
+    trace(3, "open_gsofstr: n=%d\n", n);
+
+    memset(str, 0, sizeof(gsofstr_t));
+
+    if (n <= 0 || !(str->path = (char **)calloc(n, sizeof(char *))) ||
+        !(str->raw = (raw_t *)calloc(1, sizeof(raw_t))))
+    {
+        close_gsofstr(str);
+        return 0;
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (!(str->path[i] = (char *)malloc(strlen(file[i]) + 1)))
+        {
+            close_gsofstr(str);
+            return 0;
+        }
+        strcpy(str->path[i], file[i]);
+        str->np++;
+    }
+    return 1;
+}
+/* input gsof message from stream ----------------------------------------------
+ * input next gsof message from stream in the same way as readgsoff()
+ * args   : gsofstr_t *str  IO  gsof message stream
+ * return : status (1:ok,0:end of files)
+ *          str->data is set to the gsof message if ok
+ *-----------------------------------------------------------------------------*/
+extern int input_gsofstr(gsofstr_t *str)
+{
+    int data;
+
+    while (1)
+    {
+        if (!str->fp)
+        {
+            if (str->ip >= str->np)
+                return 0;
+            if (!(str->fp = fopen(str->path[str->ip++], "r")))
+            {
+                trace(2, "gsof file open error: %s\n", str->path[str->ip - 1]);
+                continue;
+            }
+            memset(str->raw, 0, sizeof(raw_t));
+        }
+        while ((data = fgetc(str->fp)) != EOF)
+        {
+            if (input_gsof(str->raw, (unsigned char)data))
+            {
+                str->data = str->raw->gsof;
+                return 1;
+            }
+        }
+        fclose(str->fp);
+        str->fp = NULL;
+    }
+}
+/* close gsof message stream -------------------------------------------------*/
+extern void close_gsofstr(gsofstr_t *str)
+{
+    int i;
+
+    trace(3, "close_gsofstr:\n");
+
+    if (str->fp)
+        fclose(str->fp);
+    str->fp = NULL;
+    for (i = 0; i < str->np; i++)
+        free(str->path[i]);
+    free(str->path);
+    str->path = NULL;
+    str->np = str->ip = 0;
+    free(str->raw);
+    str->raw = NULL;
+}
 /* free gsof measurement data------------------------------------------------*/
 extern void freegsofdata(gsof_data_t *data)
 {
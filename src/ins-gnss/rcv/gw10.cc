@@ -108,11 +108,7 @@ static int msglen(unsigned char id)
 /* compute checksum ----------------------------------------------------------*/
 static int chksum(const unsigned char *buff, int n)
 {
-    unsigned char cs = 0;
-    int i;
-    for (i = 1; i < n - 1; i++)
-        cs += buff[i];
-    return buff[n - 1] == cs;
+    return buff[n - 1] == (unsigned char)rtk_sum8(buff + 1, n - 2);
 }
 /* adjust weekly rollover of gps time ----------------------------------------*/
 static int adjweek(raw_t *raw, double tow)
@@ -76,11 +76,7 @@ static int chkhead(const unsigned char *buff, const unsigned char *head)
 /* checksum ------------------------------------------------------------------*/
 static unsigned char chksum(const unsigned char *buff, int len)
 {
-    int i;
-    unsigned char sum = 0;
-    for (i = 0; i < len; i++)
-        sum += buff[i];
-    return sum;
+    return (unsigned char)rtk_sum8(buff, len);
 }
 /* decode imu time------------------------------------------------------------*/
 static void decode_sow_time(raw_t *raw, double *sow, int *start)
@@ -143,11 +143,7 @@ static int exsign(unsigned int v, int bits)
 /* checksum ------------------------------------------------------------------*/
 static unsigned char chksum(const unsigned char *buff, int len)
 {
-    unsigned char sum = 0;
-    int i;
-    for (i = 0; i < len; i++)
-        sum ^= buff[i];
-    return sum;
+    return rtk_xor8(buff, len);
 }
 /* adjust weekly rollover of gps time ----------------------------------------*/
 static gtime_t adjweek(gtime_t time, double tow)
@@ -729,22 +729,14 @@ EXPORT int input_rt17f(raw_t *Raw, FILE *fp)
 */
 static int CheckPacketChecksum(unsigned char *PacketBuffer)
 {
-    unsigned char Checksum = 0;
     unsigned char *p = &PacketBuffer[1];       /* Starting with status */
     unsigned int Length = PacketBuffer[3] + 3; /* status, type, length, data */
 
-    /* Compute the packet checksum */
-    while (Length > 0)
-    {
-        Checksum += *p++;
-        Length--;
-    }
     /*
-    | Make sure our computed checksum matches the one at the end of the packet.
-    | (Note that the above loop by design very conveniently left *p pointing
-    |  to the checksum byte at the end of the packet.)
+    | Compute the packet checksum and make sure it matches the one at the end
+    | of the packet, which immediately follows the summed bytes.
     */
-    return (Checksum == *p);
+    return ((unsigned char)rtk_sum8(p, Length) == p[Length]);
 }
 /* ClearMessageBuffer - Clear the raw data stream buffer */
 static void ClearMessageBuffer(rt17_t *rt17)
@@ -103,14 +103,7 @@ static double R8(unsigned char *p)
 /* checksum ------------------------------------------------------------------*/
 static unsigned char checksum(unsigned char *buff, int len)
 {
-    unsigned char cs = 0;
-    int i;
-
-    for (i = 4; i < len - 3; i++)
-    {
-        cs ^= buff[i];
-    }
-    return cs;
+    return rtk_xor8(buff + 4, len - 7);
 }
 /* 8-bit week -> full week ---------------------------------------------------*/
 static void adj_utcweek(gtime_t time, double *utc)
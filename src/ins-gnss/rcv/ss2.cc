@@ -47,11 +47,8 @@ static double R8(unsigned char *p)
 /* checksum ------------------------------------------------------------------*/
 static int chksum(const unsigned char *buff, int len)
 {
-    int i;
-    unsigned short sum = 0;
+    unsigned short sum = (unsigned short)rtk_sum8(buff, len - 2);
 
-    for (i = 0; i < len - 2; i++)
-        sum += buff[i];
     return (sum >> 8) == buff[len - 1] && (sum & 0xFF) == buff[len - 2];
 }
 /* adjust week ---------------------------------------------------------------*/
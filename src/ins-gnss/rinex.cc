@@ -84,6 +84,12 @@
  *           2016/09/17 1.26 fix bug on fit interval in QZSS RINEX nav
  *                           URA output value complient to RINEX 3.03
  *           2016/10/10 1.27 add api outrnxinavh()
+ *           2026/10/16 1.28 read multiple rinex files on reader threads
+ *                           add api readrnxm()
+ *                           load and save parsed files by cache
+ *                           add api open_rnxstr(),input_rnxstr(),close_rnxstr()
+ *           2026/10/17 1.29 save parsed files only if cache enabled
+ *                           update generation of navigation data by reading
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 
@@ -94,6 +100,8 @@
 #define MINFREQ_GLO -7                  /* min frequency number glonass */
 #define MAXFREQ_GLO 13                  /* max frequency number glonass */
 #define NINCOBS 262144                  /* inclimental number of obs data */
+#define NRNXTHREAD 8                    /* max number of rinex reader threads */
+#define NRNXBATCH 32                    /* number of rinex files read per batch */
 
 static const int navsys[] = {/* satellite systems */
                              SYS_GPS, SYS_GLO, SYS_GAL, SYS_QZS, SYS_SBS, SYS_CMP, SYS_IRN, 0};
@@ -1991,6 +1999,455 @@ static int readrnxfile(const char *file, gtime_t ts, gtime_t te, double tint, co
 
     return stat;
 }
+/* rinex reader job ----------------------------------------------------------*/
+typedef struct {             /* rinex reader job type */
+    const char *file;        /* rinex file path */
+    const char *opt;         /* rinex options */
+    char type;               /* rinex file type */
+    int stat;                /* read status */
+    obs_t obs;               /* obs data read (receiver number 1) */
+    nav_t nav;               /* nav data read */
+    sta_t sta;               /* station parameters read */
+} rnxjob_t;
+
+typedef struct {             /* rinex reader pool type */
+    rnxjob_t *job;           /* reader jobs */
+    int n, next;             /* number of jobs, next job index */
+    int robs, rnav, rsta;    /* read obs, nav, station flags */
+    gtime_t ts, te;          /* observation time start/end */
+    double tint;             /* observation time interval (s) */
+    lock_t lock;             /* lock flag */
+} rnxpool_t;
+
+/* free data of reader job ---------------------------------------------------*/
+static void freejob(rnxjob_t *job)
+{
+    free(job->obs.data);
+    job->obs.data = NULL;
+    job->obs.n = job->obs.nmax = 0;
+    free(job->nav.eph);
+    job->nav.eph = NULL;
+    free(job->nav.geph);
+    job->nav.geph = NULL;
+    free(job->nav.seph);
+    job->nav.seph = NULL;
+}
+/* cache key of reader job ---------------------------------------------------*/
+static void jobkey(const rnxpool_t *pool, const rnxjob_t *job, char *key)
+{
+    sprintf(key, "rnx ts=%.3f te=%.3f tint=%.3f obs=%d nav=%d sta=%d opt=%s", pool->ts.time + pool->ts.sec,
+            pool->te.time + pool->te.sec, pool->tint, pool->robs, pool->rnav, pool->rsta, job->opt);
+}
+/* load reader job from cache --------------------------------------------------
+ * return : status (1:loaded,0:no cache,-1:cache disabled)
+ *----------------------------------------------------------------------------*/
+static int loadjob(const rnxpool_t *pool, rnxjob_t *job)
+{
+    cache_t c;
+    nav_t *nav = &job->nav;
+    char key[1024];
+    int stat;
+
+    jobkey(pool, job, key);
+
+    if ((stat = readcache(job->file, key, &c)) <= 0)
+        return stat;
+
+    stat = getcache(&c, &job->type, 1) && getcache(&c, &job->stat, 4) && getcache(&c, &job->obs.n, 4) &&
+           getcache(&c, &nav->n, 4) && getcache(&c, &nav->ng, 4) && getcache(&c, &nav->ns, 4);
+
+    if (stat && job->obs.n > 0 && (job->obs.data = (obsd_t *)malloc(sizeof(obsd_t) * job->obs.n)))
+        job->obs.nmax = job->obs.n;
+    if (stat && nav->n > 0 && (nav->eph = (eph_t *)malloc(sizeof(eph_t) * nav->n)))
+        nav->nmax = nav->n;
+    if (stat && nav->ng > 0 && (nav->geph = (geph_t *)malloc(sizeof(geph_t) * nav->ng)))
+        nav->ngmax = nav->ng;
+    if (stat && nav->ns > 0 && (nav->seph = (seph_t *)malloc(sizeof(seph_t) * nav->ns)))
+        nav->nsmax = nav->ns;
+
+    stat = stat && job->obs.nmax == job->obs.n && nav->nmax == nav->n && nav->ngmax == nav->ng &&
+           nav->nsmax == nav->ns && getcache(&c, job->obs.data, sizeof(obsd_t) * job->obs.n) &&
+           getcache(&c, job->obs.sind[0], sizeof(job->obs.sind[0])) &&
+           getcache(&c, nav->eph, sizeof(eph_t) * nav->n) && getcache(&c, nav->geph, sizeof(geph_t) * nav->ng) &&
+           getcache(&c, nav->seph, sizeof(seph_t) * nav->ns) && getcache(&c, nav->utc_gps, sizeof(nav->utc_gps)) &&
+           getcache(&c, nav->utc_glo, sizeof(nav->utc_glo)) && getcache(&c, nav->utc_gal, sizeof(nav->utc_gal)) &&
+           getcache(&c, nav->utc_qzs, sizeof(nav->utc_qzs)) && getcache(&c, nav->utc_cmp, sizeof(nav->utc_cmp)) &&
+           getcache(&c, nav->utc_irn, sizeof(nav->utc_irn)) && getcache(&c, nav->ion_gps, sizeof(nav->ion_gps)) &&
+           getcache(&c, nav->ion_gal, sizeof(nav->ion_gal)) && getcache(&c, nav->ion_qzs, sizeof(nav->ion_qzs)) &&
+           getcache(&c, nav->ion_cmp, sizeof(nav->ion_cmp)) && getcache(&c, nav->ion_irn, sizeof(nav->ion_irn)) &&
+           getcache(&c, &nav->leaps, sizeof(nav->leaps)) && getcache(&c, nav->glo_fcn, sizeof(nav->glo_fcn)) &&
+           getcache(&c, nav->glo_cpbias, sizeof(nav->glo_cpbias)) && getcache(&c, &job->sta, sizeof(sta_t));
+    freecache(&c);
+
+    if (!stat)
+    {
+        trace(2, "rinex cache read error: %s\n", job->file);
+        freejob(job);
+        memset(&job->obs, 0, sizeof(obs_t));
+        memset(&job->nav, 0, sizeof(nav_t));
+        memset(&job->sta, 0, sizeof(sta_t));
+        job->type = ' ';
+        job->stat = 0;
+        return 0;
+    }
+    return 1;
+}
+/* save reader job to cache --------------------------------------------------*/
+static void savejob(const rnxpool_t *pool, const rnxjob_t *job)
+{
+    cache_t c = {0};
+    const nav_t *nav = &job->nav;
+    char key[1024];
+
+    jobkey(pool, job, key);
+
+    if (putcache(&c, &job->type, 1) && putcache(&c, &job->stat, 4) && putcache(&c, &job->obs.n, 4) &&
+        putcache(&c, &nav->n, 4) && putcache(&c, &nav->ng, 4) && putcache(&c, &nav->ns, 4) &&
+        putcache(&c, job->obs.data, sizeof(obsd_t) * job->obs.n) &&
+        putcache(&c, job->obs.sind[0], sizeof(job->obs.sind[0])) && putcache(&c, nav->eph, sizeof(eph_t) * nav->n) &&
+        putcache(&c, nav->geph, sizeof(geph_t) * nav->ng) && putcache(&c, nav->seph, sizeof(seph_t) * nav->ns) &&
+        putcache(&c, nav->utc_gps, sizeof(nav->utc_gps)) && putcache(&c, nav->utc_glo, sizeof(nav->utc_glo)) &&
+        putcache(&c, nav->utc_gal, sizeof(nav->utc_gal)) && putcache(&c, nav->utc_qzs, sizeof(nav->utc_qzs)) &&
+        putcache(&c, nav->utc_cmp, sizeof(nav->utc_cmp)) && putcache(&c, nav->utc_irn, sizeof(nav->utc_irn)) &&
+        putcache(&c, nav->ion_gps, sizeof(nav->ion_gps)) && putcache(&c, nav->ion_gal, sizeof(nav->ion_gal)) &&
+        putcache(&c, nav->ion_qzs, sizeof(nav->ion_qzs)) && putcache(&c, nav->ion_cmp, sizeof(nav->ion_cmp)) &&
+        putcache(&c, nav->ion_irn, sizeof(nav->ion_irn)) && putcache(&c, &nav->leaps, sizeof(nav->leaps)) &&
+        putcache(&c, nav->glo_fcn, sizeof(nav->glo_fcn)) && putcache(&c, nav->glo_cpbias, sizeof(nav->glo_cpbias)) &&
+        putcache(&c, &job->sta, sizeof(sta_t)))
+    {
+        writecache(job->file, key, &c);
+    }
+    freecache(&c);
+}
+/* rinex reader thread -------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI rnxthread(void *arg)
+#else
+static void *rnxthread(void *arg)
+#endif
+{
+    rnxpool_t *pool = (rnxpool_t *)arg;
+    rnxjob_t *job;
+    int i, cstat;
+
+    for (;;)
+    {
+        lock(&pool->lock);
+        i = pool->next++;
+        unlock(&pool->lock);
+
+        if (i >= pool->n)
+            break;
+        job = pool->job + i;
+
+        if (!*job->file || (cstat = loadjob(pool, job)) > 0)
+            continue;
+        job->stat = readrnxfile(job->file, pool->ts, pool->te, pool->tint, job->opt, 0, 1, &job->type,
+                                pool->robs ? &job->obs : NULL, pool->rnav ? &job->nav : NULL,
+                                pool->rsta ? &job->sta : NULL);
+        if (cstat == 0 && job->stat >= 0 && job->type != ' ' && job->type != 'C')
+            savejob(pool, job);
+    }
+    return 0;
+}
+/* read rinex files of reader jobs in parallel -------------------------------*/
+static void readrnxjob(rnxpool_t *pool)
+{
+    thread_t thread[NRNXTHREAD];
+    int i, n = 0;
+
+    trace(3, "readrnxjob: n=%d\n", pool->n);
+
+    pool->next = 0;
+
+    /* the calling thread is the last reader */
+    for (i = 0; i < pool->n - 1 && i < NRNXTHREAD - 1; i++, n++)
+    {
+#ifdef WIN32
+        if (!(thread[n] = CreateThread(NULL, 0, rnxthread, pool, 0, NULL)))
+            break;
+#else
+        if (pthread_create(thread + n, NULL, rnxthread, pool))
+            break;
+#endif
+    }
+    rnxthread(pool);
+
+    for (i = 0; i < n; i++)
+    {
+#ifdef WIN32
+        WaitForSingleObject(thread[i], INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i], NULL);
+#endif
+    }
+}
+/* merge navigation parameters set in rinex header ---------------------------*/
+static void mergepar(double *dst, const double *src, int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (src[i] != 0.0)
+            break;
+    }
+    if (i >= n)
+        return;
+    for (i = 0; i < n; i++)
+        dst[i] = src[i];
+}
+/* merge navigation data read by reader job ----------------------------------*/
+static int mergenav(nav_t *nav, const nav_t *src)
+{
+    int i;
+
+    for (i = 0; i < src->n; i++)
+    {
+        if (!add_eph(nav, src->eph + i))
+            return 0;
+    }
+    for (i = 0; i < src->ng; i++)
+    {
+        if (!add_geph(nav, src->geph + i))
+            return 0;
+    }
+    for (i = 0; i < src->ns; i++)
+    {
+        if (!add_seph(nav, src->seph + i))
+            return 0;
+    }
+    /* later headers overwrite earlier ones as in sequential reading */
+    mergepar(nav->utc_gps, src->utc_gps, 4);
+    mergepar(nav->utc_glo, src->utc_glo, 4);
+    mergepar(nav->utc_gal, src->utc_gal, 4);
+    mergepar(nav->utc_qzs, src->utc_qzs, 4);
+    mergepar(nav->utc_cmp, src->utc_cmp, 4);
+    mergepar(nav->utc_irn, src->utc_irn, 4);
+    mergepar(nav->ion_gps, src->ion_gps, 4);
+    mergepar(nav->ion_gps + 4, src->ion_gps + 4, 4);
+    mergepar(nav->ion_gal, src->ion_gal, 4);
+    mergepar(nav->ion_qzs, src->ion_qzs, 4);
+    mergepar(nav->ion_qzs + 4, src->ion_qzs + 4, 4);
+    mergepar(nav->ion_cmp, src->ion_cmp, 4);
+    mergepar(nav->ion_cmp + 4, src->ion_cmp + 4, 4);
+    mergepar(nav->ion_irn, src->ion_irn, 4);
+    mergepar(nav->ion_irn + 4, src->ion_irn + 4, 4);
+
+    if (src->leaps)
+        nav->leaps = src->leaps;
+    for (i = 0; i < MAXPRNGLO; i++)
+    {
+        if (src->glo_fcn[i])
+            nav->glo_fcn[i] = src->glo_fcn[i];
+    }
+    for (i = 0; i < 4; i++)
+    {
+        if (src->glo_cpbias[i] != 0.0)
+            nav->glo_cpbias[i] = src->glo_cpbias[i];
+    }
+    return 1;
+}
+/* merge data read by reader job ---------------------------------------------*/
+static int mergejob(rnxjob_t *job, int rcv, char *type, obs_t *obs, nav_t *nav, sta_t *sta)
+{
+    int i;
+
+    trace(4, "mergejob: file=%s rcv=%d nobs=%d\n", job->file, rcv, job->obs.n);
+
+    if (job->type != ' ')
+        *type = job->type;
+    if (sta)
+        *sta = job->sta;
+
+    if (obs && rcv <= MAXRCV)
+    {
+        if (job->type == 'O')
+        {
+            for (i = 0; i < 7; i++)
+                obs->sind[rcv <= 2 ? rcv - 1 : 0][i] = job->obs.sind[0][i];
+        }
+        for (i = 0; i < job->obs.n; i++)
+        {
+            job->obs.data[i].rcv = (unsigned char)rcv;
+            if (addobsdata(obs, job->obs.data + i) < 0)
+                return -1;
+        }
+    }
+    else if (obs && job->type == 'O')
+        return 0;
+
+    if (nav && !mergenav(nav, &job->nav))
+        return -1;
+
+    return job->stat;
+}
+/* read rinex files of multiple entries ----------------------------------------
+ * read rinex files in parallel and merge them in file order
+ * args   : char **file   I      files (wild-card * expanded) ("": stdin)
+ *          int *index    I      receiver index of files
+ *          int n         I      number of files
+ *          int rcv       I      receiver number of first index
+ *          gtime_t ts,te I      observation time start/end (time==0: no limit)
+ *          double tint   I      observation time interval (s) (0:all)
+ *          char **opt    I      rinex options {first receiver,others}
+ *          sta_t *sta    IO     station parameters (NULL: no input)
+ *          int nsta      I      number of station parameters
+ * return : status (1:ok,0:no data,-1:error)
+ * notes  : the receiver number is incremented when the index changes and the
+ *          previous files added obs data. the files are parsed on reader
+ *          threads with the options of the first receiver for the first index
+ *          and of the others for the rest. a file is read again in place if
+ *          the options of the receiver number decided on merge differ.
+ *          parsed files are loaded from and saved to cache (see setcache()).
+ *-----------------------------------------------------------------------------*/
+static int readrnxs(char **file, const int *index, int n, int rcv, gtime_t ts, gtime_t te, double tint,
+                    const char **opt, obs_t *obs, nav_t *nav, sta_t *sta, int nsta)
+{
+    rnxpool_t pool = {0};
+    rnxjob_t *job;
+    sta_t *stap;
+    const char *p, *ropt, **jopt = NULL, **jopt_;
+    char *files[MAXEXFILE] = {0}, **path = NULL, **path_, type;
+    int i, j, k, m, np = 0, *ent = NULL, *ent_ = NULL, b0 = 0, rcv0 = rcv, ind = 0, nobs, stat = 0;
+
+    trace(3, "readrnxs: n=%d rcv=%d\n", n, rcv);
+
+    for (i = 0; i < MAXEXFILE; i++)
+    {
+        if (!(files[i] = (char *)malloc(1024)))
+        {
+            for (i--; i >= 0; i--)
+                free(files[i]);
+            return -1;
+        }
+    }
+    /* expand wild-card of all entries */
+    for (i = 0; i < n && stat >= 0; i++)
+    {
+        if (!*file[i])
+        {
+            *files[0] = '\0';
+            m = 1;
+        }
+        else if ((m = expath(file[i], files, MAXEXFILE)) <= 0)
+            continue;
+
+        if (!(path_ = (char **)realloc(path, sizeof(char *) * (np + m))) ||
+            !(ent_ = (int *)realloc(ent, sizeof(int) * (np + m))) ||
+            !(jopt_ = (const char **)realloc(jopt, sizeof(char *) * (np + m))))
+        {
+            if (path_)
+                path = path_;
+            if (ent_)
+                ent = ent_;
+            stat = -1;
+            break;
+        }
+        path = path_;
+        ent = ent_;
+        jopt = jopt_;
+        for (j = 0; j < m; j++, np++)
+        {
+            if (!(path[np] = (char *)malloc(strlen(files[j]) + 1)))
+            {
+                stat = -1;
+                break;
+            }
+            strcpy(path[np], files[j]);
+            ent[np] = i;
+            jopt[np] = opt[index[i] == index[0] ? 0 : 1];
+        }
+    }
+    for (i = 0; i < MAXEXFILE; i++)
+        free(files[i]);
+
+    if (stat >= 0 && np > 0 && !(pool.job = (rnxjob_t *)calloc(MIN(np, NRNXBATCH), sizeof(rnxjob_t))))
+    {
+        stat = -1;
+    }
+    pool.robs = obs != NULL;
+    pool.rnav = nav != NULL;
+    pool.rsta = sta != NULL;
+    pool.ts = ts;
+    pool.te = te;
+    pool.tint = tint;
+    initlock(&pool.lock);
+
+    nobs = obs ? obs->n : 0;
+
+    for (i = 0, j = 0; i < n && stat >= 0; i++)
+    {
+        if (index[i] != ind)
+        {
+            if (obs && obs->n > nobs)
+                rcv++;
+            ind = index[i];
+            nobs = obs ? obs->n : 0;
+        }
+        ropt = opt[rcv <= rcv0 ? 0 : 1];
+        stap = sta && rcv - rcv0 < nsta ? sta + rcv - rcv0 : NULL;
+        type = ' ';
+
+        for (; j < np && ent[j] == i && stat >= 0; j++)
+        {
+            if (!*path[j])
+            {
+                stat = readrnxfp(stdin, ts, te, tint, ropt, 0, 1, &type, obs, nav, stap);
+                continue;
+            }
+            /* parse next batch of files on reader threads */
+            if (j >= b0 + pool.n)
+            {
+                b0 = j;
+                pool.n = MIN(np - j, NRNXBATCH);
+
+                for (k = 0; k < pool.n; k++)
+                {
+                    job = pool.job + k;
+                    memset(job, 0, sizeof(rnxjob_t));
+                    job->file = path[b0 + k];
+                    job->opt = jopt[b0 + k];
+                    job->type = ' ';
+                }
+                readrnxjob(&pool);
+            }
+            job = pool.job + j - b0;
+
+            if (strcmp(job->opt, ropt))
+            {
+                stat = readrnxfile(path[j], ts, te, tint, ropt, 0, rcv, &type, obs, nav, stap);
+            }
+            else
+                stat = mergejob(job, rcv, &type, obs, nav, stap);
+            freejob(job);
+        }
+        /* if station name empty, set 4-char name from file head */
+        if (type == 'O' && stap)
+        {
+            if (!(p = strrchr(file[i], FILEPATHSEP)))
+                p = file[i] - 1;
+            if (!*stap->name)
+                setstr(stap->name, p + 1, 4);
+        }
+    }
+    if (pool.job)
+    {
+        for (k = 0; k < pool.n; k++)
+            freejob(pool.job + k);
+        free(pool.job);
+    }
+    for (i = 0; i < np; i++)
+        free(path[i]);
+    free(path);
+    free(ent);
+    free(jopt);
+
+    if (nav)
+        updnavgen();
+    return stat;
+}
 /* read rinex obs and nav files ------------------------------------------------
  * read rinex obs and nav files
  * args   : char *file    I      file (wild-card * expanded) ("": stdin)
@@ -2028,9 +2485,10 @@ static int readrnxfile(const char *file, gtime_t ts, gtime_t te, double tint, co
 extern int readrnxt(const char *file, int rcv, gtime_t ts, gtime_t te, double tint, const char *opt, obs_t *obs,
                     nav_t *nav, sta_t *sta)
 {
-    int i, n, stat = 0;
-    const char *p;
-    char type = ' ', *files[MAXEXFILE] = {0};
+    const char *opts[2];
+    char *files[1];
+    int index = 0;
+    char type = ' ';
 
     trace(3, "readrnxt: file=%s rcv=%d\n", file, rcv);
 
@@ -2038,39 +2496,36 @@ extern int readrnxt(const char *file, int rcv, gtime_t ts, gtime_t te, double ti
     {
         return readrnxfp(stdin, ts, te, tint, opt, 0, 1, &type, obs, nav, sta);
     }
-    for (i = 0; i < MAXEXFILE; i++)
-    {
-        if (!(files[i] = (char *)malloc(1024)))
-        {
-            for (i--; i >= 0; i--)
-                free(files[i]);
-            return -1;
-        }
-    }
-    /* expand wild-card */
-    if ((n = expath(file, files, MAXEXFILE)) <= 0)
-    {
-        for (i = 0; i < MAXEXFILE; i++)
-            free(files[i]);
-        return 0;
-    }
-    /* read rinex files */
-    for (i = 0; i < n && stat >= 0; i++)
-    {
-        stat = readrnxfile(files[i], ts, te, tint, opt, 0, rcv, &type, obs, nav, sta);
-    }
-    /* if station name empty, set 4-char name from file head */
-    if (type == 'O' && sta)
-    {
-        if (!(p = strrchr(file, FILEPATHSEP)))
-            p = file - 1;
-        if (!*sta->name)
-            setstr(sta->name, p + 1, 4);
-    }
-    for (i = 0; i < MAXEXFILE; i++)
-        free(files[i]);
+    files[0] = (char *)file;
+    opts[0] = opts[1] = opt;
 
-    return stat;
+    return readrnxs(files, &index, 1, rcv, ts, te, tint, opts, obs, nav, sta, 1);
+}
+/* read rinex obs and nav files of receivers -----------------------------------
+ * read rinex obs and nav files of rover, base and the others in parallel
+ * args   : char **file   I      files (wild-card * expanded) ("": stdin)
+ *          int *index    I      receiver index of files
+ *          int   n       I      number of files
+ *         (gtime_t ts)   I      observation time start (ts.time==0: no limit)
+ *         (gtime_t te)   I      observation time end   (te.time==0: no limit)
+ *         (double tint)  I      observation time interval (s) (0:all)
+ *          char **opt    I      rinex options {rover,base}
+ *          obs_t *obs    IO     observation data   (NULL: no input)
+ *          nav_t *nav    IO     navigation data    (NULL: no input)
+ *          sta_t *sta    IO     station parameters {rover,base} (NULL: no input)
+ * return : status (1:ok,0:no data,-1:error)
+ * notes  : receiver number starts at 1 and is incremented when the index
+ *          changes after files with obs data. the result is the same as
+ *          calling readrnxt() for each file in order.
+ *          observation data and navigation data are not sorted.
+ *          call sortobs() or uniqnav() to sort data or delete duplicated eph.
+ *-----------------------------------------------------------------------------*/
+extern int readrnxm(char **file, const int *index, int n, gtime_t ts, gtime_t te, double tint, const char **opt,
+                    obs_t *obs, nav_t *nav, sta_t *sta)
+{
+    trace(3, "readrnxm: n=%d\n", n);
+
+    return readrnxs(file, index, n, 1, ts, te, tint, opt, obs, nav, sta, 2);
 }
 extern int readrnx(const char *file, int rcv, const char *opt, obs_t *obs, nav_t *nav, sta_t *sta)
 {
@@ -2130,6 +2585,103 @@ static void combpclk(nav_t *nav)
 
     trace(4, "combpclk: nc=%d\n", nav->nc);
 }
+/* read rinex clock file with cache ------------------------------------------*/
+static int readrnxcf(const char *file, int index, nav_t *nav)
+{
+    cache_t c;
+    gtime_t t = {0};
+    pclk_t *pclk, *nav_pclk;
+    double wlbias[MAXSAT];
+    char type = ' ';
+    int i, n, nc, ncmax, cstat, stat;
+
+    if ((cstat = readcache(file, "clk", &c)) > 0)
+    {
+        stat = getcache(&c, &n, 4) && n >= 0 && getcache(&c, wlbias, sizeof(wlbias));
+
+        if (stat && nav->nc + n > nav->ncmax)
+        {
+            if (!(nav_pclk = (pclk_t *)realloc(nav->pclk, sizeof(pclk_t) * (nav->nc + n))))
+            {
+                freecache(&c);
+                return -1;
+            }
+            nav->pclk = nav_pclk;
+            nav->ncmax = nav->nc + n;
+        }
+        stat = stat && getcache(&c, nav->pclk + nav->nc, sizeof(pclk_t) * n);
+        freecache(&c);
+
+        if (stat)
+        {
+            for (i = 0; i < n; i++)
+                nav->pclk[nav->nc++].index = index;
+            for (i = 0; i < MAXSAT; i++)
+            {
+                if (wlbias[i] != 0.0)
+                    nav->wlbias[i] = wlbias[i];
+            }
+            return nav->nc > 0;
+        }
+        trace(2, "rinex clock cache read error: %s\n", file);
+    }
+    if (cstat < 0)
+    {
+        return readrnxfile(file, t, t, 0.0, "", 1, index, &type, NULL, nav, NULL);
+    }
+    /* read records of the file into empty list to save cache */
+    pclk = nav->pclk;
+    nc = nav->nc;
+    ncmax = nav->ncmax;
+    nav->pclk = NULL;
+    nav->nc = nav->ncmax = 0;
+    for (i = 0; i < MAXSAT; i++)
+    {
+        wlbias[i] = nav->wlbias[i];
+        nav->wlbias[i] = 0.0;
+    }
+    stat = readrnxfile(file, t, t, 0.0, "", 1, index, &type, NULL, nav, NULL);
+
+    if (stat >= 0 && type == 'C')
+    {
+        c.buff = NULL;
+        c.n = c.nmax = c.pos = 0;
+        if (putcache(&c, &nav->nc, 4) && putcache(&c, nav->wlbias, sizeof(nav->wlbias)) &&
+            putcache(&c, nav->pclk, sizeof(pclk_t) * nav->nc))
+        {
+            writecache(file, "clk", &c);
+        }
+        freecache(&c);
+    }
+    for (i = 0; i < MAXSAT; i++)
+    {
+        if (nav->wlbias[i] == 0.0)
+            nav->wlbias[i] = wlbias[i];
+    }
+    /* append records to clock list */
+    n = nav->nc;
+    nav_pclk = nav->pclk;
+    nav->pclk = pclk;
+    nav->nc = nc;
+    nav->ncmax = ncmax;
+
+    if (n > 0 && nav->nc + n > nav->ncmax)
+    {
+        if (!(pclk = (pclk_t *)realloc(nav->pclk, sizeof(pclk_t) * (nav->nc + n))))
+        {
+            free(nav_pclk);
+            return -1;
+        }
+        nav->pclk = pclk;
+        nav->ncmax = nav->nc + n;
+    }
+    if (n > 0)
+        memcpy(nav->pclk + nav->nc, nav_pclk, sizeof(pclk_t) * n);
+    nav->nc += n;
+    free(nav_pclk);
+
+    return stat < 0 || type != 'C' ? stat : nav->nc > 0;
+}
 /* read rinex clock files ------------------------------------------------------
  * read rinex clock files
  * args   : char *file    I      file (wild-card * expanded)
@@ -2138,9 +2690,8 @@ static void combpclk(nav_t *nav)
  *-----------------------------------------------------------------------------*/
 extern int readrnxc(const char *file, nav_t *nav)
 {
-    gtime_t t = {0};
     int i, n, index = 0, stat = 1;
-    char *files[MAXEXFILE] = {0}, type;
+    char *files[MAXEXFILE] = {0};
 
     trace(3, "readrnxc: file=%s\n", file);
 
@@ -2159,7 +2710,7 @@ extern int readrnxc(const char *file, nav_t *nav)
     /* read rinex clock files */
     for (i = 0; i < n; i++)
     {
-        if (readrnxfile(files[i], t, t, 0.0, "", 1, index++, &type, NULL, nav, NULL))
+        if (readrnxcf(files[i], index++, nav))
         {
             continue;
         }
@@ -2174,6 +2725,7 @@ extern int readrnxc(const char *file, nav_t *nav)
 
     /* unique and combine ephemeris and precise clock */
     combpclk(nav);
+    updnavgen();
 
     return nav->nc;
 }
@@ -2367,6 +2919,231 @@ extern int input_rnxctr(rnxctr_t *rnx, FILE *fp)
     }
     return 2;
 }
+/* close current file of rinex obs stream ------------------------------------*/
+static void closestrf(rnxstr_t *str)
+{
+    if (str->fp)
+        fclose(str->fp);
+    str->fp = NULL;
+
+    /* delete temporary file */
+    if (*str->tmpfile)
+        remove(str->tmpfile);
+    *str->tmpfile = '\0';
+}
+/* open next file of rinex obs stream ----------------------------------------*/
+static int openstrf(rnxstr_t *str)
+{
+    FILE *fp;
+    double ver;
+    int cstat, sys, tsys;
+    char *file, tmpfile[1024], type;
+
+    while (str->ip < str->np)
+    {
+        file = str->path[str->ip++];
+
+        trace(3, "openstrf: file=%s rcv=%d\n", file, str->rcv);
+
+        /* uncompress file */
+        if ((cstat = rtk_uncompress(file, tmpfile)) < 0)
+        {
+            trace(2, "rinex file uncompact error: %s\n", file);
+            continue;
+        }
+        if (!(fp = fopen(cstat ? tmpfile : file, "r")))
+        {
+            trace(2, "rinex file open error: %s\n", cstat ? tmpfile : file);
+            if (cstat)
+                remove(tmpfile);
+            continue;
+        }
+        if (str->sta)
+            init_sta(str->sta);
+        memset(str->tobs, 0, sizeof(str->tobs));
+        tsys = TSYS_GPS;
+
+        /* read rinex header */
+        if (readrnxh(fp, &ver, &type, &sys, &tsys, str->tobs, str->nav, str->sta) && type == 'O')
+        {
+            str->fp = fp;
+            str->ver = ver;
+            str->tsys = tsys;
+            if (cstat)
+                strcpy(str->tmpfile, tmpfile);
+            memset(str->slips, 0, sizeof(str->slips));
+            return 1;
+        }
+        trace(3, "openstrf: not rinex obs file: %s\n", file);
+        fclose(fp);
+        if (cstat)
+            remove(tmpfile);
+    }
+    return 0;
+}
+/* open rinex obs stream -------------------------------------------------------
+ * open rinex obs files of a receiver to input observation data epoch by epoch
+ * args   : rnxstr_t *str IO     rinex obs stream
+ *          char **file   I      files (wild-card * expanded)
+ *          int   n       I      number of files
+ *          int   rcv     I      receiver number for obs data
+ *         (gtime_t ts)   I      observation time start (ts.time==0: no limit)
+ *         (gtime_t te)   I      observation time end   (te.time==0: no limit)
+ *         (double tint)  I      observation time interval (s) (0:all)
+ *          char  *opt    I      rinex options (see readrnxt())
+ *          nav_t *nav    IO     navigation data for header parameters
+ *          sta_t *sta    IO     station parameters (NULL: no input)
+ * return : status (1:ok,0:no rinex obs file or error)
+ * notes  : the files are read in order. observation data are converted to
+ *          gpst and screened by time as readrnxt(). the stream of a file ends
+ *          at the first epoch after te.
+ *-----------------------------------------------------------------------------*/
+extern int open_rnxstr(rnxstr_t *str, char **file, int n, int rcv, gtime_t ts, gtime_t te, double tint,
+                       const char *opt, nav_t *nav, sta_t *sta)
+{
+    char *files[MAXEXFILE] = {0}, **path;
+    int i, j, m, stat = 1;
+
+    trace(3, "open_rnxstr: n=%d rcv=%d\n", n, rcv);
+
+    memset(str, 0, sizeof(rnxstr_t));
+    str->rcv = rcv;
+    str->ts = ts;
+    str->te = te;
+    str->tint = tint;
+    str->nav = nav;
+    str->sta = sta;
+    strncpy(str->opt, opt, sizeof(str->opt) - 1);
+
+    if (!(str->data = (obsd_t *)malloc(sizeof(obsd_t) * MAXOBS)))
+        return 0;
+
+    for (i = 0; i < MAXEXFILE; i++)
+    {
+        if (!(files[i] = (char *)malloc(1024)))
+        {
+            for (i--; i >= 0; i--)
+                free(files[i]);
+            close_rnxstr(str);
+            return 0;
+        }
+    }
+    /* expand wild-card */
+    for (i = 0; i < n && stat; i++)
+    {
+        if ((m = expath(file[i], files, MAXEXFILE)) <= 0)
+            continue;
+
+        if (!(path = (char **)realloc(str->path, sizeof(char *) * (str->np + m))))
+        {
+            stat = 0;
+            break;
+        }
+        str->path = path;
+        for (j = 0; j < m; j++)
+        {
+            if (!(str->path[str->np] = (char *)malloc(strlen(files[j]) + 1)))
+            {
+                stat = 0;
+                break;
+            }
+            strcpy(str->path[str->np++], files[j]);
+        }
+    }
+    for (i = 0; i < MAXEXFILE; i++)
+        free(files[i]);
+
+    if (!stat || !openstrf(str))
+    {
+        close_rnxstr(str);
+        return 0;
+    }
+    return 1;
+}
+/* input rinex obs stream ------------------------------------------------------
+ * input next epoch of observation data from rinex obs stream
+ * args   : rnxstr_t *str IO     rinex obs stream
+ * return : status (-2: end of stream, 1: input observation data)
+ * notes  : observation data of the epoch are set to str->data[0..str->n-1]
+ *          and the epoch time to str->time. cycle-slips of screened epochs
+ *          are carried over as readrnxt().
+ *-----------------------------------------------------------------------------*/
+extern int input_rnxstr(rnxstr_t *str)
+{
+    int i, n, flag = 0;
+
+    trace(4, "input_rnxstr: rcv=%d\n", str->rcv);
+
+    str->n = 0;
+
+    while (str->fp)
+    {
+        /* read rinex obs data body */
+        if ((n = readrnxobsb(str->fp, str->opt, str->ver, &str->tsys, str->tobs, &flag, str->data, str->sta,
+                             str->sind)) < 0)
+        {
+            closestrf(str);
+            openstrf(str);
+            continue;
+        }
+        for (i = 0; i < n; i++)
+        {
+            /* utc -> gpst */
+            if (str->tsys == TSYS_UTC)
+                str->data[i].time = utc2gpst(str->data[i].time);
+
+            /* save cycle-slip */
+            saveslips(str->slips, str->data + i);
+        }
+        if (n <= 0)
+            continue;
+
+        /* end of file data by time */
+        if (str->te.time && timediff(str->data[0].time, str->te) >= DTTOL)
+        {
+            closestrf(str);
+            openstrf(str);
+            continue;
+        }
+        /* screen data by time */
+        if (!screent(str->data[0].time, str->ts, str->te, str->tint))
+            continue;
+
+        for (i = 0; i < n; i++)
+        {
+            /* restore cycle-slip */
+            restslips(str->slips, str->data + i);
+
+            str->data[i].rcv = (unsigned char)str->rcv;
+        }
+        str->time = str->data[0].time;
+        str->n = n;
+        return 1;
+    }
+    return -2;
+}
+/* close rinex obs stream ------------------------------------------------------
+ * close rinex obs stream and free buffers
+ * args   : rnxstr_t *str IO     rinex obs stream
+ * return : none
+ *-----------------------------------------------------------------------------*/
+extern void close_rnxstr(rnxstr_t *str)
+{
+    int i;
+
+    trace(3, "close_rnxstr: rcv=%d\n", str->rcv);
+
+    closestrf(str);
+
+    for (i = 0; i < str->np; i++)
+        free(str->path[i]);
+    free(str->path);
+    str->path = NULL;
+    str->np = str->ip = 0;
+    free(str->data);
+    str->data = NULL;
+    str->n = 0;
+}
 /*------------------------------------------------------------------------------
  * output rinex functions
  *-----------------------------------------------------------------------------*/
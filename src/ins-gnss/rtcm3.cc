@@ -32,6 +32,7 @@
  *           2016/09/20 1.16 fix bug on MT1045 Galileo week rollover
  *           2016/10/09 1.17 support MT1029 unicode text string
  *           2017/04/11 1.18 fix bug on unchange-test of beidou ephemeris
+ *           2026/10/16 1.19 extract msm masks and data fields in bulk
  *                           fix bug on week number in galileo ephemeris struct
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
@@ -2695,7 +2696,8 @@ static int decode_msm_head(rtcm_t *rtcm, int sys, int *sync, int *iod, msm_h_t *
     msm_h_t h0 = {0};
     double tow, tod;
     char *msg;
-    int i = 24, j, dow, mask, staid, type, ncell = 0;
+    unsigned int mask[2];
+    int i = 24, j, n, dow, staid, type, ncell = 0;
 
     type = getbitu(rtcm->buff, i, 12);
     i += 12;
@@ -2741,18 +2743,17 @@ static int decode_msm_head(rtcm_t *rtcm, int sys, int *sync, int *iod, msm_h_t *
         i += 1;
         h->tint_s = getbitu(rtcm->buff, i, 3);
         i += 3;
+        /* satellite and signal mask */
+        i = getbitun(rtcm->buff, i, 32, 2, mask);
         for (j = 1; j <= 64; j++)
         {
-            mask = getbitu(rtcm->buff, i, 1);
-            i += 1;
-            if (mask)
+            if ((mask[(j - 1) / 32] >> (31 - (j - 1) % 32)) & 1u)
                 h->sats[h->nsat++] = j;
         }
+        i = getbitun(rtcm->buff, i, 32, 1, mask);
         for (j = 1; j <= 32; j++)
         {
-            mask = getbitu(rtcm->buff, i, 1);
-            i += 1;
-            if (mask)
+            if ((mask[0] >> (32 - j)) & 1u)
                 h->sigs[h->nsig++] = j;
         }
     }
@@ -2775,10 +2776,18 @@ static int decode_msm_head(rtcm_t *rtcm, int sys, int *sync, int *iod, msm_h_t *
         trace(2, "rtcm3 %d length error: len=%d nsat=%d nsig=%d\n", type, rtcm->len, h->nsat, h->nsig);
         return -1;
     }
-    for (j = 0; j < h->nsat * h->nsig; j++)
+    /* cell mask (nsat*nsig<=64) */
+    n = h->nsat * h->nsig;
+    if (n > 32)
+        i = getbitun(rtcm->buff, i, 32, 1, mask);
+    getbitun(rtcm->buff, i, n - (n > 32 ? 32 : 0), 1, mask + 1);
+    i += n - (n > 32 ? 32 : 0);
+    for (j = 0; j < n; j++)
     {
-        h->cellmask[j] = getbitu(rtcm->buff, i, 1);
-        i += 1;
+        if (n > 32 && j < 32)
+            h->cellmask[j] = (mask[0] >> (31 - j)) & 1u;
+        else
+            h->cellmask[j] = (mask[1] >> (n - 1 - j)) & 1u;
         if (h->cellmask[j])
             ncell++;
     }
@@ -2810,7 +2819,8 @@ static int decode_msm4(rtcm_t *rtcm, int sys)
 {
     msm_h_t h = {0};
     double r[64], pr[64], cp[64], cnr[64];
-    int i, j, type, sync, iod, ncell, rng, rng_m, prv, cpv, lock[64], half[64];
+    unsigned int rng[64], rng_m[64], cnrv[64];
+    int i, j, type, sync, iod, ncell, prv[64], cpv[64], lock[64], half[64];
 
     type = getbitu(rtcm->buff, 24, 12);
 
@@ -2823,55 +2833,28 @@ static int decode_msm4(rtcm_t *rtcm, int sys)
         trace(2, "rtcm3 %d length error: nsat=%d ncell=%d len=%d\n", type, h.nsat, ncell, rtcm->len);
         return -1;
     }
-    for (j = 0; j < h.nsat; j++)
-        r[j] = 0.0;
-    for (j = 0; j < ncell; j++)
-        pr[j] = cp[j] = -1E16;
-
     /* decode satellite data */
+    i = getbitun(rtcm->buff, i, 8, h.nsat, rng);
+    i = getbitun(rtcm->buff, i, 10, h.nsat, rng_m);
+
     for (j = 0; j < h.nsat; j++)
     { /* range */
-        rng = getbitu(rtcm->buff, i, 8);
-        i += 8;
-        if (rng != 255)
-            r[j] = rng * RANGE_MS;
-    }
-    for (j = 0; j < h.nsat; j++)
-    {
-        rng_m = getbitu(rtcm->buff, i, 10);
-        i += 10;
+        r[j] = rng[j] != 255 ? rng[j] * RANGE_MS : 0.0;
         if (r[j] != 0.0)
-            r[j] += rng_m * P2_10 * RANGE_MS;
+            r[j] += rng_m[j] * P2_10 * RANGE_MS;
     }
     /* decode signal data */
+    i = getbitsn(rtcm->buff, i, 15, ncell, prv);
+    i = getbitsn(rtcm->buff, i, 22, ncell, cpv);
+    i = getbitun(rtcm->buff, i, 4, ncell, (unsigned int *)lock);
+    i = getbitun(rtcm->buff, i, 1, ncell, (unsigned int *)half);
+    i = getbitun(rtcm->buff, i, 6, ncell, cnrv);
+
     for (j = 0; j < ncell; j++)
-    { /* pseudorange */
-        prv = getbits(rtcm->buff, i, 15);
-        i += 15;
-        if (prv != -16384)
-            pr[j] = prv * P2_24 * RANGE_MS;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* phaserange */
-        cpv = getbits(rtcm->buff, i, 22);
-        i += 22;
-        if (cpv != -2097152)
-            cp[j] = cpv * P2_29 * RANGE_MS;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* lock time */
-        lock[j] = getbitu(rtcm->buff, i, 4);
-        i += 4;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* half-cycle ambiguity */
-        half[j] = getbitu(rtcm->buff, i, 1);
-        i += 1;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* cnr */
-        cnr[j] = getbitu(rtcm->buff, i, 6) * 1.0;
-        i += 6;
+    {
+        pr[j] = prv[j] != -16384 ? prv[j] * P2_24 * RANGE_MS : -1E16; /* pseudorange */
+        cp[j] = cpv[j] != -2097152 ? cpv[j] * P2_29 * RANGE_MS : -1E16; /* phaserange */
+        cnr[j] = cnrv[j] * 1.0;
     }
     /* save obs data in msm message */
     save_msm_obs(rtcm, sys, &h, r, pr, cp, NULL, NULL, cnr, lock, NULL, half);
@@ -2884,8 +2867,9 @@ static int decode_msm5(rtcm_t *rtcm, int sys)
 {
     msm_h_t h = {0};
     double r[64], rr[64], pr[64], cp[64], rrf[64], cnr[64];
-    int i, j, type, sync, iod, ncell, rng, rng_m, rate, prv, cpv, rrv, lock[64];
-    int ex[64], half[64];
+    unsigned int rng[64], rng_m[64], cnrv[64];
+    int i, j, type, sync, iod, ncell, prv[64], cpv[64], lock[64], half[64];
+    int ex[64], rate[64], rrv[64];
 
     type = getbitu(rtcm->buff, 24, 12);
 
@@ -2898,77 +2882,33 @@ static int decode_msm5(rtcm_t *rtcm, int sys)
         trace(2, "rtcm3 %d length error: nsat=%d ncell=%d len=%d\n", type, h.nsat, ncell, rtcm->len);
         return -1;
     }
-    for (j = 0; j < h.nsat; j++)
-    {
-        r[j] = rr[j] = 0.0;
-        ex[j] = 15;
-    }
-    for (j = 0; j < ncell; j++)
-        pr[j] = cp[j] = rrf[j] = -1E16;
-
     /* decode satellite data */
+    i = getbitun(rtcm->buff, i, 8, h.nsat, rng);
+    i = getbitun(rtcm->buff, i, 4, h.nsat, (unsigned int *)ex);
+    i = getbitun(rtcm->buff, i, 10, h.nsat, rng_m);
+    i = getbitsn(rtcm->buff, i, 14, h.nsat, rate);
+
     for (j = 0; j < h.nsat; j++)
     { /* range */
-        rng = getbitu(rtcm->buff, i, 8);
-        i += 8;
-        if (rng != 255)
-            r[j] = rng * RANGE_MS;
-    }
-    for (j = 0; j < h.nsat; j++)
-    { /* extended info */
-        ex[j] = getbitu(rtcm->buff, i, 4);
-        i += 4;
-    }
-    for (j = 0; j < h.nsat; j++)
-    {
-        rng_m = getbitu(rtcm->buff, i, 10);
-        i += 10;
+        r[j] = rng[j] != 255 ? rng[j] * RANGE_MS : 0.0;
         if (r[j] != 0.0)
-            r[j] += rng_m * P2_10 * RANGE_MS;
-    }
-    for (j = 0; j < h.nsat; j++)
-    { /* phaserangerate */
-        rate = getbits(rtcm->buff, i, 14);
-        i += 14;
-        if (rate != -8192)
-            rr[j] = rate * 1.0;
+            r[j] += rng_m[j] * P2_10 * RANGE_MS;
+        rr[j] = rate[j] != -8192 ? rate[j] * 1.0 : 0.0; /* phaserangerate */
     }
     /* decode signal data */
+    i = getbitsn(rtcm->buff, i, 15, ncell, prv);
+    i = getbitsn(rtcm->buff, i, 22, ncell, cpv);
+    i = getbitun(rtcm->buff, i, 4, ncell, (unsigned int *)lock);
+    i = getbitun(rtcm->buff, i, 1, ncell, (unsigned int *)half);
+    i = getbitun(rtcm->buff, i, 6, ncell, cnrv);
+    i = getbitsn(rtcm->buff, i, 15, ncell, rrv);
+
     for (j = 0; j < ncell; j++)
-    { /* pseudorange */
-        prv = getbits(rtcm->buff, i, 15);
-        i += 15;
-        if (prv != -16384)
-            pr[j] = prv * P2_24 * RANGE_MS;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* phaserange */
-        cpv = getbits(rtcm->buff, i, 22);
-        i += 22;
-        if (cpv != -2097152)
-            cp[j] = cpv * P2_29 * RANGE_MS;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* lock time */
-        lock[j] = getbitu(rtcm->buff, i, 4);
-        i += 4;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* half-cycle ambiguity */
-        half[j] = getbitu(rtcm->buff, i, 1);
-        i += 1;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* cnr */
-        cnr[j] = getbitu(rtcm->buff, i, 6) * 1.0;
-        i += 6;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* phaserangerate */
-        rrv = getbits(rtcm->buff, i, 15);
-        i += 15;
-        if (rrv != -16384)
-            rrf[j] = rrv * 0.0001;
+    {
+        pr[j] = prv[j] != -16384 ? prv[j] * P2_24 * RANGE_MS : -1E16; /* pseudorange */
+        cp[j] = cpv[j] != -2097152 ? cpv[j] * P2_29 * RANGE_MS : -1E16; /* phaserange */
+        cnr[j] = cnrv[j] * 1.0;
+        rrf[j] = rrv[j] != -16384 ? rrv[j] * 0.0001 : -1E16; /* phaserangerate */
     }
     /* save obs data in msm message */
     save_msm_obs(rtcm, sys, &h, r, pr, cp, rr, rrf, cnr, lock, ex, half);
@@ -2981,7 +2921,8 @@ static int decode_msm6(rtcm_t *rtcm, int sys)
 {
     msm_h_t h = {0};
     double r[64], pr[64], cp[64], cnr[64];
-    int i, j, type, sync, iod, ncell, rng, rng_m, prv, cpv, lock[64], half[64];
+    unsigned int rng[64], rng_m[64], cnrv[64];
+    int i, j, type, sync, iod, ncell, prv[64], cpv[64], lock[64], half[64];
 
     type = getbitu(rtcm->buff, 24, 12);
 
@@ -2994,55 +2935,28 @@ static int decode_msm6(rtcm_t *rtcm, int sys)
         trace(2, "rtcm3 %d length error: nsat=%d ncell=%d len=%d\n", type, h.nsat, ncell, rtcm->len);
         return -1;
     }
-    for (j = 0; j < h.nsat; j++)
-        r[j] = 0.0;
-    for (j = 0; j < ncell; j++)
-        pr[j] = cp[j] = -1E16;
-
     /* decode satellite data */
+    i = getbitun(rtcm->buff, i, 8, h.nsat, rng);
+    i = getbitun(rtcm->buff, i, 10, h.nsat, rng_m);
+
     for (j = 0; j < h.nsat; j++)
     { /* range */
-        rng = getbitu(rtcm->buff, i, 8);
-        i += 8;
-        if (rng != 255)
-            r[j] = rng * RANGE_MS;
-    }
-    for (j = 0; j < h.nsat; j++)
-    {
-        rng_m = getbitu(rtcm->buff, i, 10);
-        i += 10;
+        r[j] = rng[j] != 255 ? rng[j] * RANGE_MS : 0.0;
         if (r[j] != 0.0)
-            r[j] += rng_m * P2_10 * RANGE_MS;
+            r[j] += rng_m[j] * P2_10 * RANGE_MS;
     }
     /* decode signal data */
+    i = getbitsn(rtcm->buff, i, 20, ncell, prv);
+    i = getbitsn(rtcm->buff, i, 24, ncell, cpv);
+    i = getbitun(rtcm->buff, i, 10, ncell, (unsigned int *)lock);
+    i = getbitun(rtcm->buff, i, 1, ncell, (unsigned int *)half);
+    i = getbitun(rtcm->buff, i, 10, ncell, cnrv);
+
     for (j = 0; j < ncell; j++)
-    { /* pseudorange */
-        prv = getbits(rtcm->buff, i, 20);
-        i += 20;
-        if (prv != -524288)
-            pr[j] = prv * P2_29 * RANGE_MS;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* phaserange */
-        cpv = getbits(rtcm->buff, i, 24);
-        i += 24;
-        if (cpv != -8388608)
-            cp[j] = cpv * P2_31 * RANGE_MS;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* lock time */
-        lock[j] = getbitu(rtcm->buff, i, 10);
-        i += 10;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* half-cycle ambiguity */
-        half[j] = getbitu(rtcm->buff, i, 1);
-        i += 1;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* cnr */
-        cnr[j] = getbitu(rtcm->buff, i, 10) * 0.0625;
-        i += 10;
+    {
+        pr[j] = prv[j] != -524288 ? prv[j] * P2_29 * RANGE_MS : -1E16; /* pseudorange */
+        cp[j] = cpv[j] != -8388608 ? cpv[j] * P2_31 * RANGE_MS : -1E16; /* phaserange */
+        cnr[j] = cnrv[j] * 0.0625;
     }
     /* save obs data in msm message */
     save_msm_obs(rtcm, sys, &h, r, pr, cp, NULL, NULL, cnr, lock, NULL, half);
@@ -3055,8 +2969,9 @@ static int decode_msm7(rtcm_t *rtcm, int sys)
 {
     msm_h_t h = {0};
     double r[64], rr[64], pr[64], cp[64], rrf[64], cnr[64];
-    int i, j, type, sync, iod, ncell, rng, rng_m, rate, prv, cpv, rrv, lock[64];
-    int ex[64], half[64];
+    unsigned int rng[64], rng_m[64], cnrv[64];
+    int i, j, type, sync, iod, ncell, prv[64], cpv[64], lock[64], half[64];
+    int ex[64], rate[64], rrv[64];
 
     type = getbitu(rtcm->buff, 24, 12);
 
@@ -3069,77 +2984,33 @@ static int decode_msm7(rtcm_t *rtcm, int sys)
         trace(2, "rtcm3 %d length error: nsat=%d ncell=%d len=%d\n", type, h.nsat, ncell, rtcm->len);
         return -1;
     }
-    for (j = 0; j < h.nsat; j++)
-    {
-        r[j] = rr[j] = 0.0;
-        ex[j] = 15;
-    }
-    for (j = 0; j < ncell; j++)
-        pr[j] = cp[j] = rrf[j] = -1E16;
-
     /* decode satellite data */
+    i = getbitun(rtcm->buff, i, 8, h.nsat, rng);
+    i = getbitun(rtcm->buff, i, 4, h.nsat, (unsigned int *)ex);
+    i = getbitun(rtcm->buff, i, 10, h.nsat, rng_m);
+    i = getbitsn(rtcm->buff, i, 14, h.nsat, rate);
+
     for (j = 0; j < h.nsat; j++)
     { /* range */
-        rng = getbitu(rtcm->buff, i, 8);
-        i += 8;
-        if (rng != 255)
-            r[j] = rng * RANGE_MS;
-    }
-    for (j = 0; j < h.nsat; j++)
-    { /* extended info */
-        ex[j] = getbitu(rtcm->buff, i, 4);
-        i += 4;
-    }
-    for (j = 0; j < h.nsat; j++)
-    {
-        rng_m = getbitu(rtcm->buff, i, 10);
-        i += 10;
+        r[j] = rng[j] != 255 ? rng[j] * RANGE_MS : 0.0;
         if (r[j] != 0.0)
-            r[j] += rng_m * P2_10 * RANGE_MS;
-    }
-    for (j = 0; j < h.nsat; j++)
-    { /* phaserangerate */
-        rate = getbits(rtcm->buff, i, 14);
-        i += 14;
-        if (rate != -8192)
-            rr[j] = rate * 1.0;
+            r[j] += rng_m[j] * P2_10 * RANGE_MS;
+        rr[j] = rate[j] != -8192 ? rate[j] * 1.0 : 0.0; /* phaserangerate */
     }
     /* decode signal data */
+    i = getbitsn(rtcm->buff, i, 20, ncell, prv);
+    i = getbitsn(rtcm->buff, i, 24, ncell, cpv);
+    i = getbitun(rtcm->buff, i, 10, ncell, (unsigned int *)lock);
+    i = getbitun(rtcm->buff, i, 1, ncell, (unsigned int *)half);
+    i = getbitun(rtcm->buff, i, 10, ncell, cnrv);
+    i = getbitsn(rtcm->buff, i, 15, ncell, rrv);
+
     for (j = 0; j < ncell; j++)
-    { /* pseudorange */
-        prv = getbits(rtcm->buff, i, 20);
-        i += 20;
-        if (prv != -524288)
-            pr[j] = prv * P2_29 * RANGE_MS;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* phaserange */
-        cpv = getbits(rtcm->buff, i, 24);
-        i += 24;
-        if (cpv != -8388608)
-            cp[j] = cpv * P2_31 * RANGE_MS;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* lock time */
-        lock[j] = getbitu(rtcm->buff, i, 10);
-        i += 10;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* half-cycle amiguity */
-        half[j] = getbitu(rtcm->buff, i, 1);
-        i += 1;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* cnr */
-        cnr[j] = getbitu(rtcm->buff, i, 10) * 0.0625;
-        i += 10;
-    }
-    for (j = 0; j < ncell; j++)
-    { /* phaserangerate */
-        rrv = getbits(rtcm->buff, i, 15);
-        i += 15;
-        if (rrv != -16384)
-            rrf[j] = rrv * 0.0001;
+    {
+        pr[j] = prv[j] != -524288 ? prv[j] * P2_29 * RANGE_MS : -1E16; /* pseudorange */
+        cp[j] = cpv[j] != -8388608 ? cpv[j] * P2_31 * RANGE_MS : -1E16; /* phaserange */
+        cnr[j] = cnrv[j] * 0.0625;
+        rrf[j] = rrv[j] != -16384 ? rrv[j] * 0.0001 : -1E16; /* phaserangerate */
     }
     /* save obs data in msm message */
     save_msm_obs(rtcm, sys, &h, r, pr, cp, rr, rrf, cnr, lock, ex, half);
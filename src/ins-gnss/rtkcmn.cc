@@ -124,6 +124,18 @@
  *           2016/09/17 1.41 suppress warnings
  *           2016/09/19 1.42 modify api deg2dms() to consider numerical error
  *           2017/04/11 1.43 delete EXPORT for global variables
+ *           2026/10/16 1.44 extract bits by bytes in getbitu()
+ *                           add function getbitun(),getbitsn()
+ *                           compute crc by slicing-by-8 tables
+ *                           add function rtk_sum8(),rtk_xor8()
+ *                           convert numbers without sscanf() in str2num()
+ *                           add api setcache(),readcache(),writecache(),
+ *                           putcache(),getcache(),freecache()
+ *                           make buffers of time_str(),eci2ecef() thread-local
+ *                           add api indexnav()
+ *           2026/10/17 1.45 initialize crc tables thread-safely
+ *                           update generation of navigation data in
+ *                           indexnav(),freenav()
  *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 199506
 #include <ctype.h>
@@ -142,6 +154,9 @@
 #define POLYCRC24Q 0x1864CFBu /* CRC24Q polynomial */
 #define EPS 0.000001
 #define ITERS 60
+#define CACHEID 0x4356414Eu /* cache file id ("NAVC") */
+#define CACHEVER 1          /* cache format version */
+#define CACHEEXT ".nvc"     /* cache file extension */
 
 static const double gpst0[] = {1980, 1, 6, 0, 0, 0}; /* gps time reference */
 static const double gst0[] = {1999, 8, 22, 0, 0, 0}; /* galileo system time reference */
@@ -339,6 +354,7 @@ static char codepris[7][MAXFREQ][16] = {
     {"", "", "ABCX", "", "", "", "ABCX"}               /* IRN */
 };
 static fatalfunc_t *fatalfunc = NULL; /* fatal callback function */
+static int cacheena = 0;               /* cache of parsed input files */
 
 extern const char *solqstrs[8] = {"FIX", "FLOAT", "SBAS", "DGPS", "SINGLE", NULL};
 
@@ -397,6 +413,11 @@ extern "C"
     extern int dgetrf_(int *, int *, double *, int *, int *, int *);
     extern int dgetri_(int *, double *, int *, int *, double *, int *, int *);
     extern int dgetrs_(char *, int *, int *, double *, int *, int *, double *, int *, int *);
+    extern int dpotrf_(char *, int *, double *, int *, int *);
+    extern int dtrsm_(char *, char *, char *, char *, int *, int *, double *, double *, int *, double *, int *);
+    extern int dsyrk_(char *, char *, int *, int *, double *, double *, int *, double *, double *, int *);
+    extern int dsymv_(char *, int *, double *, double *, int *, double *, int *, double *, double *, int *);
+    extern int dsyr_(char *, int *, double *, double *, int *, double *, int *);
 };
 #endif
 /* fatal error ---------------------------------------------------------------*/
@@ -890,11 +911,21 @@ extern int adjsind(const prcopt_t *opt, const obsd_t *obs, int *i, int *j, int *
  *-----------------------------------------------------------------------------*/
 extern unsigned int getbitu(const unsigned char *buff, int pos, int len)
 {
-    unsigned int bits = 0;
+    unsigned long long bits = 0;
     int i;
-    for (i = pos; i < pos + len; i++)
-        bits = (bits << 1) + ((buff[i / 8] >> (7 - i % 8)) & 1u);
-    return bits;
+    if (len <= 0)
+        return 0;
+    if (32 < len)
+    {
+        for (i = pos; i < pos + len; i++)
+            bits = (bits << 1) + ((buff[i / 8] >> (7 - i % 8)) & 1u);
+        return (unsigned int)bits;
+    }
+    /* load covering bytes and shift/mask */
+    for (i = pos / 8; i <= (pos + len - 1) / 8; i++)
+        bits = (bits << 8) | buff[i];
+    bits >>= 7 - (pos + len - 1) % 8;
+    return (unsigned int)(bits & (0xFFFFFFFFu >> (32 - len)));
 }
 extern int getbits(const unsigned char *buff, int pos, int len)
 {
@@ -903,6 +934,55 @@ extern int getbits(const unsigned char *buff, int pos, int len)
         return (int)bits;
     return (int)(bits | (~0u << len)); /* extend sign */
 }
+/* extract array of unsigned/signed bits --------------------------------------
+ * extract n consecutive unsigned/signed bit fields of same length from byte
+ * data
+ * args   : unsigned char *buff I byte data
+ *          int    pos    I      bit position from start of data (bits)
+ *          int    len    I      bit length of a field (bits) (len<=32)
+ *          int    n      I      number of fields
+ *          (unsigned) int *data O extracted unsigned/signed bits
+ * return : bit position after last field (bits)
+ *-----------------------------------------------------------------------------*/
+extern int getbitun(const unsigned char *buff, int pos, int len, int n, unsigned int *data)
+{
+    const unsigned char *p = buff + pos / 8;
+    unsigned long long bits;
+    unsigned int mask;
+    int i, nb;
+
+    if (len <= 0 || 32 < len || n <= 0)
+        return pos;
+    mask = 0xFFFFFFFFu >> (32 - len);
+
+    /* bit accumulator with nb valid bits at lsb side */
+    nb = 8 - pos % 8;
+    bits = *p++;
+    for (i = 0; i < n; i++)
+    {
+        while (nb < len)
+        {
+            bits = (bits << 8) | *p++;
+            nb += 8;
+        }
+        nb -= len;
+        data[i] = (unsigned int)(bits >> nb) & mask;
+    }
+    return pos + len * n;
+}
+extern int getbitsn(const unsigned char *buff, int pos, int len, int n, int *data)
+{
+    int i, ret = getbitun(buff, pos, len, n, (unsigned int *)data);
+
+    if (len <= 0 || 32 <= len)
+        return ret;
+    for (i = 0; i < n; i++)
+    {
+        if (data[i] & (1u << (len - 1)))
+            data[i] = (int)((unsigned int)data[i] | (~0u << len)); /* extend sign */
+    }
+    return ret;
+}
 /* set unsigned/signed bits ----------------------------------------------------
  * set unsigned/signed bits to byte data
  * args   : unsigned char *buff IO byte data
@@ -933,6 +1013,63 @@ extern void setbits(unsigned char *buff, int pos, int len, int data)
         data &= ~(1 << (len - 1)); /* set sign bit */
     setbitu(buff, pos, len, (unsigned int)data);
 }
+/* slicing-by-8 crc tables ---------------------------------------------------
+ * tables are generated from the byte-wise tables at the first use. msb-first
+ * crcs (crc-24q, crc-16) are left-aligned to 32 bits
+ *---------------------------------------------------------------------------*/
+typedef struct {                 /* slicing-by-8 crc tables type */
+    unsigned int crc32[8][256];  /* crc-32 (lsb-first) */
+    unsigned int crc24q[8][256]; /* crc-24q (msb-first,<<8) */
+    unsigned int crc16[8][256];  /* crc-16 (msb-first,<<16) */
+} crctbl_t;
+
+static const crctbl_t *init_crctbl(void)
+{
+    static crctbl_t tbl;
+    unsigned int crc;
+    int i, j;
+
+    for (i = 0; i < 256; i++)
+    {
+        for (crc = i, j = 0; j < 8; j++)
+            crc = crc & 1 ? (crc >> 1) ^ POLYCRC32 : crc >> 1;
+        tbl.crc32[0][i] = crc;
+        tbl.crc24q[0][i] = tbl_CRC24Q[i] << 8;
+        tbl.crc16[0][i] = (unsigned int)tbl_CRC16[i] << 16;
+    }
+    for (i = 0; i < 256; i++)
+        for (j = 1; j < 8; j++)
+        {
+            crc = tbl.crc32[j - 1][i];
+            tbl.crc32[j][i] = (crc >> 8) ^ tbl.crc32[0][crc & 0xFF];
+            crc = tbl.crc24q[j - 1][i];
+            tbl.crc24q[j][i] = (crc << 8) ^ tbl.crc24q[0][crc >> 24];
+            crc = tbl.crc16[j - 1][i];
+            tbl.crc16[j][i] = (crc << 8) ^ tbl.crc16[0][crc >> 24];
+        }
+    return &tbl;
+}
+/* get crc tables (initialization of local static is thread-safe in c++11) ---*/
+static const crctbl_t *crctbl(void)
+{
+    static const crctbl_t *tbl = init_crctbl();
+    return tbl;
+}
+/* msb-first crc by slicing-by-8 (crc left-aligned to 32 bits) ---------------*/
+static unsigned int crc_msb(const unsigned int (*tbl)[256], unsigned int crc, const unsigned char *p, int len)
+{
+    unsigned int a;
+
+    for (; len >= 8; len -= 8, p += 8)
+    {
+        a = crc ^ ((unsigned int)p[0] << 24 | (unsigned int)p[1] << 16 | (unsigned int)p[2] << 8 | p[3]);
+        crc = tbl[7][a >> 24] ^ tbl[6][(a >> 16) & 0xFF] ^ tbl[5][(a >> 8) & 0xFF] ^ tbl[4][a & 0xFF] ^
+              tbl[3][p[4]] ^ tbl[2][p[5]] ^ tbl[1][p[6]] ^ tbl[0][p[7]];
+    }
+    for (; len > 0; len--)
+        crc = (crc << 8) ^ tbl[0][(crc >> 24) ^ *p++];
+    return crc;
+}
 /* crc-32 parity ---------------------------------------------------------------
  * compute crc-32 parity for novatel raw
  * args   : unsigned char *buff I data
@@ -942,22 +1079,21 @@ extern void setbits(unsigned char *buff, int pos, int len, int data)
  *-----------------------------------------------------------------------------*/
 extern unsigned int rtk_crc32(const unsigned char *buff, int len)
 {
-    unsigned int crc = 0;
-    int i, j;
+    const unsigned int (*tbl)[256] = crctbl()->crc32;
+    const unsigned char *p = buff;
+    unsigned int crc = 0, a;
 
     trace(4, "rtk_crc32: len=%d\n", len);
 
-    for (i = 0; i < len; i++)
+    for (; len >= 8; len -= 8, p += 8)
     {
-        crc ^= buff[i];
-        for (j = 0; j < 8; j++)
-        {
-            if (crc & 1)
-                crc = (crc >> 1) ^ POLYCRC32;
-            else
-                crc >>= 1;
-        }
+        a = crc ^ (p[0] | (unsigned int)p[1] << 8 | (unsigned int)p[2] << 16 | (unsigned int)p[3] << 24);
+        crc = tbl[7][a & 0xFF] ^ tbl[6][(a >> 8) & 0xFF] ^ tbl[5][(a >> 16) & 0xFF] ^
+              tbl[4][a >> 24] ^ tbl[3][p[4]] ^ tbl[2][p[5]] ^ tbl[1][p[6]] ^
+              tbl[0][p[7]];
     }
+    for (; len > 0; len--)
+        crc = (crc >> 8) ^ tbl[0][(crc ^ *p++) & 0xFF];
     return crc;
 }
 /* crc-24q parity --------------------------------------------------------------
@@ -969,17 +1105,12 @@ extern unsigned int rtk_crc32(const unsigned char *buff, int len)
  *-----------------------------------------------------------------------------*/
 extern unsigned int rtk_crc24q(const unsigned char *buff, int len)
 {
-    unsigned int crc = 0;
-    int i;
-
     trace(4, "rtk_crc24q: len=%d\n", len);
 
-    for (i = 0; i < len; i++)
-        crc = ((crc << 8) & 0xFFFFFF) ^ tbl_CRC24Q[(crc >> 16) ^ buff[i]];
-    return crc;
+    return crc_msb(crctbl()->crc24q, 0, buff, len) >> 8;
 }
 /* crc-16 parity ---------------------------------------------------------------
- * compute crc-16 parity for binex, nvs
+ * compute crc-16 parity for binex, nvs, sbf
  * args   : unsigned char *buff I data
  *          int    len    I      data length (bytes)
  * return : crc-16 parity
@@ -987,16 +1118,59 @@ extern unsigned int rtk_crc24q(const unsigned char *buff, int len)
  *-----------------------------------------------------------------------------*/
 extern unsigned short rtk_crc16(const unsigned char *buff, int len)
 {
-    unsigned short crc = 0;
-    int i;
-
     trace(4, "rtk_crc16: len=%d\n", len);
 
-    for (i = 0; i < len; i++)
+    return (unsigned short)(crc_msb(crctbl()->crc16, 0, buff, len) >> 16);
+}
+/* byte sum/xor checksum -------------------------------------------------------
+ * compute arithmetic sum or exclusive-or of bytes for receiver raw checksums
+ * args   : unsigned char *buff I data
+ *          int    len    I      data length (bytes)
+ * return : sum of bytes (modulo 2^32) or exclusive-or of bytes
+ * notes  : 8 bytes are processed at once in 16-bit lanes. the caller takes
+ *          lower 8 or 16 bits as the checksum
+ *-----------------------------------------------------------------------------*/
+extern unsigned int rtk_sum8(const unsigned char *buff, int len)
+{
+    const unsigned long long mask = 0x00FF00FF00FF00FFull;
+    unsigned long long w, acc;
+    unsigned int sum = 0;
+    int i, n;
+
+    while (len >= 8)
     {
-        crc = (crc << 8) ^ tbl_CRC16[((crc >> 8) ^ buff[i]) & 0xFF];
+        /* flush lanes before they overflow (255*2*128<65536) */
+        n = MIN(len / 8, 128);
+        for (acc = 0, i = 0; i < n; i++, buff += 8)
+        {
+            memcpy(&w, buff, 8);
+            acc += (w & mask) + ((w >> 8) & mask);
+        }
+        for (i = 0; i < 4; i++, acc >>= 16)
+            sum += (unsigned int)(acc & 0xFFFF);
+        len -= n * 8;
     }
-    return crc;
+    for (; len > 0; len--)
+        sum += *buff++;
+    return sum;
+}
+extern unsigned char rtk_xor8(const unsigned char *buff, int len)
+{
+    unsigned long long w, acc = 0;
+    unsigned char cs = 0;
+
+    for (; len >= 8; len -= 8, buff += 8)
+    {
+        memcpy(&w, buff, 8);
+        acc ^= w;
+    }
+    acc ^= acc >> 32;
+    acc ^= acc >> 16;
+    acc ^= acc >> 8;
+    cs = (unsigned char)acc;
+    for (; len > 0; len--)
+        cs ^= *buff++;
+    return cs;
 }
 /* decode navigation data word -------------------------------------------------
  * check party and decode navigation data word
@@ -1517,19 +1691,75 @@ extern void matmul(const char *tr, int n, int k, int m, double alpha, const doub
  *          int    n         I   size of matrix A
  * return : status (0:ok,0>:error)
  *-----------------------------------------------------------------------------*/
-extern int matinv(double *A, int n)
+static int matinv_(double *A, int n, int *ipiv, double *work)
 {
-    double *work;
-    int info, lwork = n * 16, *ipiv = imat(n, 1);
+    int info, lwork = n * 16;
 
-    work = mat(lwork, 1);
     dgetrf_(&n, &n, A, &n, ipiv, &info);
     if (!info)
         dgetri_(&n, A, &n, ipiv, work, &lwork, &info);
+    return info;
+}
+extern int matinv(double *A, int n)
+{
+    double *work;
+    int info, *ipiv = imat(n, 1);
+
+    work = mat(n * 16, 1);
+    info = matinv_(A, n, ipiv, work);
     free(ipiv);
     free(work);
     return info;
 }
+/* symmetric rank-k update of matrix (wrapper of blas dsyrk) ------------------
+ * symmetric rank-k update of matrix (C=C+alpha*A*A')
+ * args   : int    n,k       I   size of matrix A (n x k) and C (n x n)
+ *          double alpha     I   alpha
+ *          double *A        I   matrix A (n x k)
+ *          double *C        IO  symmetric matrix C (n x n)
+ * return : none
+ * notes  : only upper triangle of C is updated and then mirrored to lower
+ *-----------------------------------------------------------------------------*/
+extern void matsyrk(int n, int k, double alpha, const double *A, double *C)
+{
+    double beta = 1.0;
+    int i, j;
+
+    dsyrk_((char *)"U", (char *)"N", &n, &k, &alpha, (double *)A, &n, &beta, C, &n);
+    for (j = 0; j < n; j++)
+        for (i = 0; i < j; i++)
+            C[j + i * n] = C[i + j * n];
+}
+/* cholesky decomposition (A=U'*U, upper triangle of A is overwritten by U) --*/
+static int chol_(double *A, int n)
+{
+    int info;
+
+    dpotrf_((char *)"U", &n, A, &n, &info);
+    return info;
+}
+/* solve triangular system from right (B=B*U^-1, U: upper of A) --------------*/
+static void trsmru_(const double *A, int n, int m, double *B)
+{
+    double alpha = 1.0;
+
+    dtrsm_((char *)"R", (char *)"U", (char *)"N", (char *)"N", &n, &m, &alpha, (double *)A, &m, B, &n);
+}
+/* symmetric matrix-vector product (y=A*x, upper triangle of A used) --------*/
+static void symv_(int n, const double *A, const double *x, double *y)
+{
+    double alpha = 1.0, beta = 0.0;
+    int inc = 1;
+
+    dsymv_((char *)"U", &n, &alpha, (double *)A, &n, (double *)x, &inc, &beta, y, &inc);
+}
+/* symmetric rank-1 update (A=A+alpha*x*x', upper triangle of A updated) ----*/
+static void syr_(int n, double alpha, const double *x, double *A)
+{
+    int inc = 1;
+
+    dsyr_((char *)"U", &n, &alpha, (double *)x, &inc, A, &n);
+}
 /* singular value decomposition of matrix ------------------------------------
  * singular value decomposition of matrix of matrix (A= U*W*VT)
  * args   :  double *A        I  matrix (m x n)
@@ -1607,9 +1837,9 @@ extern void matmul(const char *tr, int n, int k, int m, double alpha, const doub
         }
 }
 /* LU decomposition ----------------------------------------------------------*/
-static int ludcmp(double *A, int n, int *indx, double *d)
+static int ludcmp(double *A, int n, int *indx, double *d, double *vv)
 {
-    double big, s, tmp, *vv = mat(n, 1);
+    double big, s, tmp;
     int i, imax = 0, j, k;
 
     *d = 1.0;
@@ -1623,7 +1853,6 @@ static int ludcmp(double *A, int n, int *indx, double *d)
             vv[i] = 1.0 / big;
         else
         {
-            free(vv);
             return -1;
         }
     }
@@ -1663,7 +1892,6 @@ static int ludcmp(double *A, int n, int *indx, double *d)
         indx[j] = imax;
         if (A[j + j * n] == 0.0)
         {
-            free(vv);
             return -1;
         }
         if (j != n - 1)
@@ -1673,7 +1901,6 @@ static int ludcmp(double *A, int n, int *indx, double *d)
                 A[i + j * n] *= tmp;
         }
     }
-    free(vv);
     return 0;
 }
 /* LU back-substitution ------------------------------------------------------*/
@@ -1703,20 +1930,14 @@ static void lubksb(const double *A, int n, const int *indx, double *b)
     }
 }
 /* inverse of matrix ---------------------------------------------------------*/
-extern int matinv(double *A, int n)
+static int matinv_(double *A, int n, int *indx, double *work)
 {
-    double d, *B;
-    int i, j, *indx;
+    double d, *B = work, *vv = work + n * n;
+    int i, j;
 
-    indx = imat(n, 1);
-    B = mat(n, n);
     matcpy(B, A, n, n);
-    if (ludcmp(B, n, indx, &d))
-    {
-        free(indx);
-        free(B);
+    if (ludcmp(B, n, indx, &d, vv))
         return -1;
-    }
     for (j = 0; j < n; j++)
     {
         for (i = 0; i < n; i++)
@@ -1724,10 +1945,97 @@ extern int matinv(double *A, int n)
         A[j + j * n] = 1.0;
         lubksb(B, n, indx, A + j * n);
     }
+    return 0;
+}
+extern int matinv(double *A, int n)
+{
+    double *work;
+    int info, *indx;
+
+    indx = imat(n, 1);
+    work = mat(n * (n + 1), 1);
+    info = matinv_(A, n, indx, work);
     free(indx);
-    free(B);
+    free(work);
+    return info;
+}
+/* symmetric rank-k update of matrix -----------------------------------------*/
+extern void matsyrk(int n, int k, double alpha, const double *A, double *C)
+{
+    double d;
+    int i, j, x;
+
+    for (j = 0; j < n; j++)
+    {
+        for (i = 0; i <= j; i++)
+        {
+            d = 0.0;
+            for (x = 0; x < k; x++)
+                d += A[i + x * n] * A[j + x * n];
+            C[i + j * n] += alpha * d;
+            C[j + i * n] = C[i + j * n];
+        }
+    }
+}
+/* cholesky decomposition ----------------------------------------------------*/
+static int chol_(double *A, int n)
+{
+    double s;
+    int i, j, k;
+
+    for (j = 0; j < n; j++)
+    {
+        s = A[j + j * n];
+        for (k = 0; k < j; k++)
+            s -= A[k + j * n] * A[k + j * n];
+        if (s <= 0.0)
+            return j + 1;
+        A[j + j * n] = sqrt(s);
+        for (i = j + 1; i < n; i++)
+        {
+            s = A[j + i * n];
+            for (k = 0; k < j; k++)
+                s -= A[k + j * n] * A[k + i * n];
+            A[j + i * n] = s / A[j + j * n];
+        }
+    }
     return 0;
 }
+/* solve triangular system from right ---------------------------------------*/
+static void trsmru_(const double *A, int n, int m, double *B)
+{
+    int i, j, k;
+
+    for (j = 0; j < m; j++)
+    {
+        for (k = 0; k < j; k++)
+            for (i = 0; i < n; i++)
+                B[i + j * n] -= B[i + k * n] * A[k + j * m];
+        for (i = 0; i < n; i++)
+            B[i + j * n] /= A[j + j * m];
+    }
+}
+/* symmetric matrix-vector product -------------------------------------------*/
+static void symv_(int n, const double *A, const double *x, double *y)
+{
+    int i, j;
+
+    for (i = 0; i < n; i++)
+    {
+        y[i] = 0.0;
+        for (j = 0; j < n; j++)
+            y[i] += (i <= j ? A[i + j * n] : A[j + i * n]) * x[j];
+    }
+}
+/* symmetric rank-1 update ---------------------------------------------------*/
+static void syr_(int n, double alpha, const double *x, double *A)
+{
+    int i, j;
+
+    for (j = 0; j < n; j++)
+        for (i = 0; i <= j; i++)
+            A[i + j * n] += alpha * x[i] * x[j];
+}
 /* solve linear equation -----------------------------------------------------*/
 extern int solve(const char *tr, const double *A, const double *Y, int n, int m, double *X)
 {
@@ -1898,7 +2206,7 @@ extern double det(const double *A, int n)
 /* kalman filter ---------------------------------------------------------------
  * kalman filter state update as follows:
  *
- *   K=P*H*(H'*P*H+R)^-1, xp=x+K*v, Pp=(I-K*H')*P
+ *   K=P*H*(H'*P*H+R)^-1, xp=x+K*v, Pp=(I-K*H')*P=P-K*(P*H)'
  *
  * args   : double *x        I   states vector (n x 1)
  *          double *P        I   covariance matrix of states (n x n)
@@ -1911,31 +2219,160 @@ extern double det(const double *A, int n)
  * return : status (0:ok,<0:error)
  * notes  : matirix stored by column-major order (fortran convention)
  *          if state x[i]==0.0, not updates state x[i]/P[i+i*n]
+ *          covariance is updated by Pp=P-W*W' (W=P*H*U^-1, H'*P*H+R=U'*U)
+ *          with cholesky factor of innovation covariance, only upper
+ *          triangle of Pp is computed and mirrored so Pp is kept symmetric
  *-----------------------------------------------------------------------------*/
 static int filter_(const double *x, const double *P, const double *H, const double *v, const double *R, int n, int m,
-                   double *xp, double *Pp)
+                   double *xp, double *Pp, filtws_t *ws)
 {
-    double *F = mat(n, m), *Q = mat(m, m), *K = mat(n, m), *I = eye(n);
+    double *F = ws->F, *Q = ws->Q, *K = ws->K, *z = ws->work;
     int info;
 
     matcpy(Q, R, m, m);
     matcpy(xp, x, n, 1);
     matmul("NN", n, m, n, 1.0, P, H, 0.0, F); /* Q=H'*P*H+R */
     matmul("TN", m, m, n, 1.0, H, F, 1.0, Q);
-    if (!(info = matinv(Q, m)))
+    matcpy(Pp, P, n, n);
+
+    if (!chol_(Q, m))
+    {
+        matcpy(K, F, n, m); /* Q=U'*U, W=P*H*U^-1 */
+        trsmru_(Q, n, m, K);
+        matcpy(z, v, m, 1); /* xp=x+W*U'^-1*v */
+        trsmru_(Q, 1, m, z);
+        matmul("NN", n, 1, m, 1.0, K, z, 1.0, xp);
+        matsyrk(n, m, -1.0, K, Pp); /* Pp=P-W*W' */
+        return 0;
+    }
+    /* innovation covariance not positive definite */
+    matcpy(Q, R, m, m);
+    matmul("TN", m, m, n, 1.0, H, F, 1.0, Q);
+    if (!(info = matinv_(Q, m, ws->ipiv, ws->work)))
     {
         matmul("NN", n, m, m, 1.0, F, Q, 0.0, K);  /* K=P*H*Q^-1 */
         matmul("NN", n, 1, m, 1.0, K, v, 1.0, xp); /* xp=x+K*v */
-        matmul("NT", n, n, m, -1.0, K, H, 1.0, I); /* Pp=(I-K*H')*P */
-        matmul("NN", n, n, n, 1.0, I, P, 0.0, Pp);
+        matmul("NT", n, n, m, -1.0, K, F, 1.0, Pp); /* Pp=P-K*(P*H)' */
     }
-    free(F);
-    free(Q);
-    free(K);
-    free(I);
     return info;
 }
-extern int filter(double *x, double *P, const double *H, const double *v, const double *R, int n, int m)
+/* sequential kalman filter ----------------------------------------------------
+ * kalman filter state update processing measurements one by one:
+ *
+ *   K=P*h/(h'*P*h+r), xp=xp+K*(v-h'*(xp-x)), Pp=Pp-K*(P*h)'
+ *
+ * args   : (same as filter_())
+ * return : status (0:ok,<0:error)
+ * notes  : if R is not diagonal, measurements are decorrelated by cholesky
+ *          factor of R (R=U'*U, H=H*U^-1, v'=v'*U^-1) before the updates
+ *-----------------------------------------------------------------------------*/
+static int filtseq_(const double *x, const double *P, const double *H, const double *v, const double *R, int n,
+                    int m, double *xp, double *Pp, filtws_t *ws)
+{
+    double *U = ws->Q, *Hw = ws->K, *Ph = ws->F, *vw = ws->work, *r = ws->work + m, *h, s, e;
+    int i, j, diag = 1;
+
+    for (i = 0; i < m && diag; i++)
+        for (j = 0; j < m; j++)
+        {
+            if (i != j && R[i + j * m] != 0.0)
+            {
+                diag = 0;
+                break;
+            }
+        }
+    matcpy(Hw, H, n, m);
+    matcpy(vw, v, m, 1);
+    if (diag)
+    {
+        for (i = 0; i < m; i++)
+            r[i] = R[i + i * m];
+    }
+    else
+    {
+        matcpy(U, R, m, m);
+        if (chol_(U, m))
+            return -1;
+        trsmru_(U, n, m, Hw);
+        trsmru_(U, 1, m, vw);
+        for (i = 0; i < m; i++)
+            r[i] = 1.0;
+    }
+    matcpy(xp, x, n, 1);
+    matcpy(Pp, P, n, n);
+
+    for (j = 0; j < m; j++)
+    {
+        h = Hw + j * n;
+        symv_(n, Pp, h, Ph);
+        if ((s = dot(h, Ph, n) + r[j]) <= 0.0)
+            return -1;
+        e = vw[j] - dot(h, xp, n) + dot(h, x, n);
+        for (i = 0; i < n; i++)
+            xp[i] += Ph[i] * e / s;
+        syr_(n, -1.0 / s, Ph, Pp);
+    }
+    for (j = 0; j < n; j++) /* mirror upper triangle */
+        for (i = 0; i < j; i++)
+            Pp[j + i * n] = Pp[i + j * n];
+    return 0;
+}
+/* initialize kalman filter workspace ------------------------------------------
+ * allocate work matrices of filter_ws() for given max dimensions
+ * args   : filtws_t *ws     O   kalman filter workspace
+ *          int    n,m       I   max number of states and measurements
+ * return : status (1:ok,0:memory allocation error)
+ *-----------------------------------------------------------------------------*/
+extern int initfiltws(filtws_t *ws, int n, int m)
+{
+    trace(4, "initfiltws: n=%d m=%d\n", n, m);
+
+    ws->nmax = ws->mmax = 0;
+    ws->ix = ws->ipiv = NULL;
+    ws->x = ws->xp = ws->P = ws->Pp = ws->H = NULL;
+    ws->F = ws->Q = ws->K = ws->work = NULL;
+    if (n <= 0 || m <= 0)
+        return 1;
+
+    if (!(ws->ix = (int *)malloc(sizeof(int) * n)) || !(ws->ipiv = (int *)malloc(sizeof(int) * m)) ||
+        !(ws->x = (double *)malloc(sizeof(double) * n)) || !(ws->xp = (double *)malloc(sizeof(double) * n)) ||
+        !(ws->P = (double *)malloc(sizeof(double) * n * n)) || !(ws->Pp = (double *)malloc(sizeof(double) * n * n)) ||
+        !(ws->H = (double *)malloc(sizeof(double) * n * m)) || !(ws->F = (double *)malloc(sizeof(double) * n * m)) ||
+        !(ws->Q = (double *)malloc(sizeof(double) * m * m)) || !(ws->K = (double *)malloc(sizeof(double) * n * m)) ||
+        !(ws->work = (double *)malloc(sizeof(double) * m * (m + 16))))
+    {
+        freefiltws(ws);
+        return 0;
+    }
+    ws->nmax = n;
+    ws->mmax = m;
+    return 1;
+}
+/* free kalman filter workspace ------------------------------------------------
+ * args   : filtws_t *ws     IO  kalman filter workspace
+ * return : none
+ *-----------------------------------------------------------------------------*/
+extern void freefiltws(filtws_t *ws)
+{
+    free(ws->ix);
+    free(ws->ipiv);
+    free(ws->x);
+    free(ws->xp);
+    free(ws->P);
+    free(ws->Pp);
+    free(ws->H);
+    free(ws->F);
+    free(ws->Q);
+    free(ws->K);
+    free(ws->work);
+    ws->ix = ws->ipiv = NULL;
+    ws->x = ws->xp = ws->P = ws->Pp = ws->H = NULL;
+    ws->F = ws->Q = ws->K = ws->work = NULL;
+    ws->nmax = ws->mmax = 0;
+}
+/* kalman filter for effective states ----------------------------------------*/
+static int filterix(filtws_t *ws, double *x, double *P, const double *H, const double *v, const double *R, int n,
+                    int m, int seq)
 {
     double *x_, *xp_, *P_, *Pp_, *H_;
     int i, j, k, info, *ix;
@@ -1944,17 +2381,30 @@ extern int filter(double *x, double *P, const double *H, const double *v, const
         if (x[i] == 0.0)
             x[i] = 1E-20;
 
-    ix = imat(n, 1);
+    if (n <= 0 || m <= 0)
+        return 0;
+    if (n > ws->nmax || m > ws->mmax)
+    {
+        i = MAX(n, ws->nmax);
+        j = MAX(m, ws->mmax);
+        freefiltws(ws);
+        if (!initfiltws(ws, i, j))
+        {
+            fatalerr("filter workspace allocation error: n=%d,m=%d\n", i, j);
+            return -1;
+        }
+    }
+    ix = ws->ix;
     for (i = k = 0; i < n; i++)
     {
         if ((x[i] != 0.0 && P[i + i * n] > 0.0) && x[i] != DISFLAG)
             ix[k++] = i;
     }
-    x_ = mat(k, 1);
-    xp_ = mat(k, 1);
-    P_ = mat(k, k);
-    Pp_ = mat(k, k);
-    H_ = mat(k, m);
+    x_ = ws->x;
+    xp_ = ws->xp;
+    P_ = ws->P;
+    Pp_ = ws->Pp;
+    H_ = ws->H;
     for (i = 0; i < k; i++)
     {
         x_[i] = x[ix[i]];
@@ -1963,7 +2413,10 @@ extern int filter(double *x, double *P, const double *H, const double *v, const
         for (j = 0; j < m; j++)
             H_[i + j * k] = H[ix[i] + j * n];
     }
-    info = filter_(x_, P_, H_, v, R, k, m, xp_, Pp_);
+    if (seq)
+        info = filtseq_(x_, P_, H_, v, R, k, m, xp_, Pp_, ws);
+    else
+        info = filter_(x_, P_, H_, v, R, k, m, xp_, Pp_, ws);
 
     if (!info)
         for (i = 0; i < k; i++)
@@ -1972,12 +2425,45 @@ extern int filter(double *x, double *P, const double *H, const double *v, const
             for (j = 0; j < k; j++)
                 P[ix[i] + ix[j] * n] = Pp_[i + j * k];
         }
-    free(ix);
-    free(x_);
-    free(xp_);
-    free(P_);
-    free(Pp_);
-    free(H_);
+    return info;
+}
+/* kalman filter with workspace ------------------------------------------------
+ * same as filter() but all work matrices are taken from given workspace
+ * args   : filtws_t *ws     IO  kalman filter workspace
+ *          (other args are same as filter())
+ * return : status (0:ok,<0:error)
+ * notes  : workspace is enlarged if n or m exceeds the allocated size, so no
+ *          heap allocation occurs once it covers the max state/measurement
+ *          dimension of the caller
+ *-----------------------------------------------------------------------------*/
+extern int filter_ws(filtws_t *ws, double *x, double *P, const double *H, const double *v, const double *R, int n,
+                     int m)
+{
+    return filterix(ws, x, P, H, v, R, n, m, 0);
+}
+/* sequential kalman filter with workspace -------------------------------------
+ * same as filter_ws() but measurements are processed one at a time without
+ * inversion of innovation covariance (O(n^2) per measurement)
+ * args   : (same as filter_ws())
+ * return : status (0:ok,<0:error)
+ * notes  : suitable for uncorrelated measurements (diagonal R). correlated
+ *          measurements (e.g. double-differenced) are decorrelated by
+ *          cholesky factor of R before the updates
+ *-----------------------------------------------------------------------------*/
+extern int filter_seq(filtws_t *ws, double *x, double *P, const double *H, const double *v, const double *R, int n,
+                      int m)
+{
+    return filterix(ws, x, P, H, v, R, n, m, 1);
+}
+extern int filter(double *x, double *P, const double *H, const double *v, const double *R, int n, int m)
+{
+    filtws_t ws;
+    int info;
+
+    if (!initfiltws(&ws, n, m))
+        return -1;
+    info = filter_ws(&ws, x, P, H, v, R, n, m);
+    freefiltws(&ws);
     return info;
 }
 /* smoother --------------------------------------------------------------------
@@ -2182,23 +2668,95 @@ extern void matprint(const double A[], int n, int m, int p, int q)
 {
     matfprint(A, n, m, p, q, stdout);
 }
+/* string to number by sscanf() --------------------------------------------*/
+static double str2num_s(const char *s, int n)
+{
+    double value;
+    char str[256], *p = str;
+
+    for (; *s && --n >= 0; s++)
+        *p++ = *s == 'd' || *s == 'D' ? 'E' : *s;
+    *p = '\0';
+    return sscanf(str, "%lf", &value) == 1 ? value : 0.0;
+}
 /* string to number ------------------------------------------------------------
  * convert substring in string to number
  * args   : char   *s        I   string ("... nnn.nnn ...")
  *          int    i,n       I   substring position and width
  * return : converted number (0.0:error)
+ * notes  : fixed-width decimal fields of rinex ("nnn.nnn", "n.nnnnD+nn") are
+ *          converted without sscanf() and independent of locale. the result
+ *          is exact if the mantissa is within 2^53 and the exponent within
+ *          +-22, otherwise it falls back to sscanf().
  *-----------------------------------------------------------------------------*/
 extern double str2num(const char *s, int i, int n)
 {
-    double value;
-    char str[256], *p = str;
+    static const double pow10[] = {1E0,  1E1,  1E2,  1E3,  1E4,  1E5,  1E6,  1E7,  1E8,  1E9,  1E10, 1E11,
+                                   1E12, 1E13, 1E14, 1E15, 1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22};
+    const char *p, *q;
+    uint64_t mant = 0;
+    int nd = 0, nz = 0, exp = 0, e = 0, esgn = 0, sgn = 0;
 
-    if (i < 0 || (int)strlen(s) < i || (int)sizeof(str) - 1 < n)
+    if (i < 0 || 255 < n)
         return 0.0;
-    for (s += i; *s && --n >= 0; s++)
-        *p++ = *s == 'd' || *s == 'D' ? 'E' : *s;
-    *p = '\0';
-    return sscanf(str, "%lf", &value) == 1 ? value : 0.0;
+    for (p = s; p < s + i; p++)
+    {
+        if (!*p)
+            return 0.0;
+    }
+    q = p + n;
+
+    /* skip white spaces and sign */
+    while (p < q && (*p == ' ' || (*p >= '\t' && *p <= '\r')))
+        p++;
+    if (p >= q || !*p)
+        return 0.0;
+    if (*p == '+' || *p == '-')
+        sgn = *p++ == '-';
+
+    /* mantissa (leading zeros are not counted as digits) */
+    for (; p < q && *p >= '0' && *p <= '9'; p++, nz++)
+    {
+        if (mant == 0 && *p == '0')
+            continue;
+        if (++nd > 19)
+            return str2num_s(s + i, n);
+        mant = mant * 10 + (*p - '0');
+    }
+    if (p < q && *p == '.')
+    {
+        for (p++; p < q && *p >= '0' && *p <= '9'; p++, nz++)
+        {
+            exp--;
+            if (mant == 0 && *p == '0')
+                continue;
+            if (++nd > 19)
+                return str2num_s(s + i, n);
+            mant = mant * 10 + (*p - '0');
+        }
+    }
+    if (nz <= 0 || (p < q && (*p == 'x' || *p == 'X')))
+        return str2num_s(s + i, n);
+
+    /* exponent (fortran "D" allowed, ignored without digits as sscanf()) */
+    if (p < q && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D'))
+    {
+        p++;
+        if (p < q && (*p == '+' || *p == '-'))
+            esgn = *p++ == '-';
+        for (; p < q && *p >= '0' && *p <= '9'; p++)
+        {
+            if (e < 10000)
+                e = e * 10 + (*p - '0');
+        }
+        exp += esgn ? -e : e;
+    }
+    if (mant == 0)
+        return sgn ? -0.0 : 0.0;
+    if (mant > ((uint64_t)1 << 53) || exp < -22 || exp > 22)
+        return str2num_s(s + i, n);
+
+    return (sgn ? -1.0 : 1.0) * (exp < 0 ? (double)mant / pow10[-exp] : (double)mant * pow10[exp]);
 }
 /* transpose matrix-----------------------------------------------------------
  * args   : double  *A      I   matrix
@@ -2721,7 +3279,7 @@ extern void time2str(gtime_t t, char *s, int n)
  *-----------------------------------------------------------------------------*/
 extern char *time_str(gtime_t t, int n)
 {
-    static char buff[64];
+    static thread_local char buff[64];
     time2str(t, buff, n);
     return buff;
 }
@@ -3150,8 +3708,8 @@ static void nut_iau1980(double t, const double *f, double *dpsi, double *deps)
 extern void eci2ecef(gtime_t tutc, const double *erpv, double *U, double *gmst)
 {
     const double ep2000[] = {2000, 1, 1, 12, 0, 0};
-    static gtime_t tutc_;
-    static double U_[9], gmst_;
+    static thread_local gtime_t tutc_;
+    static thread_local double U_[9], gmst_;
     gtime_t tgps;
     double eps, ze, th, z, t, t2, t3, dpsi, deps, gast, f[5];
     double R1[9], R2[9], R3[9], R[9], W[9], N[9], P[9], NP0[9];
@@ -3886,6 +4444,9 @@ extern void uniqnav(nav_t *nav)
     uniqgeph(nav);
     uniqseph(nav);
 
+    /* index ephemeris by satellite and toe */
+    indexnav(nav);
+
     /* update carrier wave length */
     for (i = 0; i < MAXSAT; i++)
         for (j = 0; j < NFREQ; j++)
@@ -3910,6 +4471,105 @@ extern void uniqnav(nav_t *nav)
         }
     }
 }
+/* compare ephemeris index entries -------------------------------------------*/
+static int cmpephkey(const void *p1, const void *p2)
+{
+    ephkey_t *q1 = (ephkey_t *)p1, *q2 = (ephkey_t *)p2;
+    double tt = timediff(q1->toe, q2->toe);
+    if (q1->sat != q2->sat)
+        return q1->sat - q2->sat;
+    if (tt != 0.0)
+        return tt < 0.0 ? -1 : 1;
+    return q1->i - q2->i;
+}
+/* sort index entries and set offsets of satellites --------------------------*/
+static void sortephidx(ephidx_t *idx, int n, int nkey)
+{
+    int i, sat;
+
+    qsort(idx->key, nkey, sizeof(ephkey_t), cmpephkey);
+
+    for (i = sat = 0; sat <= MAXSAT; sat++)
+    {
+        for (; i < nkey && idx->key[i].sat <= sat; i++)
+            ;
+        idx->off[sat] = i;
+    }
+    idx->n = n;
+}
+/* allocate ephemeris index --------------------------------------------------*/
+static int allocephidx(ephidx_t *idx, int n)
+{
+    ephkey_t *key;
+
+    idx->n = 0;
+    if (n <= idx->nmax)
+        return 1;
+    if (!(key = (ephkey_t *)realloc(idx->key, sizeof(ephkey_t) * n)))
+    {
+        trace(1, "indexnav malloc error n=%d\n", n);
+        free(idx->key);
+        idx->key = NULL;
+        idx->nmax = 0;
+        return 0;
+    }
+    idx->key = key;
+    idx->nmax = n;
+    return 1;
+}
+/* index ephemerides -----------------------------------------------------------
+ * index ephemerides in navigation data by satellite and toe for selection
+ * args   : nav_t *nav    IO     navigation data
+ * return : none
+ * notes  : call it again after ephemerides are added, deleted or overwritten.
+ *          ephemeris selection falls back to linear search if the number of
+ *          ephemerides differs from the one indexed
+ *-----------------------------------------------------------------------------*/
+extern void indexnav(nav_t *nav)
+{
+    int i, n;
+
+    trace(3, "indexnav: neph=%d ngeph=%d nseph=%d\n", nav->n, nav->ng, nav->ns);
+
+    updnavgen();
+
+    if (allocephidx(&nav->ieph, nav->n))
+    {
+        for (i = n = 0; i < nav->n; i++)
+        {
+            if (nav->eph[i].sat <= 0 || nav->eph[i].sat > MAXSAT)
+                continue;
+            nav->ieph.key[n].toe = nav->eph[i].toe;
+            nav->ieph.key[n].sat = nav->eph[i].sat;
+            nav->ieph.key[n++].i = i;
+        }
+        sortephidx(&nav->ieph, nav->n, n);
+    }
+    if (allocephidx(&nav->igeph, nav->ng))
+    {
+        for (i = n = 0; i < nav->ng; i++)
+        {
+            if (nav->geph[i].sat <= 0 || nav->geph[i].sat > MAXSAT)
+                continue;
+            nav->igeph.key[n].toe = nav->geph[i].toe;
+            nav->igeph.key[n].sat = nav->geph[i].sat;
+            nav->igeph.key[n++].i = i;
+        }
+        sortephidx(&nav->igeph, nav->ng, n);
+    }
+    if (allocephidx(&nav->iseph, nav->ns))
+    {
+        for (i = n = 0; i < nav->ns; i++)
+        {
+            if (nav->seph[i].sat <= 0 || nav->seph[i].sat > MAXSAT)
+                continue;
+            nav->iseph.key[n].toe = nav->seph[i].t0;
+            nav->iseph.key[n].sat = nav->seph[i].sat;
+            nav->iseph.key[n++].i = i;
+        }
+        sortephidx(&nav->iseph, nav->ns, n);
+    }
+}
 /* compare observation data -------------------------------------------------*/
 static int cmpobs(const void *p1, const void *p2)
 {
@@ -4094,6 +4754,10 @@ extern int readnav(const char *file, nav_t *nav)
         }
     }
     fclose(fp);
+
+    /* update ephemeris index if indexed */
+    if (nav->ieph.key || nav->igeph.key)
+        indexnav(nav);
     return 1;
 }
 extern int savenav(const char *file, const nav_t *nav)
@@ -4169,23 +4833,34 @@ extern void freeobs(obs_t *obs)
  *-----------------------------------------------------------------------------*/
 extern void freenav(nav_t *nav, int opt)
 {
+    updnavgen();
+
     if (opt & 0x01)
     {
         free(nav->eph);
         nav->eph = NULL;
         nav->n = nav->nmax = 0;
+        free(nav->ieph.key);
+        nav->ieph.key = NULL;
+        nav->ieph.n = nav->ieph.nmax = 0;
     }
     if (opt & 0x02)
     {
         free(nav->geph);
         nav->geph = NULL;
         nav->ng = nav->ngmax = 0;
+        free(nav->igeph.key);
+        nav->igeph.key = NULL;
+        nav->igeph.n = nav->igeph.nmax = 0;
     }
     if (opt & 0x04)
     {
         free(nav->seph);
         nav->seph = NULL;
         nav->ns = nav->nsmax = 0;
+        free(nav->iseph.key);
+        nav->iseph.key = NULL;
+        nav->iseph.n = nav->iseph.nmax = 0;
     }
     if (opt & 0x08)
     {
@@ -5550,6 +6225,191 @@ extern int rtk_uncompress(const char *file, char *uncfile)
     trace(3, "rtk_uncompress: stat=%d\n", stat);
     return stat;
 }
+/* set data cache --------------------------------------------------------------
+ * enable or disable cache of parsed input files
+ * args   : int    ena       I   cache (0:off,1:on)
+ * return : none
+ * notes  : cache files (<file>.nvc) are written next to the input files.
+ *-----------------------------------------------------------------------------*/
+extern void setcache(int ena)
+{
+    cacheena = ena;
+}
+/* cache file path and signature of input file -------------------------------*/
+static int cachesig(const char *file, const char *key, char *path, unsigned int *sig)
+{
+    struct stat st;
+    unsigned int layout[8];
+
+    if (!cacheena || !*file || stat(file, &st))
+        return 0;
+
+    sprintf(path, "%s%s", file, CACHEEXT);
+
+    layout[0] = CACHEVER;
+    layout[1] = (unsigned int)sizeof(obsd_t);
+    layout[2] = (unsigned int)sizeof(eph_t);
+    layout[3] = (unsigned int)sizeof(geph_t);
+    layout[4] = (unsigned int)sizeof(seph_t);
+    layout[5] = (unsigned int)sizeof(peph_t);
+    layout[6] = (unsigned int)sizeof(pclk_t);
+    layout[7] = (unsigned int)sizeof(sta_t);
+
+    /* code priorities select the signals read from rinex obs */
+    sig[0] = CACHEID;
+    sig[1] = rtk_crc32((unsigned char *)layout, sizeof(layout)) ^ rtk_crc32((unsigned char *)codepris, sizeof(codepris));
+    sig[2] = rtk_crc32((const unsigned char *)key, (int)strlen(key));
+    sig[3] = (unsigned int)((unsigned long long)st.st_size & 0xFFFFFFFF);
+    sig[4] = (unsigned int)((unsigned long long)st.st_size >> 32);
+    sig[5] = (unsigned int)((unsigned long long)st.st_mtime & 0xFFFFFFFF);
+    sig[6] = (unsigned int)((unsigned long long)st.st_mtime >> 32);
+    return 1;
+}
+/* read data cache -------------------------------------------------------------
+ * read cache of parsed input file
+ * args   : char   *file     I   input file
+ *          char   *key      I   cache key (reader and read options)
+ *          cache_t *cache   O   cache data (call freecache() to free)
+ * return : status (1:ok,0:no valid cache,-1:cache disabled)
+ * notes  : the cache is valid only if the data layout, the key, the size and
+ *          the modified time of the input file and the data checksum match.
+ *-----------------------------------------------------------------------------*/
+extern int readcache(const char *file, const char *key, cache_t *cache)
+{
+    FILE *fp;
+    unsigned int sig[7], head[9];
+    char path[1024];
+    int stat = 0;
+
+    cache->buff = NULL;
+    cache->n = cache->nmax = cache->pos = 0;
+
+    if (!cacheena)
+        return -1;
+    if (!cachesig(file, key, path, sig) || !(fp = fopen(path, "rb")))
+        return 0;
+
+    /* cache of other reader or options or outdated cache */
+    if (fread(head, sizeof(head), 1, fp) != 1 || memcmp(head, sig, sizeof(sig)))
+    {
+        trace(3, "readcache: cache unmatched %s\n", path);
+        fclose(fp);
+        return 0;
+    }
+    if ((cache->buff = (unsigned char *)malloc(head[7] + 1)))
+    {
+        stat = fread(cache->buff, 1, head[7], fp) == head[7] && rtk_crc32(cache->buff, (int)head[7]) == head[8];
+    }
+    fclose(fp);
+
+    if (!stat)
+    {
+        trace(2, "cache data error: %s\n", path);
+        freecache(cache);
+        return 0;
+    }
+    cache->n = cache->nmax = (int)head[7];
+
+    trace(3, "readcache: %s n=%d\n", path, cache->n);
+    return 1;
+}
+/* write data cache ------------------------------------------------------------
+ * write cache of parsed input file
+ * args   : char   *file     I   input file
+ *          char   *key      I   cache key (reader and read options)
+ *          cache_t *cache   I   cache data
+ * return : status (1:ok,0:error)
+ *-----------------------------------------------------------------------------*/
+extern int writecache(const char *file, const char *key, const cache_t *cache)
+{
+    FILE *fp;
+    unsigned int head[9];
+    char path[1024], tmpfile[1040];
+    int stat;
+
+    if (!cachesig(file, key, path, head))
+        return 0;
+
+    head[7] = (unsigned int)cache->n;
+    head[8] = rtk_crc32(cache->buff, cache->n);
+
+    /* write to temporary file and rename to avoid partial cache */
+    sprintf(tmpfile, "%s.tmp", path);
+
+    if (!(fp = fopen(tmpfile, "wb")))
+    {
+        trace(2, "cache file open error: %s\n", tmpfile);
+        return 0;
+    }
+    stat = fwrite(head, sizeof(head), 1, fp) == 1 && (int)fwrite(cache->buff, 1, cache->n, fp) == cache->n;
+    stat = !fclose(fp) && stat;
+
+    if (stat)
+    {
+        remove(path);
+        stat = !rename(tmpfile, path);
+    }
+    if (!stat)
+    {
+        trace(2, "cache file write error: %s\n", path);
+        remove(tmpfile);
+        return 0;
+    }
+    trace(3, "writecache: %s n=%d\n", path, cache->n);
+    return 1;
+}
+/* put data to cache -----------------------------------------------------------
+ * append data to cache buffer
+ * args   : cache_t *cache   IO  cache data
+ *          void   *data     I   data
+ *          int    size      I   data size (bytes)
+ * return : status (1:ok,0:memory allocation error)
+ *-----------------------------------------------------------------------------*/
+extern int putcache(cache_t *cache, const void *data, int size)
+{
+    unsigned char *buff;
+    int nmax;
+
+    if (cache->n + size > cache->nmax)
+    {
+        for (nmax = cache->nmax <= 0 ? 65536 : cache->nmax; nmax < cache->n + size; nmax *= 2)
+            ;
+        if (!(buff = (unsigned char *)realloc(cache->buff, nmax)))
+        {
+            trace(1, "putcache: malloc error n=%d\n", nmax);
+            return 0;
+        }
+        cache->buff = buff;
+        cache->nmax = nmax;
+    }
+    if (size > 0)
+        memcpy(cache->buff + cache->n, data, size);
+    cache->n += size;
+    return 1;
+}
+/* get data from cache ---------------------------------------------------------
+ * get data from cache buffer at read position
+ * args   : cache_t *cache   IO  cache data
+ *          void   *data     O   data (NULL: skip data)
+ *          int    size      I   data size (bytes)
+ * return : status (1:ok,0:end of cache)
+ *-----------------------------------------------------------------------------*/
+extern int getcache(cache_t *cache, void *data, int size)
+{
+    if (size < 0 || cache->pos + size > cache->n)
+        return 0;
+    if (data && size > 0)
+        memcpy(data, cache->buff + cache->pos, size);
+    cache->pos += size;
+    return 1;
+}
+/* free data cache -----------------------------------------------------------*/
+extern void freecache(cache_t *cache)
+{
+    free(cache->buff);
+    cache->buff = NULL;
+    cache->n = cache->nmax = cache->pos = 0;
+}
 /*---------------------------------------------------------------------------
  * Name        : gravitationalDelayCorrection
  * Description : Obtains the gravitational delay correction for the effect of
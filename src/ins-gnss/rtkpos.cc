@@ -37,6 +37,10 @@
  *           2016/07/30 1.21 suppress single solution if !prcopt.outsingle
  *                           fix bug on slip detection of backward filter
  *           2016/08/20 1.22 fix bug on ddres() function
+ *           2026/10/16 1.23 make work buffers thread-local for concurrent
+ *                           forward/backward filters
+ *                           partial ambiguity resolution by pos2-armaxiter
+ *           2026/10/17 1.24 keep lambda workspace in rtk control struct
  *-----------------------------------------------------------------------------*/
 #include <navlib.h>
 #include <stdarg.h>
@@ -68,6 +72,7 @@
 #define THRES_INHERIT_TIME 1.5 /* threshold of ambiguity inherit */
 #define THRES_INHERIT_BIAS 1.0 /* threshold of ambiguity inherit */
 #define INHERIT_AMB 1
+#define MINAMB_PAR 4 /* min number of ambiguities for partial ar */
 
 #define TTOL_MOVEB (1.0 + 2 * DTTOL)
 /* time sync tolerance for moving-baseline (s) */
@@ -1928,7 +1933,7 @@ static int ddres(rtk_t *rtk, const nav_t *nav, const obsd_t *obs, double dt, con
     /* end of system loop */
 #if DETECT_OUTLIER
     static const double r0 = re_norm(0.95), r1 = re_norm(0.99);
-    static double s0;
+    static thread_local double s0;
 
     /* detect outlier by L1/L2 phase double difference residual */
     if (nf >= 2 && opt->mode > PMODE_DGPS)
@@ -2068,10 +2073,10 @@ static int ddres(rtk_t *rtk, const nav_t *nav, const obsd_t *obs, double dt, con
 /* time-interpolation of residuals (for post-mission) ------------------------*/
 static double intpres(gtime_t time, const obsd_t *obs, int n, const nav_t *nav, rtk_t *rtk, double *y)
 {
-    static obsd_t obsb[MAXOBS];
-    static double yb[MAXOBS * NFREQ * 2], rs[MAXOBS * 6], dts[MAXOBS * 2], var[MAXOBS];
-    static double e[MAXOBS * 3], azel[MAXOBS * 2];
-    static int nb = 0, svh[MAXOBS * 2];
+    static thread_local obsd_t obsb[MAXOBS];
+    static thread_local double yb[MAXOBS * NFREQ * 2], rs[MAXOBS * 6], dts[MAXOBS * 2], var[MAXOBS];
+    static thread_local double e[MAXOBS * 3], azel[MAXOBS * 2];
+    static thread_local int nb = 0, svh[MAXOBS * 2];
     prcopt_t *opt = &rtk->opt;
     double tt = timediff(time, obs[0].time), ttb, *p, *q;
     register int i, j, k, nf = NF(opt);
@@ -2399,7 +2404,7 @@ static void holdamb(rtk_t *rtk, insstate_t *ins, const double *xa, const ddsat_t
                 x[i] = 0.0;
         }
         /* update states with constraints */
-        if ((info = filter(x, P, H, v, R, nx, nv)))
+        if ((info = filter_ws(&rtk->ws, x, P, H, v, R, nx, nv)))
         {
             errmsg(rtk, "filter error (info=%d)\n", info);
         }
@@ -2514,7 +2519,7 @@ static int resamb_WL(rtk_t *rtk, double *Qy, double *y, int ny, int *index, cons
         wl[na + i] = y[na + index[2 * i]] - y[na + index[2 * i + 1]];
     }
     /* lambda/mlambda integer least-square estimation */
-    if (!lambda(nw, 2, wl + na, Qw, b, s))
+    if (!lambda_init(&rtk->lam, nw, wl + na, Qw) && !lambda_solve(&rtk->lam, 2, b, s))
     {
 
         trace(4, "WL-N(1)=\n");
@@ -2553,7 +2558,7 @@ static int resamb_WL(rtk_t *rtk, double *Qy, double *y, int ny, int *index, cons
                     R[i + i * k] = r[i];
 
                 /* filter for constraint */
-                if (filter(y, Qy, H, v, R, ny, k))
+                if (filter_ws(&rtk->ws, y, Qy, H, v, R, ny, k))
                 {
                     trace(2, "filter error\n");
                     info = 0;
@@ -2644,6 +2649,88 @@ static int inheritamb(rtk_t *rtk, ddsat_t *ddsat, const double *y, const double
 #endif
     return 0;
 }
+/* integer ambiguity estimation with partial ambiguity resolution --------------
+ * if ratio-test fails, exclude ambiguity of the lowest elevation satellite one
+ * at a time and retry up to armaxiter. LD factors of Qb are downdated instead
+ * of refactorized. ddsat, y, Qb and Qab are compacted to the fixed subset.
+ *-----------------------------------------------------------------------------*/
+static int parlambda(rtk_t *rtk, ddsat_t *ddsat, double *y, int na, int *nb, double *Qb, double *Qab, double *b,
+                     double *s)
+{
+    lambda_t *lam = &rtk->lam;
+    double *b0, s0[2], el, elmin;
+    int i, j, k, n = *nb, m, iter, info, fix = 0, *ix;
+
+    if ((info = lambda_init(lam, n, y + na, Qb)) || (info = lambda_solve(lam, 2, b, s)) ||
+        rtk->opt.armaxiter <= 1 || s[0] <= 0.0 || s[1] / s[0] >= rtk->opt.thresar[0])
+    {
+        return info;
+    }
+    b0 = mat(n, 2);
+    ix = imat(n, 1);
+    matcpy(b0, b, n, 2);
+    s0[0] = s[0];
+    s0[1] = s[1];
+    for (i = 0; i < n; i++)
+        ix[i] = i;
+
+    for (iter = 1; iter < rtk->opt.armaxiter && lam->n > MINAMB_PAR && !fix; iter++)
+    {
+        /* exclude ambiguity of the lowest elevation satellite */
+        for (i = 0, k = -1, elmin = PI; i < lam->n; i++)
+        {
+            if ((el = rtk->ssat[ddsat[ix[i]].sat2 - 1].azel[1]) < elmin)
+            {
+                elmin = el;
+                k = i;
+            }
+        }
+        if (k < 0 || lambda_drop(lam, k))
+            break;
+        for (i = k; i < lam->n; i++)
+            ix[i] = ix[i + 1];
+
+        if (lambda_solve(lam, 2, b, s))
+            break;
+
+        fix = s[0] <= 0.0 || s[1] / s[0] >= rtk->opt.thresar[0];
+
+        trace(3, "parlambda: iter=%d nb=%d ratio=%.2f\n", iter, lam->n, s[0] > 0.0 ? s[1] / s[0] : 0.0);
+    }
+    if (fix)
+    {
+        /* no fix flags of excluded ambiguities */
+        for (i = j = 0; i < n; i++)
+        {
+            if (j < lam->n && ix[j] == i)
+                j++;
+            else
+                rtk->ssat[ddsat[i].sat2 - 1].fix[ddsat[i].f] = 1;
+        }
+        /* compact to fixed subset (in place, ix is ascending) */
+        m = lam->n;
+        for (j = 0; j < m; j++)
+        {
+            for (i = 0; i < m; i++)
+                Qb[i + j * m] = Qb[ix[i] + ix[j] * n];
+            for (i = 0; i < na; i++)
+                Qab[i + j * na] = Qab[i + ix[j] * na];
+            ddsat[j] = ddsat[ix[j]];
+            y[na + j] = y[na + ix[j]];
+        }
+        *nb = m;
+    }
+    else
+    {
+        /* restore solutions of all ambiguities */
+        matcpy(b, b0, n, 2);
+        s[0] = s0[0];
+        s[1] = s0[1];
+    }
+    free(b0);
+    free(ix);
+    return 0;
+}
 /* resolve integer ambiguity by LAMBDA --------------------------------------*/
 static int resamb_LAMBDA(rtk_t *rtk, double *bias, double *xa, ddsat_t *ddsat, int *namb, const int *vflg, int nv)
 {
@@ -2740,8 +2827,8 @@ static int resamb_LAMBDA(rtk_t *rtk, double *bias, double *xa, ddsat_t *ddsat, i
     trace(4, "N(0)=");
     tracemat(4, y + na, 1, nb, 10, 3);
 
-    /* lambda/mlambda integer least-square estimation */
-    if (!(info = lambda(nb, 2, y + na, Qb, b, s)))
+    /* lambda/mlambda integer least-square estimation with partial ar */
+    if (!(info = parlambda(rtk, ddsat, y, na, &nb, Qb, Qab, b, s)))
     {
 
         trace(4, "N(1)=");
@@ -2977,8 +3064,8 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr, const nav_t *na
     insstate_t *ins = &rtk->ins;
     gtime_t time = obs[0].time;
     ddsat_t ddsat[MAXSAT] = {{0}};
-    static insstate_t insp = {0};
-    static int refsat[NUMSYS][2 * NFREQ] = {0};
+    static thread_local insstate_t insp = {0};
+    static thread_local int refsat[NUMSYS][2 * NFREQ] = {0};
     double *Ri, *Rj, dr[3] = {0};
     double *rs, *dts, *var, *y, *e, *azel;
     double *v, *H, *R, *xp, *Pp, *xa, *bias, dt, *x, *P, rr[3], *Pa, *dx;
@@ -3110,7 +3197,7 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr, const nav_t *na
         /* kalman filter measurement update */
         matcpy(Pp, P, nx, nx);
 
-        if ((info = filter(xp, Pp, H, v, R, nx, nv)))
+        if ((info = filter_seq(&rtk->ws, xp, Pp, H, v, R, nx, nv)))
         {
             errmsg(rtk, "filter error (info=%d)\n", info);
             stat = SOLQ_NONE;
@@ -3282,7 +3369,7 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr, const nav_t *na
             }
         }
         /* kalman filter */
-        if ((info = filter(x, P, H, v, R, nx, nv)))
+        if ((info = filter_ws(&rtk->ws, x, P, H, v, R, nx, nv)))
         {
             errmsg(rtk, "filter error (info=%d)\n", info);
             stat = SOLQ_NONE;
@@ -3477,6 +3564,8 @@ extern void rtkinit(rtk_t *rtk, const prcopt_t *opt)
     rtk->P = zeros(rtk->nx, rtk->nx);
     rtk->xa = zeros(rtk->na, 1);
     rtk->Pa = zeros(rtk->na, rtk->na);
+    initfiltws(&rtk->ws, 0, 0);
+    memset(&rtk->lam, 0, sizeof(lambda_t));
     rtk->nfix = rtk->neb = 0;
     for (i = 0; i < MAXSAT; i++)
     {
@@ -3535,6 +3624,7 @@ extern void rtkinit(rtk_t *rtk, const prcopt_t *opt)
         rtk->ins.P = NULL;
         rtk->ins.Pa = NULL;
         rtk->ins.Pb = NULL;
+        initfiltws(&rtk->ins.ws, 0, 0);
     }
     if (opt->mode == PMODE_VO)
     {
@@ -3563,6 +3653,8 @@ extern void rtkfree(rtk_t *rtk)
     if (rtk->Pa)
         free(rtk->Pa);
     rtk->Pa = NULL;
+    freefiltws(&rtk->ws);
+    lambda_free(&rtk->lam);
 
     if (rtk->ins.x)
         free(rtk->ins.x);
@@ -3586,6 +3678,7 @@ extern void rtkfree(rtk_t *rtk)
     if (rtk->ins.gmeas.data)
         free(rtk->ins.gmeas.data);
     rtk->ins.gmeas.data = NULL;
+    freefiltws(&rtk->ins.ws);
     rtk->ins.nx = rtk->ins.nb = 0;
     rtk->ins.gmeas.n = rtk->ins.gmeas.nmax = 0;
 
@@ -3658,7 +3751,7 @@ extern int rtkpos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
     insopt_t *insopt = &opt->insopt;
     sol_t solb = {{0}};
     gtime_t time;
-    static obsd_t obsd[MAXOBS];
+    static thread_local obsd_t obsd[MAXOBS];
     int fi = 0, fj = 1, fk = 2;
     int i, j, nu, nr, stat = 0, tcs = 0, tcp = 0;
     char msg[128] = "";
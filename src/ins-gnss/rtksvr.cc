@@ -35,6 +35,13 @@
  *           2016/10/04  1.19 fix problem to send nmea of single solution
  *           2016/10/09  1.20 add reset-and-single-sol mode for nmea-request
  *           2017/04/11  1.21 add rtkfree() in rtksvrfree()
+ *           2026/10/16  1.22 read input streams by per-stream reader threads
+ *                            time alignment by time-ordered event queue
+ *                            wait input stream data by strwait()
+ *                            decode input data in place in reader queue
+ *                            update ephemeris index with navigation data
+ *                            set interpolation interval of broadcast orbit
+ *           2026/10/17  1.23 drain event queue by latest time of each stream
  *----------------------------------------------------------------------------*/
 #include <navlib.h>
 
@@ -44,10 +51,29 @@
 #define REALTIME 0          /* real time process rover observation data */
 #define MAXTIMEDIFF 0.5     /* max time difference for suspend input stream */
 #define OUTSOLFRQ 50        /* frequency of output ins solutions */
+#define RDRCYCLE 1          /* poll cycle of input stream reader if no data (ms) */
+#define RDRWAIT 100         /* max wait time of input stream reader for input (ms) */
+#define NRDRQUE 4           /* size of input stream queue (x input buffer size) */
+#define EVTQLAG 0.5         /* lag of time-ordered event queue for time alignment (s) */
+
+#define EVT_ROVER 0 /* event type: rover observation */
+#define EVT_BASE 1  /* event type: base observation */
+#define EVT_IMU 2   /* event type: imu measurement */
+#define EVT_PVT 3   /* event type: pvt solution */
+#define EVT_IMG 4   /* event type: image raw data */
+#define EVT_POSE 5  /* event type: pose measurement */
 
 #define NS(i, j, max) ((((j) - 1) % (max) - (i)) < 0 ? (((j) - 1) % (max) - (i) + (max)) : (((j) - 1) % (max) - (i)))
 #define NE(i, j, max) MAX(0, (((i) - (j)) < 0 ? ((i) - (j) + (max)) : ((i) - (j))))
 
+#ifdef WIN32 /* msvc volatile has acquire/release semantics */
+#define LOADACQ(p) (*(volatile unsigned int *)(p))
+#define STOREREL(p, v) (*(volatile unsigned int *)(p) = (v))
+#else
+#define LOADACQ(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define STOREREL(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#endif
+
 /* constants/global variables ------------------------------------------------*/
 struct obs
 {
@@ -208,6 +234,7 @@ static void updatenav(nav_t *nav)
         {
             nav->lam[i][j] = satwavelen(i + 1, j, nav);
         }
+    indexnav(nav);
 }
 /* update glonass frequency channel number in raw data struct ----------------*/
 static void updatefcn(rtksvr_t *svr)
@@ -713,7 +740,7 @@ static int inputobstc(rtksvr_t *svr, gtime_t time, obsd_t *obs)
 /* input imu measurement data------------------------------------------------*/
 static int inputimu(rtksvr_t *svr, imud_t *data)
 {
-    int i, j, k, n = 0;
+    int k, n;
 
     tracet(3, "inputimu:\n");
 
@@ -723,17 +750,13 @@ static int inputimu(rtksvr_t *svr, imud_t *data)
         trace(2, "check time alignment fail\n");
         return 0;
     }
-    for (i = 0, k = 0, n = NS(svr->syn.imu, svr->syn.ni, MAXIMUBUF), j = svr->syn.imu; i < n + 1; i++)
-    {
-        j = svr->syn.imu + i;
-        if (j >= MAXIMUBUF)
-            j = j % MAXIMUBUF;
-        if (k < MAXIMU)
-            data[k++] = svr->imu[j];
-        else
-            break;
-    }
-    svr->syn.imu = (j + 1) % MAXIMUBUF;
+    /* copy ring buffer in at most two contiguous blocks */
+    k = MIN(NS(svr->syn.imu, svr->syn.ni, MAXIMUBUF) + 1, MAXIMU);
+    n = MIN(k, MAXIMUBUF - svr->syn.imu);
+    memcpy(data, svr->imu + svr->syn.imu, sizeof(imud_t) * n);
+    if (k > n)
+        memcpy(data + n, svr->imu, sizeof(imud_t) * (k - n));
+    svr->syn.imu = (svr->syn.imu + k) % MAXIMUBUF;
     return k;
 }
 /* input pvt solution data----------------------------------------------------*/
@@ -844,6 +867,156 @@ static int inputpose(rtksvr_t *svr, gtime_t time, pose_meas_t *pose)
     }
     return 0;
 }
+/* initialize/free single-producer/single-consumer queue --------------------*/
+static int initque(spscq_t *q, int size)
+{
+    for (q->size = 1; q->size < size; q->size <<= 1)
+        ;
+    q->head = q->tail = 0;
+    if (!(q->buff = (unsigned char *)malloc(q->size)))
+    {
+        q->size = 0;
+        return 0;
+    }
+    return 1;
+}
+static void freeque(spscq_t *q)
+{
+    if (q->buff)
+        free(q->buff);
+    q->buff = NULL;
+    q->size = 0;
+    q->head = q->tail = 0;
+}
+/* contiguous free space of queue (producer) ----------------------------------*/
+static unsigned char *quewbuf(spscq_t *q, int *n)
+{
+    unsigned int head = q->head, tail = LOADACQ(&q->tail);
+    int i = (int)(head & (q->size - 1));
+
+    *n = MIN(q->size - (int)(head - tail), q->size - i);
+    return q->buff + i;
+}
+/* push data written to free space of queue (producer) -----------------------*/
+static void quepush(spscq_t *q, int n)
+{
+    STOREREL(&q->head, q->head + n);
+}
+/* data length in queue (consumer) --------------------------------------------*/
+static int queused(spscq_t *q)
+{
+    return (int)(LOADACQ(&q->head) - q->tail);
+}
+/* byte at offset from head of data in queue (consumer) ----------------------*/
+static unsigned char quebyte(const spscq_t *q, int off)
+{
+    return q->buff[(q->tail + off) & (q->size - 1)];
+}
+/* copy data from queue without removing (consumer) --------------------------*/
+static int quepeek(spscq_t *q, int off, unsigned char *buff, int n)
+{
+    int i, m, k = MIN(n, queused(q) - off);
+
+    if (k <= 0)
+        return 0;
+    i = (int)((q->tail + off) & (q->size - 1));
+    m = MIN(k, q->size - i);
+    memcpy(buff, q->buff + i, m);
+    memcpy(buff + m, q->buff, k - m);
+    return k;
+}
+/* remove data from queue (consumer) -----------------------------------------*/
+static void queskip(spscq_t *q, int n)
+{
+    STOREREL(&q->tail, q->tail + n);
+}
+/* pop data from queue (consumer) ---------------------------------------------*/
+static int quepop(spscq_t *q, unsigned char *buff, int n)
+{
+    int k = quepeek(q, 0, buff, n);
+
+    queskip(q, k);
+    return k;
+}
+/* compare event time in time direction ------------------------------------*/
+static int evtcmp(const evtq_t *q, const evt_t *e1, const evt_t *e2)
+{
+    return q->dir * timediff(e1->time, e2->time) < 0.0;
+}
+/* pop oldest event from time-ordered event queue ----------------------------*/
+static int evtpop(evtq_t *q, evt_t *evt)
+{
+    evt_t tmp;
+    int i, j;
+
+    if (q->n <= 0)
+        return 0;
+    *evt = q->data[0];
+    q->data[0] = q->data[--q->n];
+
+    for (i = 0; (j = 2 * i + 1) < q->n; i = j)
+    {
+        if (j + 1 < q->n && evtcmp(q, q->data + j + 1, q->data + j))
+            j++;
+        if (!evtcmp(q, q->data + j, q->data + i))
+            break;
+        tmp = q->data[i];
+        q->data[i] = q->data[j];
+        q->data[j] = tmp;
+    }
+    return 1;
+}
+/* push event into time-ordered event queue ----------------------------------*/
+static void evtpush(evtq_t *q, gtime_t time, int type, int index)
+{
+    evt_t tmp;
+    int i, j;
+
+    if (!q->data || time.time == 0)
+        return;
+
+    /* drop oldest event if queue full */
+    if (q->n >= q->nmax)
+    {
+        trace(2, "event queue overflow: type=%d\n", q->data[0].type);
+        evtpop(q, &tmp);
+    }
+    if (!q->tlast[type].time || q->dir * timediff(time, q->tlast[type]) > 0.0)
+        q->tlast[type] = time;
+
+    i = q->n++;
+    q->data[i].time = time;
+    q->data[i].type = type;
+    q->data[i].index = index;
+
+    for (; i > 0 && evtcmp(q, q->data + i, q->data + (j = (i - 1) / 2)); i = j)
+    {
+        tmp = q->data[i];
+        q->data[i] = q->data[j];
+        q->data[j] = tmp;
+    }
+}
+/* check time alignment of measurement data done -----------------------------*/
+static int aligned(const rtksvr_t *svr)
+{
+    const syn_t *syn = &svr->syn;
+
+    if (svr->rtk.opt.mode <= PMODE_FIXED)
+        return syn->tali[0];
+
+    if (svr->rtk.opt.mode == PMODE_INS_LGNSS)
+    {
+        if (svr->rtk.opt.insopt.lcopt == IGCOM_USEOBS)
+            return syn->tali[2] == 2;
+        if (svr->rtk.opt.insopt.lcopt == IGCOM_USESOL)
+            return syn->tali[1];
+    }
+    if (svr->rtk.opt.mode == PMODE_INS_TGNSS)
+        return syn->tali[2] == 2;
+    if (svr->rtk.opt.mode == PMODE_INS_LVO)
+        return syn->tali[3];
+    return 1;
+}
 /* decode receiver raw/rtcm data ---------------------------------------------*/
 static int decoderaw(rtksvr_t *svr, int index)
 {
@@ -854,11 +1027,21 @@ static int decoderaw(rtksvr_t *svr, int index)
     img_t *img = NULL;
     pose_meas_t *pose = NULL;
     sbsmsg_t *sbsmsg = NULL;
-    int i, j, ret = 0, sat, k = 0, fobs = 0;
+    spscq_t *que = &svr->rdr[index].que;
+    unsigned char data;
+    int i, j, ret = 0, sat, k = 0, fobs = 0, evt, dire = svr->raw[index].dire == 1;
 
     tracet(4, "decoderaw: index=%d\n", index);
 
     rtksvrlock(svr);
+    evt = !aligned(svr);
+
+    /* save peek buffer */
+    if (!dire)
+    {
+        svr->npb[index] += quepeek(que, 0, svr->pbuf[index] + svr->npb[index],
+                                   MIN(svr->nb[index], svr->buffsize - svr->npb[index]));
+    }
     switch (index)
     {
     case 0:
@@ -888,25 +1071,27 @@ static int decoderaw(rtksvr_t *svr, int index)
     }
     for (i = 0; i < svr->nb[index]; i++)
     {
+        /* receiver raw/rtcm data in place in stream reader queue */
+        data = dire ? svr->buff[index][i] : quebyte(que, i);
 
         /* input rtcm/receiver raw data from stream */
         if (svr->format[index] == STRFMT_RTCM2)
         {
-            ret = input_rtcm2(svr->rtcm + index, svr->buff[index][i]);
+            ret = input_rtcm2(svr->rtcm + index, data);
             obs = &svr->rtcm[index].obs;
             nav = &svr->rtcm[index].nav;
             sat = svr->rtcm[index].ephsat;
         }
         else if (svr->format[index] == STRFMT_RTCM3)
         {
-            ret = input_rtcm3(svr->rtcm + index, svr->buff[index][i]);
+            ret = input_rtcm3(svr->rtcm + index, data);
             obs = &svr->rtcm[index].obs;
             nav = &svr->rtcm[index].nav;
             sat = svr->rtcm[index].ephsat;
         }
         else
         {
-            ret = input_raw(svr->raw + index, svr->format[index], svr->buff[index][i]);
+            ret = input_raw(svr->raw + index, svr->format[index], data);
             obs = &svr->raw[index].obs;
             imu = &svr->raw[index].imut;
             nav = &svr->raw[index].nav;
@@ -924,6 +1109,8 @@ static int decoderaw(rtksvr_t *svr, int index)
         /* update observation data */
         if (ret == 1 && obs->n)
         {
+            if (evt && index < 2)
+                evtpush(&svr->evtq, obs->data[0].time, index, fobs % MAXOBSBUF);
             updateobs(svr, obs, index, fobs++ % MAXOBSBUF);
             if (k < MAXOBSBUF)
                 k++;
@@ -950,7 +1137,10 @@ static int decoderaw(rtksvr_t *svr, int index)
             for (j = 0; j < imu->n; j++)
             {
                 adjustimu(&svr->rtk.opt, &imu->data[j]);
-                updateimu(svr, &imu->data[j], fobs++ % MAXIMUBUF);
+                updateimu(svr, &imu->data[j], fobs % MAXIMUBUF);
+                if (evt)
+                    evtpush(&svr->evtq, svr->imu[fobs % MAXIMUBUF].time, EVT_IMU, fobs % MAXIMUBUF);
+                fobs++;
                 if (k < MAXIMUBUF)
                     k++;
                 else
@@ -967,7 +1157,10 @@ static int decoderaw(rtksvr_t *svr, int index)
         /* update GPS solutions for ins/gnss coupled */
         if (ret == 6 && svr->format[index] != STRFMT_RTCM2 && svr->format[index] != STRFMT_RTCM3)
         {
-            updatepvt(svr, sol, fobs++ % MAXSOLBUF);
+            updatepvt(svr, sol, fobs % MAXSOLBUF);
+            if (evt && timediff(svr->pvt[fobs % MAXSOLBUF].time, sol->time) == 0.0)
+                evtpush(&svr->evtq, sol->time, EVT_PVT, fobs % MAXSOLBUF);
+            fobs++;
             if (k < MAXSOLBUF)
                 k++;
             else
@@ -992,7 +1185,10 @@ static int decoderaw(rtksvr_t *svr, int index)
         /* update image raw data */
         if (ret == 11)
         {
-            updateimg(svr, img, fobs++ % MAXIMGBUF);
+            updateimg(svr, img, fobs % MAXIMGBUF);
+            if (evt && timediff(svr->img[fobs % MAXIMGBUF].time, img->time) == 0.0)
+                evtpush(&svr->evtq, img->time, EVT_IMG, fobs % MAXIMGBUF);
+            fobs++;
             if (fobs >= MAXIMGBUF)
                 svr->syn.of[4] = fobs / MAXIMGBUF;
         }
@@ -1018,7 +1214,10 @@ static int decoderaw(rtksvr_t *svr, int index)
         /* update pose measurement */
         if (ret == 34)
         {
-            updatepose(svr, pose, fobs++ % MAXPOSEBUF);
+            updatepose(svr, pose, fobs % MAXPOSEBUF);
+            if (evt && timediff(svr->pose[fobs % MAXPOSEBUF].time, pose->time) == 0.0)
+                evtpush(&svr->evtq, pose->time, EVT_POSE, fobs % MAXPOSEBUF);
+            fobs++;
             if (fobs >= MAXPOSEBUF)
             {
                 svr->syn.of[5] = fobs / MAXPOSEBUF;
@@ -1086,6 +1285,8 @@ static int decoderaw(rtksvr_t *svr, int index)
         k = MIN(NE(fobs % MAXPOSEBUF, svr->syn.pose, MAXPOSEBUF), MAXPOSE);
         break;
     }
+    if (!dire)
+        queskip(que, svr->nb[index]);
     svr->nb[index] = 0;
     rtksvrunlock(svr);
     return k;
@@ -1498,187 +1699,164 @@ static int suspend(rtksvr_t *svr, int index)
     }
     return 0;
 }
+/* time difference of last events of two types -------------------------------*/
+static double evtdt(const evtq_t *q, int type1, int type2)
+{
+    if (!q->last[type1].time.time || !q->last[type2].time.time)
+        return 1E9;
+    return fabs(timediff(q->last[type1].time, q->last[type2].time));
+}
 /* time alignment for rover and base observation data------------------------*/
-static int rbobsalign(rtksvr_t *svr)
+static int rbobsalign(rtksvr_t *svr, const evt_t *evt)
 {
-    int i, j;
-    obs_t *p1 = NULL, *p2 = NULL;
+    evtq_t *q = &svr->evtq;
     syn_t *psyn = &svr->syn;
-    gtime_t t0, t1;
-
-    for (i = 0; i < (psyn->of[0] ? MAXOBSBUF : psyn->nr) && !svr->syn.tali[0]; i++)
-    {
-
-        /* for base observation data */
-        for (j = 0; j < (psyn->of[1] ? MAXOBSBUF : psyn->nb); j++)
-        {
-            p1 = &svr->obs[0][i];
-            p2 = &svr->obs[1][j];
 
-            if (!p1->n && !p2->n)
-                continue;
-            t0 = p1->data[0].time;
-            t1 = p2->data[0].time;
+    if (evt->type != EVT_ROVER && evt->type != EVT_BASE)
+        return 0;
+    if (evtdt(q, EVT_ROVER, EVT_BASE) > DTTOLM)
+        return 0;
 
-            if (fabs(timediff(t0, t1)) > DTTOLM)
-                continue;
-            trace(3, "rover and base observation time align ok\n");
-            psyn->rover = i;
-            psyn->base = j;
-            psyn->tali[0] = 1;
-            return 1;
-        }
-        /* align ok */
-        if (psyn->tali[0])
-            break;
-    }
-    return 0;
+    trace(3, "rover and base observation time align ok\n");
+    psyn->rover = q->last[EVT_ROVER].index;
+    psyn->base = q->last[EVT_BASE].index;
+    psyn->tali[0] = 1;
+    return 1;
 }
 /* time alignment for solution and imu data----------------------------------*/
-static int solimualign(rtksvr_t *svr)
+static int solimualign(rtksvr_t *svr, const evt_t *evt)
 {
-    int i, j;
-    double sow1, sow2;
+    evtq_t *q = &svr->evtq;
     syn_t *syn = &svr->syn;
 
-    for (i = 0; i < (syn->of[2] ? MAXIMUBUF : syn->ni) && !syn->tali[1]; i++)
-    {
-        sow1 = time2gpst(svr->imu[i].time, NULL);
-
-        /* for pvt solution data */
-        for (j = 0; j < (syn->of[3] ? MAXSOLBUF : syn->ns); j++)
-        {
-
-            sow2 = time2gpst(svr->pvt[j].time, &svr->week);
-            if (sow1 == 0.0 || sow2 == 0.0 || fabs(sow1 - sow2) > DTTOL)
-                continue;
+    if (evt->type != EVT_IMU && evt->type != EVT_PVT)
+        return 0;
+    if (evtdt(q, EVT_IMU, EVT_PVT) > DTTOL)
+        return 0;
 
-            trace(3, "imu and pvt solution time align ok\n");
-            syn->imu = i;
-            syn->pvt = j;
-            syn->tali[1] = 1;
-            return 1;
-        }
-        /* alignment ok */
-        if (syn->tali[1])
-            break;
-    }
-    return 0;
+    trace(3, "imu and pvt solution time align ok\n");
+    time2gpst(q->last[EVT_PVT].time, &svr->week);
+    syn->imu = q->last[EVT_IMU].index;
+    syn->pvt = q->last[EVT_PVT].index;
+    syn->tali[1] = 1;
+    return 1;
 }
 /* time alignment for observation and imu data-------------------------------*/
-static int imuobsalign(rtksvr_t *svr)
+static int imuobsalign(rtksvr_t *svr, const evt_t *evt)
 {
-    int i, j, k, n;
-    double sow1, sow2, sow3;
-    obs_t *p1 = NULL, *p2 = NULL;
+    evtq_t *q = &svr->evtq;
     syn_t *psyn = &svr->syn;
 
-    /* observation and imu data time alignment */
-    n = psyn->of[2] ? MAXIMUBUF : psyn->ni;
-    p1 = svr->obs[0];
-    p2 = svr->obs[1];
-
-    for (i = 0; i < n && svr->syn.tali[2] != 2; i++)
-    { /* start time alignment */
+    if (evt->type != EVT_IMU && evt->type != EVT_ROVER && evt->type != EVT_BASE)
+        return 0;
+    if (evtdt(q, EVT_IMU, EVT_ROVER) > DTTOL || evtdt(q, EVT_ROVER, EVT_BASE) > DTTOLM)
+        return 0;
 
-        sow1 = time2gpst(svr->imu[i].time, NULL);
+    tracet(3, "imu and rover/base align ok\n");
+    psyn->imu = q->last[EVT_IMU].index;
+    psyn->rover = q->last[EVT_ROVER].index;
+    psyn->base = q->last[EVT_BASE].index;
+    psyn->tali[2] = 2;
+    return 1;
+}
+/* time alignment for imu and image measurement data-------------------------*/
+static int imuimgalign(rtksvr_t *svr, const evt_t *evt)
+{
+    evtq_t *q = &svr->evtq;
+    syn_t *psyn = &svr->syn;
+    const img_t *img;
 
-        /* match rover observation */
-        for (j = 0; j < (psyn->of[0] ? MAXOBSBUF : psyn->nr); j++)
-        {
-            sow2 = time2gpst(p1[j].data[0].time, NULL);
-            if (p1[j].n)
-            {
-                if (fabs(sow1 - sow2) > DTTOL)
-                    continue;
-            }
-            psyn->imu = i;
-            psyn->rover = j;
-            psyn->tali[2] = 1;
-            break;
-        }
-        /* match base observation */
-        if (psyn->tali[2] == 1)
-        {
-            for (k = 0; k < (psyn->of[1] ? MAXOBSBUF : psyn->nb); k++)
-            {
-                sow3 = time2gpst(p2[k].data[0].time, NULL);
-                if (p2[k].n)
-                {
-                    if (fabs(sow2 - sow3) > DTTOLM)
-                        continue;
-                }
-                else
-                    continue;
-                psyn->base = k;
-                psyn->tali[2] = 2;
-                break;
-            }
-        }
-        if (psyn->tali[2] == 2)
+    if (evt->type == EVT_IMG)
+    {
+        img = svr->img + evt->index;
+        if (img->flag || img->h == 0 || img->w == 0)
         {
-            tracet(3, "imu and rover/base align ok\n");
-            return 1;
+            q->last[EVT_IMG].time.time = 0;
+            return 0;
         }
-        else
-            psyn->tali[2] = 0; /* fail */
     }
+    else if (evt->type != EVT_IMU)
+        return 0;
+    if (evtdt(q, EVT_IMU, EVT_IMG) > DTTOL)
+        return 0;
+
+    tracet(3, "imu and image align ok\n");
+    psyn->imu = q->last[EVT_IMU].index;
+    psyn->img = q->last[EVT_IMG].index;
+    psyn->tali[3] = 1;
+    return 1;
+}
+/* event streams used for time alignment by processing mode ------------------*/
+static int evtstreams(const prcopt_t *opt)
+{
+    if (opt->mode <= PMODE_FIXED)
+        return (1 << EVT_ROVER) | (1 << EVT_BASE);
+    if (opt->mode == PMODE_INS_LGNSS && opt->insopt.lcopt == IGCOM_USESOL)
+        return (1 << EVT_IMU) | (1 << EVT_PVT);
+    if (opt->mode == PMODE_INS_LGNSS || opt->mode == PMODE_INS_TGNSS)
+        return (1 << EVT_IMU) | (1 << EVT_ROVER) | (1 << EVT_BASE);
+    if (opt->mode == PMODE_INS_LVO)
+        return (1 << EVT_IMU) | (1 << EVT_IMG);
     return 0;
 }
-/* time alignment for imu and image measurement data-------------------------*/
-static int imuimgalign(rtksvr_t *svr)
+/* drain horizon of event queue ------------------------------------------------
+ * the horizon is the latest time of the slowest active stream, streams with no
+ * event yet are excluded so that a missing stream does not stop alignment
+ *----------------------------------------------------------------------------*/
+static int evthorizon(const evtq_t *q, int streams, gtime_t *t)
 {
-    int i, j;
-    double sow1, sow2;
-    syn_t *psyn = &svr->syn;
+    int i, n = 0;
 
-    /* alignment of imu and image measurement data */
-    for (i = 0; i < (psyn->of[2] ? MAXIMUBUF : psyn->ni) && svr->syn.tali[3] != 1; i++)
+    for (i = 0; i < 6; i++)
     {
-        sow1 = time2gpst(svr->imu[i].time, NULL);
-
-        /* match image measurement data */
-        for (j = 0; j < (psyn->of[4] ? MAXIMGBUF : psyn->nm); j++)
-        {
-            sow2 = time2gpst(svr->img[j].time, NULL);
-            if (svr->img[j].flag || svr->img[j].h == 0 || svr->img[j].w == 0)
-                continue;
-            if (fabs(sow1 - sow2) > DTTOL)
-                continue;
-
-            psyn->imu = i;
-            psyn->img = j;
-            psyn->tali[3] = 1;
-            break;
-        }
-        if (psyn->tali[3] == 1)
-        {
-            tracet(3, "imu and image align ok\n");
-            return 1;
-        }
-        else
-            psyn->tali[3] = 0; /* fail */
+        if (!(streams & (1 << i)) || !q->tlast[i].time)
+            continue;
+        if (n++ == 0 || q->dir * timediff(q->tlast[i], *t) < 0.0)
+            *t = q->tlast[i];
     }
-    return 0; /* fail */
+    return n;
 }
-/* time alignment for measurement data---------------------------------------*/
+/* time alignment for measurement data---------------------------------------
+ * an event is drained from the time-ordered event queue only when it is older
+ * by EVTQLAG than the latest time of every active stream, so late streams
+ * (e.g. base observations via ntrip) are still aligned. each drained event is
+ * matched against the latest drained events of the other streams, so
+ * alignment costs O(log n) per measurement
+ *---------------------------------------------------------------------------*/
 static int timealign(rtksvr_t *svr)
 {
-    if (svr->rtk.opt.mode <= PMODE_FIXED)
-        return rbobsalign(svr);
+    evtq_t *q = &svr->evtq;
+    evt_t evt;
+    gtime_t th;
+    int stat = 0;
 
-    if (svr->rtk.opt.mode == PMODE_INS_LGNSS)
+    if (aligned(svr))
     {
-        if (svr->rtk.opt.insopt.lcopt == IGCOM_USEOBS)
-            return imuobsalign(svr);
-        if (svr->rtk.opt.insopt.lcopt == IGCOM_USESOL)
-            return solimualign(svr);
+        q->n = 0;
+        return 0;
     }
-    if (svr->rtk.opt.mode == PMODE_INS_TGNSS)
-        return imuobsalign(svr);
-    if (svr->rtk.opt.mode == PMODE_INS_LVO)
-        return imuimgalign(svr);
-    return 0;
+    if (!evthorizon(q, evtstreams(&svr->rtk.opt), &th))
+        return 0;
+
+    while (!stat && q->n > 0 && q->dir * timediff(th, q->data[0].time) >= EVTQLAG)
+    {
+        evtpop(q, &evt);
+        q->last[evt.type] = evt;
+
+        if (svr->rtk.opt.mode <= PMODE_FIXED)
+            stat = rbobsalign(svr, &evt);
+        else if (svr->rtk.opt.mode == PMODE_INS_LGNSS && svr->rtk.opt.insopt.lcopt == IGCOM_USEOBS)
+            stat = imuobsalign(svr, &evt);
+        else if (svr->rtk.opt.mode == PMODE_INS_LGNSS && svr->rtk.opt.insopt.lcopt == IGCOM_USESOL)
+            stat = solimualign(svr, &evt);
+        else if (svr->rtk.opt.mode == PMODE_INS_TGNSS)
+            stat = imuobsalign(svr, &evt);
+        else if (svr->rtk.opt.mode == PMODE_INS_LVO)
+            stat = imuimgalign(svr, &evt);
+    }
+    if (stat)
+        q->n = 0;
+    return stat;
 }
 /* motion constraint for ins states update-----------------------------------*/
 static void motion(const insopt_t *opt, imud_t *imuz, insstate_t *ins, imud_t *imu, int ws)
@@ -1718,6 +1896,145 @@ static void motion(const insopt_t *opt, imud_t *imuz, insstate_t *ins, imud_t *i
             zaru(ins, opt, imuz, 1);
     }
 }
+/* signal input data event to server thread ---------------------------------*/
+static void signalinput(rtksvr_t *svr)
+{
+    lock(&svr->elock);
+    svr->event = 1;
+#ifdef WIN32
+    WakeConditionVariable(&svr->econd);
+#else
+    pthread_cond_signal(&svr->econd);
+#endif
+    unlock(&svr->elock);
+}
+/* wait input data event or timeout (ms) -------------------------------------*/
+static void waitinput(rtksvr_t *svr, int ms)
+{
+#ifndef WIN32
+    struct timespec ts;
+#endif
+    lock(&svr->elock);
+    if (!svr->event && ms > 0)
+    {
+#ifdef WIN32
+        SleepConditionVariableCS(&svr->econd, &svr->elock, ms);
+#else
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += ms / 1000;
+        ts.tv_nsec += (ms % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L)
+        {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&svr->econd, &svr->elock, &ts);
+#endif
+    }
+    svr->event = 0;
+    unlock(&svr->elock);
+}
+/* input stream reader thread -------------------------------------------------
+ * read input stream, write log stream and peek buffer and push the data to the
+ * queue of server thread, so slow streams do not stall the server thread
+ * notes  : socket and serial streams block in strwait() until input ready.
+ *          file, memory buffer and ftp/http streams have no descriptor to
+ *          wait and are polled by strread() every RDRCYCLE ms, as well as
+ *          streams with full queue or backward solution direction
+ *----------------------------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI strrdrthread(void *arg)
+#else
+static void *strrdrthread(void *arg)
+#endif
+{
+    strrdr_t *rdr = (strrdr_t *)arg;
+    rtksvr_t *svr = (rtksvr_t *)rdr->svr;
+    unsigned char *p;
+    int i = rdr->index, n;
+
+    tracet(3, "strrdrthread: index=%d\n", i);
+
+    while (rdr->state)
+    {
+        /* check solution direction and queue full */
+        p = quewbuf(&rdr->que, &n);
+        if (rdr->dire == 1 || n <= 0)
+        {
+            sleepms(RDRCYCLE);
+            continue;
+        }
+        /* read receiver raw/rtcm data from input stream */
+        if ((n = strread(svr->stream + i, p, n)) <= 0)
+        {
+            /* block until input ready if stream can be waited */
+            if (strwait(svr->stream + i, 1, RDRWAIT) < 0)
+                sleepms(RDRCYCLE);
+            continue;
+        }
+        /* write receiver raw/rtcm data to log stream {logr,logb,logc,logi,logs} */
+        if (i < 5)
+            strwrite(svr->stream + i + 9, p, n);
+
+        quepush(&rdr->que, n);
+        signalinput(svr);
+    }
+    tracet(3, "strrdrthread: stop index=%d\n", i);
+    return 0;
+}
+/* start input stream reader -------------------------------------------------*/
+static int startrdr(rtksvr_t *svr, int index)
+{
+    strrdr_t *rdr = svr->rdr + index;
+
+    tracet(3, "startrdr: index=%d\n", index);
+
+    rdr->svr = svr;
+    rdr->index = index;
+    rdr->dire = svr->raw[index].dire;
+    rdr->state = 0;
+
+    if (svr->stream[index].type == STR_NONE)
+        return 1;
+    if (!initque(&rdr->que, svr->buffsize * NRDRQUE))
+    {
+        tracet(1, "startrdr: malloc error\n");
+        return 0;
+    }
+    rdr->state = 1;
+#ifdef WIN32
+    if (!(rdr->thread = CreateThread(NULL, 0, strrdrthread, rdr, 0, NULL)))
+    {
+#else
+    if (pthread_create(&rdr->thread, NULL, strrdrthread, rdr))
+    {
+#endif
+        tracet(1, "startrdr: thread create error index=%d\n", index);
+        rdr->state = 0;
+        freeque(&rdr->que);
+        return 0;
+    }
+    return 1;
+}
+/* stop input stream reader --------------------------------------------------*/
+static void stoprdr(rtksvr_t *svr, int index)
+{
+    strrdr_t *rdr = svr->rdr + index;
+
+    tracet(3, "stoprdr: index=%d\n", index);
+
+    if (rdr->state)
+    {
+        rdr->state = 0;
+#ifdef WIN32
+        WaitForSingleObject(rdr->thread, 10000);
+        CloseHandle(rdr->thread);
+#else
+        pthread_join(rdr->thread, NULL);
+#endif
+    }
+    freeque(&rdr->que);
+}
 /* rtk server thread --------------------------------------------------------*/
 #ifdef WIN32
 static DWORD WINAPI rtksvrthread(void *arg)
@@ -1740,10 +2057,9 @@ static void *rtksvrthread(void *arg)
     static pose_meas_t pose = {0};
     static mag_t mag = {0};
 
-    unsigned int tick, ticknmea, tick1hz, tickreset;
-    unsigned char *p, *q;
+    unsigned int tick, ticknmea, tick1hz, tickreset, tickcmd;
     char msg[128];
-    int i, j = 0, n = 0, ws, fobs[7] = {0}, cycle, cputime, init = 0, flag = 0;
+    int i, j = 0, n = 0, ws, fobs[7] = {0}, cycle = 0, cputime, init = 0, flag = 0;
 
     tracet(3, "rtksvrthread:\n");
 
@@ -1751,6 +2067,7 @@ static void *rtksvrthread(void *arg)
     svr->tick = tickget();
     ticknmea = tick1hz = svr->tick - 1000;
     tickreset = svr->tick - MIN_INT_RESET;
+    tickcmd = svr->tick;
 
     /* static detect window size */
     ws = opt->insopt.zvopt.ws <= 0 ? 5 : opt->insopt.zvopt.ws;
@@ -1764,7 +2081,13 @@ static void *rtksvrthread(void *arg)
         fprintf(stderr, "malloc error\n");
         return NULL;
     }
-    for (cycle = 0; svr->state; cycle++)
+    /* start input stream readers */
+    for (i = 0; i < 7; i++)
+    {
+        if (!startrdr(svr, i))
+            tracet(1, "rtksvrthread: input stream reader start error index=%d\n", i);
+    }
+    while (svr->state)
     {
         tick = tickget();
 
@@ -1775,9 +2098,6 @@ static void *rtksvrthread(void *arg)
 
         for (i = 0; i < 7; i++)
         {
-            p = svr->buff[i] + svr->nb[i];
-            q = svr->buff[i] + svr->buffsize;
-
             /* check suspend input stream */
             if (suspend(svr, i))
                 continue;
@@ -1788,21 +2108,14 @@ static void *rtksvrthread(void *arg)
                 svr->nb[i] = 1;
                 continue;
             }
-            /* read receiver raw/rtcm data from input stream */
-            if ((n = strread(svr->stream + i, p, q - p)) <= 0)
+            /* input download file path from stream reader */
+            if (svr->format[i] == STRFMT_SP3 || svr->format[i] == STRFMT_RNXCLK)
             {
+                svr->nb[i] += quepop(&svr->rdr[i].que, svr->buff[i] + svr->nb[i], svr->buffsize - svr->nb[i]);
                 continue;
             }
-            /* write receiver raw/rtcm data to log stream */
-            strwrite(svr->stream + i + 9, p, n);
-            svr->nb[i] += n;
-
-            /* save peek buffer */
-            rtksvrlock(svr);
-            n = n < svr->buffsize - svr->npb[i] ? n : svr->buffsize - svr->npb[i];
-            memcpy(svr->pbuf[i] + svr->npb[i], p, n);
-            svr->npb[i] += n;
-            rtksvrunlock(svr);
+            /* receiver raw/rtcm data are decoded in place in stream reader queue */
+            svr->nb[i] = queused(&svr->rdr[i].que);
         }
         for (i = 0; i < 7; i++)
         {
@@ -2150,10 +2463,15 @@ static void *rtksvrthread(void *arg)
             writesol(svr, 0);
             tick1hz = tick;
         }
-        /* write periodic command to input stream */
-        for (i = 0; i < 5; i++)
+        /* write periodic command to input stream (every server cycle) */
+        if ((int)(tick - tickcmd) >= svr->cycle)
         {
-            periodic_cmd(cycle * svr->cycle, svr->cmds_periodic[i], svr->stream + i);
+            for (i = 0; i < 5; i++)
+            {
+                periodic_cmd(cycle * svr->cycle, svr->cmds_periodic[i], svr->stream + i);
+            }
+            tickcmd = tick;
+            cycle++;
         }
         /* send nmea request to base/nrtk input stream */
         if (svr->nmeacycle > 0 && (int)(tick - ticknmea) >= svr->nmeacycle)
@@ -2164,9 +2482,11 @@ static void *rtksvrthread(void *arg)
         if ((cputime = (int)(tickget() - tick)) > 0)
             svr->cputime = cputime;
 
-        /* sleep until next cycle */
-        sleepms(svr->cycle - cputime);
+        /* wait input data until next cycle */
+        waitinput(svr, svr->cycle - cputime);
     }
+    for (i = 0; i < 7; i++)
+        stoprdr(svr, i);
     for (i = 0; i < MAXSTRRTK; i++)
         rtksvrclosestr(svr, i);
     for (i = 0; i < 5; i++)
@@ -2290,6 +2610,13 @@ extern int rtksvrinit(rtksvr_t *svr)
                 return 0;
             }
         }
+    memset(&svr->evtq, 0, sizeof(evtq_t));
+    if (!(svr->evtq.data = (evt_t *)malloc(sizeof(evt_t) * MAXEVTQ)))
+    {
+        tracet(1, "rtksvrinit: malloc error\n");
+        return 0;
+    }
+    svr->evtq.nmax = MAXEVTQ;
     for (i = 0; i < 7; i++)
     {
         memset(svr->raw + i, 0, sizeof(raw_t));
@@ -2302,6 +2629,13 @@ extern int rtksvrinit(rtksvr_t *svr)
         *svr->cmds_periodic[i] = '\0';
     *svr->cmd_reset = '\0';
     svr->bl_reset = 10.0;
+    for (i = 0; i < 7; i++)
+    {
+        memset(svr->rdr + i, 0, sizeof(strrdr_t));
+    }
+    svr->event = 0;
+    initlock(&svr->elock);
+    initcond(&svr->econd);
     initlock(&svr->lock);
 
     return 1;
@@ -2315,18 +2649,16 @@ extern void rtksvrfree(rtksvr_t *svr)
 {
     int i, j;
 
-    free(svr->nav.eph);
-    svr->nav.eph = NULL;
-    free(svr->nav.geph);
-    svr->nav.geph = NULL;
-    free(svr->nav.seph);
-    svr->nav.seph = NULL;
+    freenav(&svr->nav, 0x07);
     for (i = 0; i < 3; i++)
         for (j = 0; j < MAXOBSBUF; j++)
         {
             free(svr->obs[i][j].data);
             svr->obs[i][j].data = NULL;
         }
+    free(svr->evtq.data);
+    svr->evtq.data = NULL;
+    svr->evtq.n = svr->evtq.nmax = 0;
     if (svr->rtk.ins.rtkp)
         rtkfree((rtk_t *)svr->rtk.ins.rtkp);
     rtkfree(&svr->rtk);
@@ -2488,6 +2820,7 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs, char *
         }
     }
     updatenav(&svr->nav); /* update navigation data */
+    setorbint(prcopt->orbint);
 
     /* set monitor stream */
     svr->moni = moni;
@@ -2526,6 +2859,11 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs, char *
     {
         svr->raw[i].dire = (unsigned char)svr->rtk.opt.soltype;
     }
+    /* reset time-ordered event queue */
+    svr->evtq.n = 0;
+    svr->evtq.dir = svr->rtk.opt.soltype ? -1 : 1;
+    memset(svr->evtq.last, 0, sizeof(svr->evtq.last));
+    memset(svr->evtq.tlast, 0, sizeof(svr->evtq.tlast));
     /* mono camera image directory */
     for (i = 0; i < 7; i++)
     {
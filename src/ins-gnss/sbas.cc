@@ -33,6 +33,8 @@
  *           2011/01/15 1.8  use api ionppp()
  *                           add prn mask of qzss for qzss L1SAIF
  *           2016/07/29 1.9  crc24q() -> rtk_crc24q()
+ *           2026/10/16 1.10 make cache of sbstropcorr() thread-local
+ *                           update ephemeris index by sbas ephemeris
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
 
@@ -326,6 +328,10 @@ static int decode_sbstype9(const sbsmsg_t *msg, nav_t *nav)
     nav->seph[NSATSBS + i] = nav->seph[i]; /* previous */
     nav->seph[i] = seph;                   /* current */
 
+    /* update ephemeris index if indexed */
+    if (nav->iseph.key)
+        indexnav(nav);
+
     trace(5, "decode_sbstype9: prn=%d\n", msg->prn);
     return 1;
 }
@@ -942,7 +948,7 @@ static void getmet(double lat, double *met)
 extern double sbstropcorr(gtime_t time, const double *pos, const double *azel, double *var)
 {
     const double k1 = 77.604, k2 = 382000.0, rd = 287.054, gm = 9.784, g = 9.80665;
-    static double pos_[3] = {0}, zh = 0.0, zw = 0.0;
+    static thread_local double pos_[3] = {0}, zh = 0.0, zw = 0.0;
     int i;
     double c, met[10], sinel = sin(azel[1]), h = pos[2], m;
 
@@ -56,6 +56,8 @@
  *           2016/09/06 1.23 fix bug on ntrip caster socket and request handling
  *           2016/09/27 1.24 support udp server and client
  *           2016/10/10 1.25 support ::P={4|8} option in path for STR_FILE
+ *           2026/10/16 1.26 add api strwait()
+ *                           copy memory buffer stream by blocks
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
 #include <ctype.h>
@@ -103,17 +105,20 @@
 #define FTP_TIMEOUT 30 /* ftp/http timeout (s) */
 
 #define MIN(x, y) ((x) < (y) ? (x) : (y))
+#define MAXWAITFD (MAXCLI + 1) /* max number of descriptors to wait per stream */
 
 /* macros --------------------------------------------------------------------*/
 
 #ifdef WIN32
 #define dev_t HANDLE
 #define socket_t SOCKET
+#define ERRINTR WSAEINTR
 typedef int socklen_t;
 #else
 #define dev_t int
 #define socket_t int
 #define closesocket close
+#define ERRINTR EINTR
 #endif
 
 /* type definition -----------------------------------------------------------*/
@@ -2738,7 +2743,7 @@ static void closemembuf(membuf_t *membuf)
 /* read memory buffer --------------------------------------------------------*/
 static int readmembuf(membuf_t *membuf, unsigned char *buff, int n, char *msg)
 {
-    int i, nr = 0;
+    int m, nr;
 
     tracet(4, "readmembuf: n=%d\n", n);
 
@@ -2747,20 +2752,22 @@ static int readmembuf(membuf_t *membuf, unsigned char *buff, int n, char *msg)
 
     lock(&membuf->lock);
 
-    for (i = membuf->rp; i != membuf->wp && nr < n; i++)
-    {
-        if (i >= membuf->bufsize)
-            i = 0;
-        buff[nr++] = membuf->buf[i];
-    }
-    membuf->rp = i;
+    /* copy in at most two contiguous blocks */
+    nr = membuf->wp - membuf->rp;
+    if (nr < 0)
+        nr += membuf->bufsize;
+    nr = MIN(nr, n);
+    m = MIN(nr, membuf->bufsize - membuf->rp);
+    memcpy(buff, membuf->buf + membuf->rp, m);
+    memcpy(buff + m, membuf->buf, nr - m);
+    membuf->rp = (membuf->rp + nr) % membuf->bufsize;
     unlock(&membuf->lock);
     return nr;
 }
 /* write memory buffer -------------------------------------------------------*/
 static int writemembuf(membuf_t *membuf, unsigned char *buff, int n, char *msg)
 {
-    int i;
+    int m, nw;
 
     tracet(3, "writemembuf: n=%d\n", n);
 
@@ -2769,21 +2776,23 @@ static int writemembuf(membuf_t *membuf, unsigned char *buff, int n, char *msg)
 
     lock(&membuf->lock);
 
-    for (i = 0; i < n; i++)
+    /* copy in at most two contiguous blocks */
+    nw = membuf->rp - membuf->wp - 1;
+    if (nw < 0)
+        nw += membuf->bufsize;
+    nw = MIN(nw, n);
+    m = MIN(nw, membuf->bufsize - membuf->wp);
+    memcpy(membuf->buf + membuf->wp, buff, m);
+    memcpy(membuf->buf, buff + m, nw - m);
+    membuf->wp = (membuf->wp + nw) % membuf->bufsize;
+
+    if (nw < n)
     {
-        membuf->buf[membuf->wp++] = buff[i];
-        if (membuf->wp >= membuf->bufsize)
-            membuf->wp = 0;
-        if (membuf->wp == membuf->rp)
-        {
-            strcpy(msg, "mem-buffer overflow");
-            membuf->state = -1;
-            unlock(&membuf->lock);
-            return i + 1;
-        }
+        strcpy(msg, "mem-buffer overflow");
+        membuf->state = -1;
     }
     unlock(&membuf->lock);
-    return i;
+    return nw;
 }
 /* get state memory buffer ---------------------------------------------------*/
 static int statemembuf(membuf_t *membuf)
@@ -3112,6 +3121,129 @@ extern void strunlock(stream_t *stream)
 {
     unlock(&stream->lock);
 }
+/* sockets of tcp server to wait input ---------------------------------------*/
+static int waitsock_tcpsvr(tcpsvr_t *tcpsvr, socket_t *sock)
+{
+    int i, n = 0;
+
+    if (tcpsvr->svr.state <= 0)
+        return 0;
+    sock[n++] = tcpsvr->svr.sock;
+    for (i = 0; i < MAXCLI; i++)
+    {
+        if (tcpsvr->cli[i].state == 2)
+            sock[n++] = tcpsvr->cli[i].sock;
+    }
+    return n;
+}
+/* descriptors of stream to wait input ---------------------------------------
+ * return : number of descriptors (-1:stream cannot be waited,MAXWAITFD+1:
+ *          buffered data ready)
+ *---------------------------------------------------------------------------*/
+static int waitsock(stream_t *stream, socket_t *sock)
+{
+    ntrip_t *ntrip;
+    tcpcli_t *tcpcli;
+
+    if (!(stream->mode & STR_MODE_R) || !stream->port)
+        return 0;
+
+    switch (stream->type)
+    {
+#ifndef WIN32
+    case STR_SERIAL:
+        sock[0] = ((serial_t *)stream->port)->dev;
+        return 1;
+#endif
+    case STR_TCPSVR:
+        return waitsock_tcpsvr((tcpsvr_t *)stream->port, sock);
+    case STR_TCPCLI:
+        tcpcli = (tcpcli_t *)stream->port;
+        if (tcpcli->svr.state != 2)
+            return 0;
+        sock[0] = tcpcli->svr.sock;
+        return 1;
+    case STR_NTRIPSVR:
+    case STR_NTRIPCLI:
+        ntrip = (ntrip_t *)stream->port;
+        if (ntrip->state == 2 && ntrip->nb > 0)
+            return MAXWAITFD + 1;
+        if (ntrip->tcp->svr.state != 2)
+            return 0;
+        sock[0] = ntrip->tcp->svr.sock;
+        return 1;
+    case STR_NTRIPC_S:
+    case STR_NTRIPC_C:
+        return waitsock_tcpsvr(((ntripc_t *)stream->port)->tcp, sock);
+    case STR_UDPSVR:
+        sock[0] = ((udp_t *)stream->port)->sock;
+        return 1;
+    }
+    return -1;
+}
+/* wait stream input -----------------------------------------------------------
+ * wait until any of streams has input data or timeout
+ * args   : stream_t *stream I  streams
+ *          int    n         I  number of streams
+ *          int    ms        I  timeout (ms)
+ * return : status (1:input ready,0:timeout,-1:stream cannot be waited)
+ * notes  : file, memory buffer and ftp/http streams (and serial on WIN32)
+ *          have no descriptor to wait. for them return immediately with -1
+ *          and the caller should poll the stream with strread() instead.
+ *          -1 is also returned on wait error. interrupted wait is retried.
+ *          disconnected streams are waited by timeout to retry connection
+ *          in strread().
+ *-----------------------------------------------------------------------------*/
+extern int strwait(stream_t *stream, int n, int ms)
+{
+    struct timeval tv;
+    socket_t sock[MAXWAITFD];
+    fd_set rs, rs0;
+    int i, j, m, nfd = 0, smax = 0, stat;
+
+    tracet(4, "strwait: n=%d ms=%d\n", n, ms);
+
+    FD_ZERO(&rs);
+    for (i = 0; i < n; i++)
+    {
+        strlock(stream + i);
+        m = waitsock(stream + i, sock);
+        strunlock(stream + i);
+
+        if (m < 0)
+            return -1;
+        if (m > MAXWAITFD)
+            return 1;
+        for (j = 0; j < m; j++)
+        {
+            FD_SET(sock[j], &rs);
+            if ((int)sock[j] > smax)
+                smax = (int)sock[j];
+            nfd++;
+        }
+    }
+    if (ms <= 0)
+        ms = 0;
+    if (nfd <= 0)
+    {
+        sleepms(ms);
+        return 0;
+    }
+    tv.tv_sec = ms / 1000;
+    tv.tv_usec = ms % 1000 * 1000;
+    rs0 = rs;
+
+    while ((stat = select(smax + 1, &rs, NULL, NULL, &tv)) < 0 && errsock() == ERRINTR)
+    {
+        rs = rs0; /* descriptor set undefined after error */
+    }
+    if (stat < 0)
+    {
+        tracet(2, "strwait: select error err=%d\n", errsock());
+        return -1;
+    }
+    return stat > 0;
+}
 
 /* read stream -----------------------------------------------------------------
  * read data from stream (unblocked)
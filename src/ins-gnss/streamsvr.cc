@@ -21,6 +21,7 @@
  *                           fix bug on rtcm cyclic output of beidou ephemeris
  *           2016/10/01 1.12 change api startstrserver()
  *           2017/04/11 1.13 fix bug on search of next satellite in nextsat()
+ *           2026/10/16 1.14 wait input stream data by strwait()
  *-----------------------------------------------------------------------------*/
 #include "navlib.h"
 
@@ -574,7 +575,10 @@ static void *strsvrthread(void *arg)
             strsendnmea(svr->stream, &sol_nmea);
             tick_nmea = tick;
         }
-        sleepms(svr->cycle - (int)(tickget() - tick));
+        /* wait input data until next cycle */
+        n = svr->cycle - (int)(tickget() - tick);
+        if (strwait(svr->stream, 1, n) < 0)
+            sleepms(n);
     }
     for (i = 0; i < svr->nstr; i++)
         strclose(svr->stream + i);